@@ -19,12 +19,10 @@ TARGET =  mrhash$${ARCH_SUFFIX}
 
 VPATH += ./src/          \
          ./include/      \
-         ./lib/          \
          ./res/          \
          ./ui/
 
 INCLUDEPATH += ./include/ \
-               ./lib/ \
                ./third_party/boost-array/include/ \
                ./third_party/boost-assert/include/ \
                ./third_party/boost-config/include/ \
@@ -47,7 +45,32 @@ SOURCES += \
            src/crc.cpp                \
            src/fileiconwidget.cpp     \
            src/base64dialog.cpp       \
-           src/filebase64calculator.cpp
+           src/filebase64calculator.cpp \
+           src/algorithms.cpp         \
+           src/digest.cpp             \
+           src/chunkring.cpp          \
+           src/cpufeatures.cpp        \
+           src/sha.cpp                \
+           src/keccak.cpp             \
+           src/tiger.cpp              \
+           src/ripemd160.cpp          \
+           src/md.cpp                 \
+           src/multibuffer.cpp        \
+           src/batchhashcalculator.cpp \
+           src/blake3.cpp             \
+           src/xxh3.cpp               \
+           src/commandline.cpp        \
+           src/checksumfile.cpp       \
+           src/checksumverifier.cpp   \
+           src/batchqueue.cpp         \
+           src/batchdialog.cpp        \
+           src/directorywalker.cpp    \
+           src/taskscheduler.cpp      \
+           src/filemapping.cpp        \
+           src/uringreader.cpp        \
+           src/cachedropper.cpp       \
+           src/fileextents.cpp        \
+           src/disklayout.cpp
 
 
 HEADERS  += \
@@ -62,9 +85,34 @@ HEADERS  += \
             include/crc.hpp                \
             include/fileiconwidget.hpp     \
             include/base64dialog.hpp       \
-            include/filebase64calculator.hpp
-
-FORMS    += mainwindow.ui about.ui fileinfowidget.ui fileiconwidget.ui base64dialog.ui
+            include/filebase64calculator.hpp \
+            include/algorithms.hpp         \
+            include/digest.hpp             \
+            include/chunkring.hpp          \
+            include/cpufeatures.hpp        \
+            include/sha.hpp                \
+            include/keccak.hpp             \
+            include/tiger.hpp              \
+            include/ripemd160.hpp          \
+            include/md.hpp                 \
+            include/multibuffer.hpp        \
+            include/batchhashcalculator.hpp \
+            include/blake3.hpp             \
+            include/xxh3.hpp               \
+            include/commandline.hpp        \
+            include/checksumfile.hpp       \
+            include/checksumverifier.hpp   \
+            include/batchqueue.hpp         \
+            include/batchdialog.hpp        \
+            include/directorywalker.hpp    \
+            include/taskscheduler.hpp      \
+            include/filemapping.hpp        \
+            include/uringreader.hpp        \
+            include/cachedropper.hpp       \
+            include/fileextents.hpp        \
+            include/disklayout.hpp
+
+FORMS    += mainwindow.ui about.ui fileinfowidget.ui fileiconwidget.ui base64dialog.ui batchdialog.ui
 
 RESOURCES += res/icon.qrc res/translations.qrc
 
@@ -89,9 +137,6 @@ PATCH_VER  = 3
 VERSION    = $${MAJOR_VER}.$${MINOR_VER}.$${PATCH_VER}
 DEFINES   += "MAJOR_VER=$${MAJOR_VER}" "MINOR_VER=$${MINOR_VER}" "PATCH_VER=$${PATCH_VER}"
 
-LIBS += -L$$PWD/lib/qtcryptohash/bin/$${PLATFORM}/$${BUILD}/ -lQtCryptoHash$${ARCH_SUFFIX}
-DEFINES += QTCRYPTOHASH_STATIC
-
 ######################## OS DEPENDENT OPTIONS ########################
 win32 {
     # CONTENT OF THE RC FILE #
@@ -0,0 +1,68 @@
+#ifndef ALGORITHMS_HPP
+#define ALGORITHMS_HPP
+
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+namespace algorithms {
+    /* Stable identifiers of the supported algorithms: they are used in the signals of the
+     * calculators and (through name()) in the settings file, so new algorithms must always
+     * be added just before Count. */
+    enum Id {
+        CRC16, CRC32, CRC64,
+        MD4, MD5, SHA1,
+        SHA224, SHA256, SHA384, SHA512,
+        SHA3_224, SHA3_256, SHA3_384, SHA3_512,
+        TIGER, RIPEMD160,
+        HAVAL128, HAVAL160, HAVAL192, HAVAL224, HAVAL256,
+        CRC32C,
+        BLAKE3,
+        XXH3_64, XXH3_128,
+        Count
+    };
+
+    /* Families of algorithms hashed together by the same tasks of the calculators. */
+    enum Group { Checksums, Legacy, Sha2, Sha3, Haval, Blake, Xxh3, GroupCount };
+
+    class Set {
+        public:
+            Set() : mBits( 0 ) {}
+
+            static Set all() { Set set; set.mBits = ( Q_UINT64_C( 1 ) << Count ) - 1; return set; }
+            static Set of( Id id ) { Set set; set.insert( id ); return set; }
+
+            bool contains( Id id ) const { return ( mBits & bit( id ) ) != 0; }
+            bool isEmpty() const { return mBits == 0; }
+            void insert( Id id ) { mBits |= bit( id ); }
+            void remove( Id id ) { mBits &= ~bit( id ); }
+
+            QList< Id > toList() const {
+                QList< Id > ids;
+                for ( int i = 0; i < Count; ++i ) {
+                    if ( contains( static_cast< Id >( i ) ) ) {
+                        ids << static_cast< Id >( i );
+                    }
+                }
+                return ids;
+            }
+
+            bool operator==( const Set& other ) const { return mBits == other.mBits; }
+            bool operator!=( const Set& other ) const { return mBits != other.mBits; }
+
+        private:
+            static quint64 bit( Id id ) { return Q_UINT64_C( 1 ) << id; }
+
+            quint64 mBits;
+    };
+
+    extern QString name( Id id );
+    extern bool fromName( const QString& name, Id& id );
+    extern bool isChecksum( Id id );
+    extern Group group( Id id );
+
+    extern QStringList toNames( const Set& set );
+    extern Set fromNames( const QStringList& names );
+}
+
+#endif // ALGORITHMS_HPP
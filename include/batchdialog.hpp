@@ -0,0 +1,74 @@
+#ifndef BATCHDIALOG_HPP
+#define BATCHDIALOG_HPP
+
+#include <QMap>
+#include <QSet>
+
+#include <memory>
+#include <vector>
+
+#include "ui_batchdialog.h"
+
+#include "algorithms.hpp"
+#include "batchqueue.hpp"
+#include "directorywalker.hpp"
+
+/* Table of the files hashed by a BatchQueue: a row for each file, with its progress and a column for each
+ * algorithm. The selected files can be paused, resumed and cancelled. The files of the dropped directories
+ * are added while DirectoryWalker finds them, and the results can be saved as a checksum list sorted by name. */
+class BatchDialog : public QDialog, private Ui::BatchDialog {
+        Q_OBJECT
+
+    public:
+        BatchDialog( QWidget* parent, algorithms::Set selected, bool useUppercase );
+        virtual ~BatchDialog();
+
+        void enqueue( const QStringList& paths, bool cacheNeutral = false ); //files and directories
+        bool isRunning() const;
+
+    private slots:
+        void on_filesFound( QStringList files, QStringList identities );
+        void on_directoryFailed( QString directory, QString error );
+        void on_walkerFinished();
+
+        void on_fileStarted( int file );
+        void on_newHashString( int file, int id, QByteArray hash );
+        void on_newChecksumValue( int file, int id, quint64 value );
+        void on_progressUpdate( int file, float progress );
+        void on_fileFailed( int file, QString error );
+        void on_fileEnded( int file );
+        void on_finished();
+
+        void on_resultsTable_itemSelectionChanged();
+        void on_pauseButton_clicked();
+        void on_cancelButton_clicked();
+        void on_cancelAllButton_clicked();
+        void on_saveButton_clicked();
+
+    private:
+        enum Column { FileColumn, StatusColumn, FirstHashColumn };
+
+        void addFile( const QString& fileName, const QString& identity, bool cacheNeutral );
+        void cancelAll();
+        bool isSearching() const;
+        QList< int > selectedFiles() const;
+        void setStatus( int file, const QString& status );
+        void setHash( int file, int id, const QString& hash, const QString& text );
+        void updateControls();
+
+        const bool mUseUppercase;
+        std::unique_ptr< BatchQueue > mQueue;
+        std::vector< std::unique_ptr< DirectoryWalker > > mWalkers;
+        QSet< QObject* > mCacheNeutralWalkers; //whose files must not stay in the page cache
+        QMap< int, int > mHashColumns; //algorithm -> column
+        QMap< int, QMap< int, QString > > mHashes; //file -> algorithm -> hash, as written in the checksum lists
+        QMap< int, QString > mErrors; //file -> why it failed
+        QStringList mDirectoryErrors;
+        int mHashed;
+        int mFailed;
+
+    protected:
+        void closeEvent( QCloseEvent* event ) Q_DECL_OVERRIDE;
+};
+
+#endif // BATCHDIALOG_HPP
@@ -0,0 +1,68 @@
+#ifndef BATCHHASHCALCULATOR_HPP
+#define BATCHHASHCALCULATOR_HPP
+
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <QWaitCondition>
+
+#include <memory>
+#include <vector>
+
+#include "algorithms.hpp"
+
+class Digest;
+
+namespace multibuffer {
+    class Lanes;
+}
+
+/* Hashes a list of files with the same algorithms. MD4, MD5 and SHA-1 are calculated on up to
+ * multibuffer::LANES files at once: the next blocks of every open file are fed to a single
+ * lane-parallel compression, and as soon as a file ends its lane is finalized and given the
+ * next file of the list. The other algorithms are fed by the same thread through Digest.
+ * The files are opened in the order of their blocks on each disk (see disklayout), not as listed. */
+class BatchHashCalculator : public QThread {
+        Q_OBJECT
+
+    public:
+        BatchHashCalculator( QObject* parent, QStringList fileNames, algorithms::Set selected );
+        virtual ~BatchHashCalculator();
+        void stop();
+        void resume();
+        void pause();
+        bool isPaused();
+        void setCacheNeutral( bool cacheNeutral ); //before start(): the files do not stay in the page cache
+
+    protected:
+        void run() override;
+
+    private:
+        struct Lane;
+        typedef std::vector< std::unique_ptr< Digest > > Digests;
+
+        bool waitForResume(); //blocks while paused, returns false if the calculation was stopped
+        bool open( std::size_t index, Lane& lane, int file );
+        bool refill( Lane& lane );
+        void finish( std::size_t index, Lane& lane );
+
+        const QStringList mFileNames;
+        const algorithms::Set mAlgorithms;
+        bool mCacheNeutral;
+        std::vector< std::unique_ptr< multibuffer::Lanes > > mLanes; // one for each selected multi-buffer algorithm
+        quint64 mTotalSize;
+        quint64 mHashedSize;
+
+        QWaitCondition mPauseCondition;
+        QMutex mMutex; //locked when accessing isPaused
+        bool mIsPaused;
+
+    signals:
+        void newHashString( int file, int id, QByteArray hash );
+        void newChecksumValue( int file, int id, quint64 value );
+        void fileHashed( int file );
+        void fileFailed( int file, QString error );
+        void progressUpdate( float progress );
+};
+
+#endif // BATCHHASHCALCULATOR_HPP
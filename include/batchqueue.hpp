@@ -0,0 +1,109 @@
+#ifndef BATCHQUEUE_HPP
+#define BATCHQUEUE_HPP
+
+#include <QHash>
+#include <QObject>
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "algorithms.hpp"
+#include "disklayout.hpp"
+
+class FileHashCalculator;
+
+/* Queue of the files dropped together on Mr. Hash: each one is read by its own FileHashCalculator, but only
+ * a bounded number of them run at the same time, twice as many as the cores (so that the cores hash the chunks
+ * of some files while the others wait for the disk) and as fit in the memory budget of their buffers. The other files wait
+ * in a queue for each disk, and start as soon as a running one ends: among the disks that can read one more file (see
+ * disklayout::readers, a single file at a time for the hard disks), the one with the oldest queued file reads next
+ * the file whose blocks follow those of the last file started on it (an elevator over their physical offsets).
+ * So the files of different disks are read at the same time, each disk at its own pace. A paused file gives back
+ * its reader, and once resumed it waits for a free reader of its disk before reading again.
+ * Files are identified by their index in the queue, which never changes. The names of a file with hard links,
+ * enqueued with the same identity, are read only once: the others end with the first one. */
+class BatchQueue : public QObject {
+        Q_OBJECT
+
+    public:
+        enum State { Queued, Running, Paused, Hashed, Failed, Cancelled };
+
+        BatchQueue( QObject* parent, algorithms::Set selected );
+        virtual ~BatchQueue();
+
+        //returns the index of the file; cacheNeutral: it does not stay in the page cache
+        int enqueue( const QString& fileName, const QString& identity = QString(), bool cacheNeutral = false );
+        void pause( int file );
+        void resume( int file );
+        void cancel( int file ); //removes a queued file, stops a running one
+        void cancelAll();
+
+        int count() const;
+        QString fileName( int file ) const;
+        State state( int file ) const;
+        int original( int file ) const; //the file read in its place (same identity), or -1
+        bool isRunning() const; //true while some file is queued, running or paused
+        int maxRunning() const;
+        algorithms::Set algorithms() const;
+
+    private slots:
+        void on_newHashString( int id, QByteArray hash );
+        void on_newChecksumValue( int id, quint64 value );
+        void on_progressUpdate( float progress );
+        void on_failed( QString error );
+        void on_finished();
+
+    private:
+        struct Job {
+            Job( const QString& name, bool neutral )
+                : fileName( name ), cacheNeutral( neutral ), state( Queued ), original( -1 ), reading( false ),
+                  located( false ) {
+                location.device = 0;
+                location.offset = 0;
+            }
+
+            QString fileName;
+            bool cacheNeutral;
+            State state;
+            int original;
+            bool reading; //holds a reader of its device: running, and not waiting for a reader after a resume
+            bool located;
+            disklayout::Location location; //the device when enqueued, the offset when close to the head of its queue
+            std::vector< int > links; //the files waiting for this one to end
+            std::unique_ptr< FileHashCalculator > calculator; //only while running or paused
+        };
+
+        int jobOf( QObject* calculator ) const;
+        void end( int file, State state );
+        void finish( int file, State state ); //and its links
+        void setReading( Job& job, bool reading ); //takes or gives back a reader of its device
+        void startNext(); //resumes the files waiting for a reader, then starts the queued ones
+        int nextFile(); //to be started, -1 if none (or if their disks are busy)
+        bool hasReader( quint64 device ); //the device can read one more file
+        bool isStartable( int file ) const; //queued, and not waiting for another name of the same file
+        const disklayout::Location& location( int file );
+
+        const algorithms::Set mAlgorithms;
+        const int mMaxRunning;
+        std::vector< Job > mJobs;
+        QHash< QObject*, int > mRunning; //calculator -> file
+        QHash< QString, int > mIdentities; //identity -> first file enqueued with it
+        QHash< quint64, std::deque< int > > mQueues; //device -> its files not started yet, in the order they were enqueued
+        QHash< quint64, quint64 > mHeads; //device -> physical offset of the last file started on it
+        QHash< quint64, int > mReaders; //device -> files being read from it (not paused)
+        std::deque< int > mWaiting; //files resumed while their disk had no free reader, still paused
+        QHash< quint64, int > mMaxReaders; //device -> its limit, 0 if none
+        int mUnfinished; //queued, running or paused
+
+    signals:
+        void fileStarted( int file );
+        void newHashString( int file, int id, QByteArray hash );
+        void newChecksumValue( int file, int id, quint64 value );
+        void progressUpdate( int file, float progress );
+        void fileFailed( int file, QString error );
+        void fileEnded( int file ); //hashed, failed or cancelled: its state tells which
+        void finished(); //when the queue gets empty
+};
+
+#endif // BATCHQUEUE_HPP
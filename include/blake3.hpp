@@ -0,0 +1,68 @@
+#ifndef BLAKE3_HPP
+#define BLAKE3_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace blake3 {
+    /* Implementations of the compression of several chunks (or parent nodes) at once, each in its own 32 bit
+     * element of the vectors: AVX-512 (16 at once), AVX2 (8), SSE4.1 (4) or one after the other in portable C++. */
+    enum Kernel { Portable, Sse41, Avx2, Avx512 };
+
+    // The fastest kernel supported by the CPU, selected (and logged) on the first call
+    extern Kernel kernel();
+    extern const char* kernelName( Kernel kernel );
+
+    static const std::size_t CHUNK_LENGTH = 1024;
+
+    // The blocks of a single chunk, the last of which is compressed only at the end, with different flags
+    class ChunkState {
+        public:
+            void reset( uint64_t counter );
+            void update( const byte* data, std::size_t length );
+
+            uint64_t counter() const { return mCounter; }
+            std::size_t length() const { return 64 * mBlocksCompressed + mBlockLength; }
+
+            void chainingValue( uint32_t cv[ 8 ] ) const;
+            void rootHash( byte hash[ 32 ] ) const;
+
+        private:
+            uint32_t mCv[ 8 ];
+            uint64_t mCounter;
+            byte mBlock[ 64 ];
+            std::size_t mBlockLength;
+            std::size_t mBlocksCompressed;
+    };
+}
+
+/* BLAKE3 in its default hash mode, with the 256 bit output. The message is split in chunks of 1 KB, the leaves
+ * of a binary tree: the complete subtrees found in each write are hashed with the SIMD kernels across their
+ * chunks and, when large enough, as tasks of the TaskScheduler. The chaining values of the
+ * subtrees are merged lazily on a stack, so that the last one can still be finalized as the root. */
+class Blake3 : public HashAlgorithm {
+    public:
+        Blake3() { init(); }
+
+        void init() override;
+        void write( const byte* inbuf, int inlen ) override { update( inbuf, static_cast< std::size_t >( inlen ) ); }
+        byte* final() override;
+        unsigned int hash_length() const override { return 32; }
+
+        // As write(), for inputs of any size (e.g. memory mapped files)
+        void update( const byte* data, std::size_t length );
+
+    private:
+        void pushCv( const uint32_t cv[ 8 ], uint64_t chunkCounter );
+        void mergeCvStack( uint64_t totalChunks );
+
+        static const std::size_t MAX_DEPTH = 54; // 2^64 bytes in chunks of 2^10
+
+        blake3::ChunkState mChunk;
+        uint32_t mCvStack[ MAX_DEPTH + 1 ][ 8 ];
+        std::size_t mCvStackLength;
+        byte mDigest[ 32 ];
+};
+
+#endif // BLAKE3_HPP
@@ -0,0 +1,30 @@
+#ifndef CACHEDROPPER_HPP
+#define CACHEDROPPER_HPP
+
+#include <QtGlobal>
+
+class QFile;
+
+/* Keeps a file read in cache-neutral mode from filling the page cache (and evicting the pages of the other
+ * programs): the pages read are dropped with POSIX_FADV_DONTNEED a few megabytes behind the reads, or never
+ * cached on macOS (F_NOCACHE). The files already cached when they are opened are left alone, since some other
+ * program is using them. On Windows the files are read normally. */
+class CacheDropper {
+    public:
+        CacheDropper( QFile& file, bool enabled, qint64 offset = 0 ); //reading the file from offset
+        ~CacheDropper(); //drops the pages read but not yet dropped
+
+        void advance( qint64 offset ); //the file has been read up to offset
+
+        static bool isInUse( QFile& file );
+
+    private:
+        void drop( qint64 offset ); //the pages from mDropped to offset
+
+        QFile& mFile;
+        const bool mEnabled;
+        qint64 mDropped; //up to this offset
+        qint64 mRead;
+};
+
+#endif // CACHEDROPPER_HPP
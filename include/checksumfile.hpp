@@ -0,0 +1,34 @@
+#ifndef CHECKSUMFILE_HPP
+#define CHECKSUMFILE_HPP
+
+#include <QList>
+#include <QString>
+
+#include "algorithms.hpp"
+
+/* Lists of hashes to verify: GNU (sha256sum, md5sum), BSD tagged (SHA256 (file) = hash) and SFV files. */
+namespace checksumfile {
+    struct Entry {
+        QString fileName; //as listed
+        QString path; //relative names are resolved against the directory of the list
+        algorithms::Id id;
+        QString expected; //hexadecimal
+    };
+
+    /* Appends the entries of the list to entries and returns the number of its improperly formatted lines,
+     * or -1 (with the reason in error) if it cannot be read. The algorithm of the untagged lines is, in order,
+     * the one of hint, then the one in the name of the list (SHA256SUMS, *.md5), then the one with their length. */
+    extern int read( const QString& listName, const algorithms::Set& hint, QList< Entry >& entries, QString& error );
+
+    // A checksum as written in the lists, zero-padded to the width of the algorithm
+    extern QString checksumText( algorithms::Id id, quint64 value );
+
+    /* As coreutils, a name containing backslashes or line breaks is escaped,
+     * and the line starts with a backslash to tell that it has been */
+    extern bool escape( QString& fileName );
+
+    // A line of a list, without its line break: hash  name, or ID (name) = hash if tagged
+    extern QString line( QString fileName, algorithms::Id id, const QString& hash, bool tagged );
+}
+
+#endif // CHECKSUMFILE_HPP
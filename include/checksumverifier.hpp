@@ -0,0 +1,50 @@
+#ifndef CHECKSUMVERIFIER_HPP
+#define CHECKSUMVERIFIER_HPP
+
+#include <QMutex>
+#include <QObject>
+#include <QThreadPool>
+
+#include <atomic>
+#include <deque>
+#include <vector>
+
+#include "checksumfile.hpp"
+
+/* Verifies the entries of checksum lists on a pool of threads, one file per thread at a time, calculating
+ * only the algorithm of each entry. The files of each disk are queued in the order of their blocks, and read by
+ * as many threads as that disk can serve at once (see disklayout): one for a hard disk, so that it is not made
+ * to seek between files, while the other disks are read at the same time. The results are emitted in the order
+ * in which the files are completed. */
+class ChecksumVerifier : public QObject {
+        Q_OBJECT
+
+    public:
+        enum Result { Ok, Failed, Missing, Unreadable };
+
+        ChecksumVerifier( QObject* parent, const QList< checksumfile::Entry >& entries );
+        virtual ~ChecksumVerifier();
+        void setCacheNeutral( bool cacheNeutral ); //before start(): the files do not stay in the page cache
+        void start();
+        void stop();
+
+    private:
+        class Task;
+
+        int next( int queue ); //the next entry of the queue of a device, -1 if none
+        void verify( int entry ); //on a thread of the pool
+
+        const QList< checksumfile::Entry > mEntries;
+        bool mCacheNeutral;
+        QThreadPool mPool;
+        std::vector< std::deque< int > > mQueues; //entries, by device
+        QMutex mQueueMutex; //locked when accessing mQueues after start()
+        std::atomic< int > mRemaining;
+        std::atomic< bool > mStopped;
+
+    signals:
+        void entryVerified( int entry, int result, QString error );
+        void finished();
+};
+
+#endif // CHECKSUMVERIFIER_HPP
@@ -0,0 +1,62 @@
+#ifndef CHUNKRING_HPP
+#define CHUNKRING_HPP
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <vector>
+
+/* Fixed ring of reusable buffers filled by a single producer (the file reader) and read,
+ * without copies, by a fixed number of consumers (the digest groups): a buffer is handed
+ * back to the producer only after every consumer has released it. The producer can also
+ * commit memory of its own (e.g. a mapped file) instead of filling the buffers: since every
+ * consumer releases the chunks in order, that memory is no longer read once the slot of its
+ * last chunk has been acquired again. */
+class ChunkRing {
+    public:
+        struct Chunk {
+            const char* data;
+            int length; // 0 marks the end of the stream
+        };
+
+        ChunkRing( int chunkCount, int chunkSize, int consumerCount );
+
+        int chunkSize() const { return mChunkSize; }
+        int chunkCount() const { return static_cast< int >( mSlots.size() ); }
+        char* buffer( int slot ) { return mSlots[ slot ].buffer.data(); }
+
+        // Producer side: waits for the next slot, returns its buffer (nullptr if the ring has been aborted)
+        char* acquireWrite();
+        void commitWrite( int length );
+        void commitWrite( const char* data, int length ); //instead of the acquired buffer, empty if chunkSize is 0
+        /* Never blocking: the slot of the chunk that will be written ahead chunks after the next one, or -1 if
+         * it is still being read (its buffer can be filled in advance, the chunks are still committed in order) */
+        int tryAcquireWrite( int ahead );
+
+        // Consumer side, never blocking: returns false if no chunk is waiting or if the ring has been aborted
+        bool acquireRead( int consumer, Chunk& chunk );
+        void releaseRead( int consumer );
+        bool hasChunk( int consumer );
+
+        void abort();
+
+    private:
+        struct Slot {
+            std::vector< char > buffer;
+            const char* data; //the buffer or the memory of the producer
+            int length;
+            int pending; // consumers that still have to release the slot
+        };
+
+        const int mChunkSize;
+        const int mConsumerCount;
+        std::vector< Slot > mSlots;
+        std::vector< quint64 > mReadSequence; // next chunk of each consumer
+        quint64 mWriteSequence;
+        bool mAborted;
+
+        QMutex mMutex;
+        QWaitCondition mChunkReleased;
+};
+
+#endif // CHUNKRING_HPP
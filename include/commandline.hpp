@@ -0,0 +1,87 @@
+#ifndef COMMANDLINE_HPP
+#define COMMANDLINE_HPP
+
+#include <QObject>
+#include <QMap>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include <memory>
+
+#include "algorithms.hpp"
+#include "checksumfile.hpp"
+
+class FileHashCalculator;
+class BatchHashCalculator;
+class BatchQueue;
+class ChecksumVerifier;
+
+/* Headless mode of Mr. Hash (mrhash -a sha256,crc32 file...), run on a QCoreApplication without loading any widget.
+ * A single file is hashed by FileHashCalculator, which uses all the cores on it. Several files are hashed by
+ * BatchHashCalculator when all the algorithms are MD4, MD5 or SHA-1, whose lanes it fills with different files,
+ * and otherwise by the FileHashCalculators of a BatchQueue, which share the cores. The results are printed in the order of the arguments, as the lines of the GNU coreutils
+ * (sha256sum) or, with --tag or more than one algorithm, of the BSD checksum utilities. With -r, the directories
+ * are replaced by all the files of their trees, listed by DirectoryWalker.
+ * With -c, the arguments are checksum lists whose entries are verified by ChecksumVerifier. With --cache-neutral,
+ * the files read are dropped from the page cache (see CacheDropper). */
+class CommandLine : public QObject {
+        Q_OBJECT
+
+    public:
+        explicit CommandLine( QObject* parent = 0 );
+        virtual ~CommandLine();
+
+        static bool isRequested( int argc, char* argv[] ); //true if the arguments contain an option
+
+        // Parses the arguments of the application and hashes the files: returns the exit status of the process
+        int exec();
+
+    private slots:
+        void on_newHashString( int id, QByteArray hash );
+        void on_newChecksumValue( int id, quint64 value );
+        void on_failed( QString error );
+        void on_newHashString( int file, int id, QByteArray hash );
+        void on_newChecksumValue( int file, int id, quint64 value );
+        void on_fileHashed( int file );
+        void on_fileFailed( int file, QString error );
+        void on_entryVerified( int entry, int result, QString error );
+        void on_finished();
+
+    private:
+        struct Result {
+            Result() : done( false ) {}
+
+            bool done;
+            QString error;
+            QMap< int, QString > hashes; //hexadecimal, by algorithm
+        };
+
+        static bool isMultiBuffer( const algorithms::Set& selected ); //only algorithms of multibuffer::Lanes
+        QStringList expand( const QStringList& names ); //replaces the directories with the files they contain
+        int check( const QStringList& listNames, const algorithms::Set& hint, bool cacheNeutral );
+        void printReady();
+        void printResult( const QString& fileName, const Result& result );
+
+        QStringList mFileNames;
+        algorithms::Set mAlgorithms;
+        bool mBsdStyle;
+        QVector< Result > mResults; //indexed as mFileNames
+        int mNextResult; //the first one not printed yet
+        int mStatus;
+        QTextStream mOut;
+        QTextStream mErr;
+
+        QList< checksumfile::Entry > mEntries;
+        bool mQuiet; //do not print the entries verified successfully
+        int mMalformedLines;
+        int mMismatches;
+        int mUnreadable;
+
+        std::unique_ptr< FileHashCalculator > mFileCalculator;
+        std::unique_ptr< BatchHashCalculator > mBatchCalculator;
+        std::unique_ptr< BatchQueue > mQueue;
+        std::unique_ptr< ChecksumVerifier > mVerifier;
+};
+
+#endif // COMMANDLINE_HPP
@@ -0,0 +1,43 @@
+#ifndef CPUFEATURES_HPP
+#define CPUFEATURES_HPP
+
+#include <QLoggingCategory>
+
+/* SIMD kernels are built only for x86-64, where they are selected at runtime through cpu::features();
+ * with GCC and Clang the functions using the intrinsics must be marked with MRHASH_TARGET. */
+#if defined( __x86_64__ ) || defined( _M_X64 )
+#define MRHASH_X86_64
+#endif
+
+// MSVC provides the AVX-512 intrinsics only since Visual Studio 2017 15.3
+#if defined( MRHASH_X86_64 ) && ( !defined( _MSC_VER ) || _MSC_VER >= 1911 )
+#define MRHASH_AVX512
+#endif
+
+#if defined( MRHASH_X86_64 ) && ( defined( __GNUC__ ) || defined( __clang__ ) )
+#define MRHASH_TARGET( features ) __attribute__( ( target( features ) ) )
+#else
+#define MRHASH_TARGET( features )
+#endif
+
+namespace cpu {
+    struct Features {
+        bool sse41;
+        bool sse42;
+        bool pclmul;
+        bool avx2;
+        bool avx512;  // AVX-512 F and VL
+        bool sha;     // Intel SHA extensions
+        bool bmi2;
+    };
+
+    // Detected once, with the OS support for the AVX registers taken into account
+    extern const Features& features();
+}
+
+// Category of the messages reporting the kernels selected by the accelerated algorithms
+namespace cpu {
+    Q_DECLARE_LOGGING_CATEGORY( kernels )
+}
+
+#endif // CPUFEATURES_HPP
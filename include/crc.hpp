@@ -3,6 +3,8 @@
 
 #include <QString>
 
+#include <cstddef>
+
 #include "boost/crc.hpp"
 
 using boost::crc_optimal;
@@ -17,8 +19,53 @@ typedef crc_optimal< 32, 0x04c11db7, 0xffffffff, 0xffffffff, true, true > boost_
 // CRC-64 (XZ) - http://reveng.sourceforge.net/crc-catalogue/17plus.htm#crc.cat-bits.64
 typedef crc_optimal< 64, 0x42f0e1eba9ea3693, 0xffffffffffffffff, 0xffffffffffffffff, true, true > boost_crc64;
 
+// CRC-32C (Castagnoli, iSCSI) - http://reveng.sourceforge.net/crc-catalogue/17plus.htm#crc.cat.crc-32c
+typedef crc_optimal< 32, 0x1edc6f41, 0xffffffff, 0xffffffff, true, true > boost_crc32c;
+
+namespace crc {
+    /* Update the raw (not yet xored) register of the reflected CRC with the given (normal) polynomial:
+     * CRC-16 uses slicing-by-8 tables, CRC-32 and CRC-64 use slicing-by-16 tables or, on large inputs
+     * and when the CPU supports it, fold 64 bytes at a time with carry-less multiplications (PCLMULQDQ).
+     * CRC-32C uses the SSE 4.2 crc32 instruction on three interleaved streams, if available.
+     * They are instantiated only for the polynomials of the typedefs below. */
+    template< typename T, quint64 Polynomial >
+    T update( T crc, const void* data, std::size_t length );
+
+    /* CRC of the concatenation of two messages, given their CRCs and the length of the second one
+     * (the same as zlib's crc32_combine, it needs only O(log(secondLength)) GF(2) multiplications) */
+    template< typename T, quint64 Polynomial >
+    T combine( T first, T second, quint64 secondLength );
+}
+
+/* Drop-in replacements for the boost typedefs above, with the same output and interface.
+ * All these CRCs are reflected and have init == xorout == all ones. */
+template< typename T, quint64 Polynomial >
+class ReflectedCrc {
+    public:
+        ReflectedCrc() : mState( ~T( 0 ) ) {}
+
+        void process_bytes( const void* data, std::size_t length ) {
+            mState = crc::update< T, Polynomial >( mState, data, length );
+        }
+        T checksum() const { return static_cast< T >( ~mState ); }
+        void reset() { mState = ~T( 0 ); }
+
+        // Continues with the data processed by next, as if it had been processed by this engine
+        void append( const ReflectedCrc& next, quint64 nextLength ) {
+            mState = static_cast< T >( ~crc::combine< T, Polynomial >( checksum(), next.checksum(), nextLength ) );
+        }
+
+    private:
+        T mState;
+};
+
+typedef ReflectedCrc< quint16, 0x1021 > Crc16;
+typedef ReflectedCrc< quint32, 0x04c11db7 > Crc32;
+typedef ReflectedCrc< quint32, 0x1edc6f41 > Crc32C;
+typedef ReflectedCrc< quint64, 0x42f0e1eba9ea3693 > Crc64;
+
 struct QChecksum {
-    enum Algorithm { CRC16, CRC32, CRC64 };
+    enum Algorithm { CRC16, CRC32, CRC64, CRC32C };
     static quint64 checksum( const QByteArray msg , Algorithm algorithm );
 };
 
@@ -0,0 +1,46 @@
+#ifndef DIGEST_HPP
+#define DIGEST_HPP
+
+#include <QByteArray>
+
+#include <memory>
+#include <vector>
+
+#include "algorithms.hpp"
+
+/* Common streaming interface over the different hash libraries used by Mr. Hash,
+ * so that the calculators can instantiate and feed only the selected algorithms.
+ * A single digest may calculate several algorithms sharing the same compression function. */
+class Digest {
+    public:
+        explicit Digest( algorithms::Set ids ) : mIds( ids ) {}
+        virtual ~Digest() {}
+
+        const algorithms::Set& ids() const { return mIds; }
+
+        virtual void addData( const char* data, int length ) = 0;
+
+        // Valid only for checksum algorithms (see algorithms::isChecksum)
+        virtual quint64 checksum( algorithms::Id id ) { Q_UNUSED( id ) return 0; }
+
+        /* Valid only for checksum digests: continues with the state of next, a digest of the same algorithms
+         * fed with the nextLength bytes following the ones fed to this digest */
+        virtual void combine( const Digest& next, quint64 nextLength ) { Q_UNUSED( next ) Q_UNUSED( nextLength ) }
+
+        // Valid only for hash algorithms
+        virtual QByteArray result( algorithms::Id id ) { Q_UNUSED( id ) return QByteArray(); }
+
+        static std::vector< std::unique_ptr< Digest > > create( const algorithms::Set& ids );
+
+        static quint64 checksum( const QByteArray& data, algorithms::Id id );
+        static QByteArray hash( const QByteArray& data, algorithms::Id id );
+
+    private:
+        Q_DISABLE_COPY( Digest )
+
+        static std::unique_ptr< Digest > create( algorithms::Id id );
+
+        const algorithms::Set mIds;
+};
+
+#endif // DIGEST_HPP
@@ -0,0 +1,63 @@
+#ifndef DIRECTORYWALKER_HPP
+#define DIRECTORYWALKER_HPP
+
+#include <QMutex>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QStringList>
+#include <QThreadPool>
+
+#include <atomic>
+
+/* Finds the regular files in directory trees, reading each directory on a thread of its own pool, so that the
+ * files of the directories already read can be hashed while the others are still being listed.
+ * Symbolic links are followed, but a directory is never read twice (e.g. through a link to one of its parents).
+ * The files with more than one name (hard links) are reported with an identity shared by all their names,
+ * so that they can be read only once. */
+class DirectoryWalker : public QObject {
+        Q_OBJECT
+
+    public:
+        DirectoryWalker( QObject* parent, const QStringList& directories );
+        virtual ~DirectoryWalker();
+        void start();
+        void stop();
+        void wait();
+        bool isRunning() const;
+
+        QStringList files() const; //all the files found, sorted
+        QStringList errors() const; //"directory: reason" for each directory that could not be listed
+
+    private:
+        class Task;
+        typedef QPair< quint64, quint64 > Identity; //device and inode
+
+        typedef QPair< QString, QString > Entry; //path and identity
+
+        void walk( const QString& directory ); //on a thread of the pool
+        void read( const QString& directory, QList< Entry >& entries );
+        void walkLater( const QString& directory );
+        bool visit( const Identity& directory ); //false if it has been already read
+        bool visit( const QString& canonicalPath );
+        void found( const QStringList& files, const QStringList& identities );
+        void failed( const QString& directory, const QString& error );
+
+        const QStringList mDirectories;
+        QThreadPool mPool;
+        std::atomic< int > mPending; //directories not read yet
+        std::atomic< bool > mStopped;
+        mutable QMutex mMutex; //locked when accessing the members below
+        QSet< Identity > mVisited;
+        QSet< QString > mVisitedPaths; //where no identity is available
+        QStringList mFiles;
+        QStringList mErrors;
+
+    signals:
+        // the files of a directory; the identities are empty for the files with a single name
+        void filesFound( QStringList files, QStringList identities );
+        void directoryFailed( QString directory, QString error );
+        void finished();
+};
+
+#endif // DIRECTORYWALKER_HPP
@@ -0,0 +1,35 @@
+#ifndef DISKLAYOUT_HPP
+#define DISKLAYOUT_HPP
+
+#include <QString>
+
+#include <vector>
+
+/* Where the files are on their disks, so that a batch of files on a hard disk can be read in the order of their
+ * blocks instead of seeking back and forth between them. The physical offsets come from FIEMAP on Linux; on the
+ * other systems, and on the filesystems without it, every file is at offset 0 and the order is left as it is.
+ * Each device also has its own limit of files read at once: a hard disk reads one file at a time, while the
+ * solid-state drives (and the devices of unknown kind, e.g. network filesystems) read as many as the caller runs.
+ * The kind of a device is read from /sys/dev/block/<major>:<minor>/queue/rotational on Linux. */
+namespace disklayout {
+    struct Location {
+        quint64 device; //st_dev, 0 if unknown
+        quint64 offset; //physical offset of the first extent of the file, 0 if unknown
+    };
+
+    enum Kind { Unknown, Rotational, SolidState };
+
+    extern quint64 device( const QString& fileName ); //st_dev, without opening the file (0 if unknown)
+    extern Location locate( const QString& fileName );
+    extern Kind kind( quint64 device );
+
+    // Files read at once from a device: 0 if it has no limit of its own
+    extern int readers( quint64 device );
+    extern void setReaders( Kind kind, int readers ); //before reading, for all the devices of that kind
+
+    /* The indices of the files in reading order: the devices in the order of their first file, and the files of
+     * each device by physical offset (the files at the same offset, as the unknown ones, in their given order) */
+    extern std::vector< int > readingOrder( const std::vector< Location >& locations );
+}
+
+#endif // DISKLAYOUT_HPP
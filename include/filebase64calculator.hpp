@@ -1,21 +1,27 @@
 #ifndef FILEBAS64CALCULATOR_HPP
 #define FILEBAS64CALCULATOR_HPP
 
-#include <QWidget>
-#include <QThread>
+#include <QObject>
 
-class FileBase64Calculator : public QThread {
+#include <atomic>
+
+#include "taskscheduler.hpp"
+
+// Encodes a file as a task of the TaskScheduler
+class FileBase64Calculator : public QObject {
         Q_OBJECT
 
     public:
-        FileBase64Calculator( QWidget* parent, QString fileName );
+        FileBase64Calculator( QObject* parent, QString fileName );
         virtual ~FileBase64Calculator();
-
-    protected:
-        void run() override;
+        void start();
+        void stop(); //waits for the task, completed is not emitted
+        bool isRunning() const;
 
     private:
         const QString mFileName;
+        std::atomic< bool > mStopped;
+        TaskScheduler::Group mTasks;
 
     signals:
         void completed( QByteArray base64 );
@@ -0,0 +1,34 @@
+#ifndef FILEEXTENTS_HPP
+#define FILEEXTENTS_HPP
+
+#include <QtGlobal>
+
+class QFile;
+
+/* The data and the holes of a sparse file (VM images, databases), found with SEEK_DATA/SEEK_HOLE, so that the
+ * holes can be hashed from zeros() without reading them. The holes shorter than a chunk are reported as data,
+ * and the position of the file is left where it was. Files with all their blocks allocated, the other
+ * kinds of files and the systems without SEEK_HOLE (Windows) have a single data extent. */
+class FileExtents {
+    public:
+        explicit FileExtents( QFile& file );
+
+        bool isSparse() const;
+        //the end of the extent containing offset: past the end of the file, or if it is not sparse, all is data
+        qint64 extentEnd( qint64 offset, bool& hole );
+
+        static const char* zeros(); //ZerosLength bytes of a shared zero page, mapped read-only
+        static const int ZerosLength = 64 * 1024 * 1024;
+
+    private:
+        void find( qint64 offset );
+
+        QFile& mFile;
+        qint64 mSize;
+        bool mSparse;
+        qint64 mStart; //of the last extent found
+        qint64 mEnd;
+        bool mHole;
+};
+
+#endif // FILEEXTENTS_HPP
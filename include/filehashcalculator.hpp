@@ -1,36 +1,71 @@
 #ifndef FILEHASHCALCULATOR_H
 #define FILEHASHCALCULATOR_H
 
-#include <QWidget>
 #include <QMutex>
 #include <QWaitCondition>
 #include <QThread>
 
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "algorithms.hpp"
+
+class QFile;
+class CacheDropper;
+class ChunkRing;
+class Digest;
+class FileExtents;
+class FileMapping;
+class UringReader;
+
+/* Reads a file on its own thread, which is left to wait for the disk: the digests are fed by the tasks
+ * of the TaskScheduler, shared with the other files. */
 class FileHashCalculator : public QThread {
         Q_OBJECT
 
     public:
-        FileHashCalculator( QWidget* parent, QString fileName );
+        FileHashCalculator( QObject* parent, QString fileName, algorithms::Set selected );
         virtual ~FileHashCalculator();
         void stop();
         void resume();
         void pause();
         bool isPaused();
+        void setCacheNeutral( bool cacheNeutral ); //before start(): the file does not stay in the page cache
+
+        static qint64 bufferMemory(); //upper bound of the memory allocated for the buffers while hashing a file
 
     protected:
         void run() override;
 
     private:
+        typedef std::vector< std::unique_ptr< Digest > > Digests;
+
+        bool waitForResume(); //blocks while paused, returns false if the calculation was stopped
+        Digests hashPipelined( QFile& file, bool buffered = false ); //buffered: neither mapped nor queued
+        bool readBuffered( QFile& file, FileExtents& extents, ChunkRing& ring, CacheDropper& dropper,
+                           const std::function< void() >& chunkWritten );
+        bool readMapped( FileMapping& mapping, FileExtents& extents, qint64 size, ChunkRing& ring,
+                         const std::function< void() >& chunkWritten );
+        bool readQueued( UringReader& uring, QFile& file, FileExtents& extents, ChunkRing& ring, CacheDropper& dropper,
+                         const std::function< void() >& chunkWritten );
+        bool hashRanges( qint64 size, Digests& digests );
+        bool hashMapped( QFile& file, Digests& digests );
+
         const QString mFileName;
+        const algorithms::Set mAlgorithms;
+        bool mCacheNeutral;
+        bool mDropCache; //cache neutral, and not already cached
 
         QWaitCondition mPauseCondition;
         QMutex mMutex; //locked when accessing isPaused
         bool mIsPaused;
 
     signals:
-        void newHashString( int index, QByteArray hash );
-        void newChecksumValue( int index, quint64 value );
+        void newHashString( int id, QByteArray hash );
+        void newChecksumValue( int id, quint64 value );
         void progressUpdate( float progress );
+        void failed( QString error ); //instead of the results, if the file cannot be read
 };
 
 #endif // FILEHASHCALCULATOR_H
@@ -0,0 +1,36 @@
+#ifndef FILEMAPPING_HPP
+#define FILEMAPPING_HPP
+
+#include <QtGlobal>
+
+#include <vector>
+
+class QFile;
+
+/* Maps a regular file in memory a window at a time, so that it can be hashed without copying it out of the
+ * page cache: each window is advised to be read ahead sequentially. On POSIX systems, the pages of a file
+ * truncated while it is mapped read as zeros instead of raising SIGBUS, and isTruncated() tells that the
+ * data read was not the file's. */
+class FileMapping {
+    public:
+        explicit FileMapping( QFile& file );
+        ~FileMapping(); //unmaps the windows still mapped
+
+        bool isMappable() const; //a regular file, not empty
+        bool isCached( qint64 offset, qint64 length ); //most of the range is in the page cache
+        const char* map( qint64 offset, qint64 length ); //nullptr if it cannot be mapped
+        void unmap( const char* window );
+        bool isTruncated() const;
+
+    private:
+        struct Window {
+            uchar* data;
+            int guard; //index of the range watched for SIGBUS, -1 if none
+        };
+
+        QFile& mFile;
+        std::vector< Window > mWindows;
+        bool mTruncated;
+};
+
+#endif // FILEMAPPING_HPP
@@ -19,41 +19,201 @@
 
 #include <cstdint>
 #include <string.h>
-#include <string>
 
 #include <QtGlobal>
 
-using std::string;
+namespace haval {
+    struct Context {
+        uint32_t digest[8];		/* message digest (fingerprint) */
+        byte	 block[128];	/* context data block */
+        size_t	 occupied;		/* number of occupied bytes in the data block */
+        uint32_t bitCount[2];	/* 64-bit message bit count */
+    };
 
+    const uint16_t VERSION = 1;
+
+    void transform3( uint32_t E[8], const byte D[128] );
+    void transform4( uint32_t E[8], const byte D[128] );
+    void transform5( uint32_t E[8], const byte D[128] );
+
+    /* Compile-time selection of the compression function */
+    template< uint16_t Passes > struct Transform;
+    template<> struct Transform< 3 > { static void apply( uint32_t E[8], const byte D[128] ) { transform3( E, D ); } };
+    template<> struct Transform< 4 > { static void apply( uint32_t E[8], const byte D[128] ) { transform4( E, D ); } };
+    template<> struct Transform< 5 > { static void apply( uint32_t E[8], const byte D[128] ) { transform5( E, D ); } };
+
+    Q_DECL_CONSTEXPR inline uint32_t rotr( uint32_t v, uint32_t n ) { return ( v >> n ) | ( v << ( 32 - n ) ); }
+
+    /* Folding of the 256-bit state to the desired hash length (blaargh!) */
+    template< uint16_t Length > struct Fold;
+    template<> struct Fold< 128 > {
+        static void apply( uint32_t d[8] ) {
+            d[3] += ( d[7] & 0xFF000000UL ) | ( d[6] & 0x00FF0000UL ) | ( d[5] & 0x0000FF00UL ) | ( d[4] & 0x000000FFUL );
+            d[2] += ( ( ( d[7] & 0x00FF0000UL ) | ( d[6] & 0x0000FF00UL ) | ( d[5] & 0x000000FFUL ) ) << 8 ) |
+                    ( ( d[4] & 0xFF000000UL ) >> 24 );
+            d[1] += ( ( ( d[7] & 0x0000FF00UL ) | ( d[6] & 0x000000FFUL ) ) << 16 ) |
+                    ( ( ( d[5] & 0xFF000000UL ) | ( d[4] & 0x00FF0000UL ) ) >> 16 );
+            d[0] += ( ( ( d[6] & 0xFF000000UL ) | ( d[5] & 0x00FF0000UL ) | ( d[4] & 0x0000FF00UL ) ) >> 8 ) |
+                    ( ( d[7] & 0x000000FFUL ) << 24 );
+        }
+    };
+    template<> struct Fold< 160 > {
+        static void apply( uint32_t d[8] ) {
+            d[4] += ( ( d[7] & 0xFE000000UL ) | ( d[6] & 0x01F80000UL ) | ( d[5] & 0x0007F000UL ) ) >> 12;
+            d[3] += ( ( d[7] & 0x01F80000UL ) | ( d[6] & 0x0007F000UL ) | ( d[5] & 0x00000FC0UL ) ) >> 6;
+            d[2] += ( ( d[7] & 0x0007F000UL ) | ( d[6] & 0x00000FC0UL ) | ( d[5] & 0x0000003FUL ) );
+            d[1] += rotr( ( d[7] & 0x00000FC0UL ) | ( d[6] & 0x0000003FUL ) | ( d[5] & 0xFE000000UL ), 25 );
+            d[0] += rotr( ( d[7] & 0x0000003FUL ) | ( d[6] & 0xFE000000UL ) | ( d[5] & 0x01F80000UL ), 19 );
+        }
+    };
+    template<> struct Fold< 192 > {
+        static void apply( uint32_t d[8] ) {
+            d[5] += ( ( d[7] & 0xFC000000UL ) | ( d[6] & 0x03E00000UL ) ) >> 21;
+            d[4] += ( ( d[7] & 0x03E00000UL ) | ( d[6] & 0x001F0000UL ) ) >> 16;
+            d[3] += ( ( d[7] & 0x001F0000UL ) | ( d[6] & 0x0000FC00UL ) ) >> 10;
+            d[2] += ( ( d[7] & 0x0000FC00UL ) | ( d[6] & 0x000003E0UL ) ) >>  5;
+            d[1] += ( ( d[7] & 0x000003E0UL ) | ( d[6] & 0x0000001FUL ) );
+            d[0] += rotr( ( d[7] & 0x0000001FUL ) | ( d[6] & 0xFC000000UL ), 26 );
+        }
+    };
+    template<> struct Fold< 224 > {
+        static void apply( uint32_t d[8] ) {
+            d[6] += ( d[7]       ) & 0x0000000FUL;
+            d[5] += ( d[7] >>  4 ) & 0x0000001FUL;
+            d[4] += ( d[7] >>  9 ) & 0x0000000FUL;
+            d[3] += ( d[7] >> 13 ) & 0x0000001FUL;
+            d[2] += ( d[7] >> 18 ) & 0x0000000FUL;
+            d[1] += ( d[7] >> 22 ) & 0x0000001FUL;
+            d[0] += ( d[7] >> 27 ) & 0x0000001FUL;
+        }
+    };
+    template<> struct Fold< 256 > {
+        static void apply( uint32_t* ) {}
+    };
+}
+
+/* HAVAL specialized at compile time on the number of passes and on the output length:
+ * the context is held inline, so a Haval can live on the stack. */
+template< uint16_t Passes, uint16_t Length >
 class Haval : public HashAlgorithm {
-        struct HAVAL_CONTEXT {
-            uint32_t digest[8];		/* message digest (fingerprint) */
-            byte	 block[128];	/* context data block */
-            size_t	 occupied;		/* number of occupied bytes in the data block */
-            uint32_t bitCount[2];	/* 64-bit message bit count */
-            uint32_t temp[8];		/* temporary buffer */
-        };
+        static_assert( Passes >= 3 && Passes <= 5, "Invalid number of passes" );
+        static_assert( Length >= 128 && Length <= 256 && Length % 32 == 0, "Invalid hash length" );
+
+        template< uint16_t, uint16_t > friend class Haval;
 
     public:
-        Haval( uint16_t hashLength, uint16_t passes );
-        virtual ~Haval();
+        Haval() { init(); }
+
+        /* Returns a copy of this Haval producing a digest of another length: the compression
+         * state does not depend on the output length, so the data can be fed once and the
+         * context forked at finalization to get all the lengths. */
+        template< uint16_t ForkLength >
+        Haval< Passes, ForkLength > fork() const {
+            Haval< Passes, ForkLength > forked;
+            forked.mContext = mContext;
+            return forked;
+        }
 
-        string calcHaval( const string &buf );
-    protected:
         void init() Q_DECL_OVERRIDE;
         void write( const byte* dataBuffer, int dataLength ) Q_DECL_OVERRIDE;
         byte* final() Q_DECL_OVERRIDE;
 
-        unsigned int hash_length() const Q_DECL_OVERRIDE { return mLength / 8; }
+        unsigned int hash_length() const Q_DECL_OVERRIDE { return Length / 8; }
 
     private:
-        void mhash_bzero( void* s, int n ) { memset( s, '\0', n ); }
-        void havalTransform3( uint32_t E[8], const byte D[128], uint32_t T[8] );
-        void havalTransform4( uint32_t E[8], const byte D[128], uint32_t T[8] );
-        void havalTransform5( uint32_t E[8], const byte D[128], uint32_t T[8] );
+        /* tail data of the last block */
+        static const byte TAIL_BYTE_0 = ( byte )( ( ( Length & 0x03U ) << 6 ) | ( ( Passes & 0x07U ) << 3 ) | ( haval::VERSION & 0x07U ) );
+        static const byte TAIL_BYTE_1 = ( byte )( Length >> 2 );
 
-        HAVAL_CONTEXT* mContext;
-        uint16_t mPasses, mLength; /* HAVAL parameters */
+        haval::Context mContext;
 };
 
+template< uint16_t Passes, uint16_t Length >
+void Haval< Passes, Length >::init() {
+    /* properly initialize HAVAL context: */
+    memset( &mContext, 0, sizeof ( mContext ) );
+    mContext.digest[0] = 0x243F6A88UL;
+    mContext.digest[1] = 0x85A308D3UL;
+    mContext.digest[2] = 0x13198A2EUL;
+    mContext.digest[3] = 0x03707344UL;
+    mContext.digest[4] = 0xA4093822UL;
+    mContext.digest[5] = 0x299F31D0UL;
+    mContext.digest[6] = 0x082EFA98UL;
+    mContext.digest[7] = 0xEC4E6C89UL;
+}
+
+template< uint16_t Passes, uint16_t Length >
+void Haval< Passes, Length >::write( const byte* dataBuffer, int dataLength ) {
+    if ( dataBuffer == NULL || dataLength == 0 ) {
+        return; /* nothing to do */
+    }
+
+    /* update bit count: */
+    if ( ( ( uint32_t )dataLength << 3 ) > ( 0xFFFFFFFFUL - mContext.bitCount[0] ) ) {
+        mContext.bitCount[1]++;
+    }
+    mContext.bitCount[0] += ( uint32_t )dataLength << 3;
+
+    /* if the data buffer is not enough to complete */
+    /* the context data block, just append it: */
+    if ( mContext.occupied + ( uint32_t )dataLength < 128 ) {
+        memcpy( &mContext.block[mContext.occupied], dataBuffer, dataLength );
+        mContext.occupied += dataLength;
+        return; /* delay processing */
+    }
+
+    /* complete and process the context data block: */
+    memcpy( &mContext.block[mContext.occupied], dataBuffer, 128 - mContext.occupied );
+    dataBuffer += 128 - mContext.occupied;
+    dataLength -= 128 - mContext.occupied;
+    haval::Transform< Passes >::apply( mContext.digest, mContext.block );
+
+    /* process data in chunks of 128 bytes: */
+    while ( dataLength >= 128 ) {
+        haval::Transform< Passes >::apply( mContext.digest, dataBuffer );
+        dataBuffer += 128;
+        dataLength -= 128;
+    }
+
+    /* delay processing of remaining data: */
+    memcpy( mContext.block, dataBuffer, dataLength );
+    mContext.occupied = dataLength; /* < 128 */
+}
+
+template< uint16_t Passes, uint16_t Length >
+byte* Haval< Passes, Length >::final() {
+    uint32_t w;
+
+    /* append toggle to the context data block: */
+    mContext.block[mContext.occupied] = 0x01; /* corrected from 0x80 */
+
+    /* pad the message with null bytes to make it 944 (mod 1024) bits long: */
+    if ( mContext.occupied++ >= 118 ) {
+        /* no room for tail data on the current context block */
+        memset( &mContext.block[mContext.occupied], 0, 128 - mContext.occupied );
+        /* process the completed context data block: */
+        haval::Transform< Passes >::apply( mContext.digest, mContext.block );
+        memset( mContext.block, 0, 118 );
+    } else {
+        memset( &mContext.block[mContext.occupied], 0, 118 - mContext.occupied );
+    }
+    /* append tail data and process last (padded) message block: */
+    mContext.block[118] = TAIL_BYTE_0;
+    mContext.block[119] = TAIL_BYTE_1;
+    w = mContext.bitCount[0];
+    mContext.block[120] = ( byte )( w );
+    mContext.block[121] = ( byte )( w >>  8 );
+    mContext.block[122] = ( byte )( w >> 16 );
+    mContext.block[123] = ( byte )( w >> 24 );
+    w = mContext.bitCount[1];
+    mContext.block[124] = ( byte )( w );
+    mContext.block[125] = ( byte )( w >>  8 );
+    mContext.block[126] = ( byte )( w >> 16 );
+    mContext.block[127] = ( byte )( w >> 24 );
+    haval::Transform< Passes >::apply( mContext.digest, mContext.block );
+
+    haval::Fold< Length >::apply( mContext.digest );
+    return reinterpret_cast< byte* >( mContext.digest );
+}
+
 #endif
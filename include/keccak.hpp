@@ -0,0 +1,53 @@
+#ifndef KECCAK_HPP
+#define KECCAK_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace keccak {
+    /* Implementations of the permutation of several states at once: AVX2 (four states interleaved
+     * in the 64 bit elements of the vectors) or one state after the other in portable C++. */
+    enum Kernel { Portable, Avx2 };
+
+    // The fastest kernel supported by the CPU, selected (and logged) on the first call
+    extern Kernel kernel();
+    extern const char* kernelName( Kernel kernel );
+
+    // Keccak-f[1600] on a single state of 25 lanes
+    void permute( uint64_t state[ 25 ] );
+}
+
+/* SHA3-224, SHA3-256, SHA3-384 and SHA3-512 of the same message, in any combination. The states of the sponges
+ * are stored interleaved lane by lane: whenever the blocks of some of them (their rates differ) are full, these
+ * are permuted together, so that all four digests cost about as much as the one with the smallest rate. */
+class Sha3Set {
+    public:
+        static const std::size_t MAX_SPONGES = 4;
+
+        Sha3Set();
+
+        // Adds a sponge with a digest of 28, 32, 48 or 64 bytes, returning its index
+        std::size_t add( std::size_t digestLength );
+
+        void write( const byte* data, std::size_t length );
+
+        // Pads the message and squeezes the digests of all the sponges, which are then reset
+        void final();
+        const byte* digest( std::size_t sponge ) const { return mDigests[ sponge ]; }
+
+    private:
+        void absorb( std::size_t sponge, const byte* data, std::size_t length );
+        void absorbByte( std::size_t sponge, std::size_t offset, byte value );
+        void permute( unsigned int sponges );
+        void reset();
+
+        uint64_t mStates[ 25 ][ MAX_SPONGES ];
+        std::size_t mCount;
+        std::size_t mRates[ MAX_SPONGES ];
+        std::size_t mLengths[ MAX_SPONGES ];
+        std::size_t mOffsets[ MAX_SPONGES ];
+        byte mDigests[ MAX_SPONGES ][ 64 ];
+};
+
+#endif // KECCAK_HPP
@@ -6,6 +6,8 @@
 
 #include <memory>
 
+#include "algorithms.hpp"
+#include "batchdialog.hpp"
 #include "filehashcalculator.hpp"
 
 #include "ui_mainwindow.h"
@@ -30,19 +32,27 @@ class MainWindow : public QMainWindow, private Ui::MainWindow {
         void on_closeButton_clicked();
         void on_base64button_clicked();
 
-        void on_newHashString( int index, QByteArray hash );
-        void on_newChecksumValue( int index, quint64 value );
+        void on_algorithmToggled();
+
+        void on_newHashString( int id, QByteArray hash );
+        void on_newChecksumValue( int id, quint64 value );
         void on_progressUpdate( float progress );
+        void on_failed( QString error );
         void on_finished();
         void on_pauseButton_clicked();
 
     private:
         QSettings mSettings;
-        QList< QLineEdit* > mHashEdits;
+        QMap< algorithms::Id, QLineEdit* > mHashEdits;
+        QMap< algorithms::Id, QCheckBox* > mAlgorithmChecks;
         QMap< QLineEdit*, QString > mHashCache;
         std::unique_ptr< FileHashCalculator > mHashCalculator;
+        std::unique_ptr< BatchDialog > mBatchDialog;
 
+        void addAlgorithm( algorithms::Id id, QCheckBox* check, QLineEdit* edit );
+        algorithms::Set selectedAlgorithms() const;
         void openFile( QString filePath );
+        void openFiles( QStringList filePaths );
         void readFileInfo( QString filePath );
         void calculateHashes( QByteArray content, bool show_uppercase );
         void calculateFileHashes( QString fileName );
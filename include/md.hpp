@@ -0,0 +1,50 @@
+#ifndef MD_HPP
+#define MD_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace md {
+    // The MD4 and MD5 compression functions on count consecutive 64 byte blocks
+    void compress4( uint32_t state[ 4 ], const byte* blocks, std::size_t count );
+    void compress5( uint32_t state[ 4 ], const byte* blocks, std::size_t count );
+
+    // The initial state of both
+    extern const uint32_t IV[ 4 ];
+
+    /* Buffering and padding shared by MD4 and MD5: blocks of 16 little endian words,
+     * with the bit length of the message at the end of the last one. */
+    class BlockHash : public HashAlgorithm {
+        public:
+            typedef void ( *Compress )( uint32_t state[ 4 ], const byte* blocks, std::size_t count );
+
+            void init() override;
+            void write( const byte* inbuf, int inlen ) override;
+            byte* final() override;
+            unsigned int hash_length() const override { return 16; }
+
+        protected:
+            explicit BlockHash( Compress compress ) : mCompress( compress ) { init(); }
+
+        private:
+            const Compress mCompress;
+            uint32_t mState[ 4 ];
+            byte mBlock[ 64 ];
+            std::size_t mOccupied;
+            uint64_t mLength;
+            byte mDigest[ 16 ];
+    };
+}
+
+class Md4 : public md::BlockHash {
+    public:
+        Md4() : BlockHash( md::compress4 ) {}
+};
+
+class Md5 : public md::BlockHash {
+    public:
+        Md5() : BlockHash( md::compress5 ) {}
+};
+
+#endif // MD_HPP
@@ -0,0 +1,55 @@
+#ifndef MULTIBUFFER_HPP
+#define MULTIBUFFER_HPP
+
+#include <QByteArray>
+
+#include <cstddef>
+
+#include "algorithms.hpp"
+#include "hashalgorithm.hpp"
+
+namespace multibuffer {
+    /* Implementations of the lane-parallel compression functions: AVX2 (the same word of the
+     * eight messages in the 32 bit elements of a vector) or one message after the other. */
+    enum Kernel { Portable, Avx2 };
+
+    // The fastest kernel supported by the CPU, selected (and logged) on the first call
+    extern Kernel kernel();
+    extern const char* kernelName( Kernel kernel );
+
+    static const std::size_t LANES = 8;
+
+    /* MD4, MD5 or SHA-1 of up to LANES independent messages (e.g. different files), whose chaining states are
+     * stored word by word. Every call to compress() advances all the active lanes by the same number of blocks,
+     * each read from its own buffer; a lane is padded and finalized on its own, and can then start a new message. */
+    class Lanes {
+        public:
+            explicit Lanes( algorithms::Id id );
+
+            // Whether the algorithm has a lane-parallel implementation
+            static bool supports( algorithms::Id id );
+
+            algorithms::Id id() const { return mId; }
+
+            void reset( std::size_t lane );
+
+            // active is a bitmask of the lanes to be updated; blocks of the other lanes are ignored
+            void compress( const byte* const blocks[ LANES ], unsigned int active, std::size_t count );
+
+            // Pads the message of the lane, length bytes long, whose last tailLength bytes (less than a block) are in tail
+            QByteArray final( std::size_t lane, const byte* tail, std::size_t tailLength, uint64_t length );
+
+        private:
+            typedef void ( *Compress )( uint32_t* state, const byte* blocks, std::size_t count );
+
+            void compressLane( std::size_t lane, const byte* blocks, std::size_t count );
+
+            const algorithms::Id mId;
+            const std::size_t mStateWords;
+            const Compress mCompress;
+            const bool mVectorized;
+            uint32_t mStates[ 5 ][ LANES ];
+    };
+}
+
+#endif // MULTIBUFFER_HPP
@@ -9,13 +9,16 @@ class HashAlgorithm;
 
 class QExtraHash {
     public:
-        enum Algorithm { HAVAL128, HAVAL160, HAVAL192, HAVAL224, HAVAL256 };
+        enum Algorithm { HAVAL128, HAVAL160, HAVAL192, HAVAL224, HAVAL256, // 5 passes
+                         HAVAL3_128, HAVAL3_160, HAVAL3_192, HAVAL3_224, HAVAL3_256,
+                         HAVAL4_128, HAVAL4_160, HAVAL4_192, HAVAL4_224, HAVAL4_256 };
 
         explicit QExtraHash( Algorithm method );
         ~QExtraHash();
 
         void reset();
 
+        void addData( const char* data, int length );
         void addData( const QByteArray &data );
 
         QByteArray result() const;
@@ -0,0 +1,30 @@
+#ifndef RIPEMD160_HPP
+#define RIPEMD160_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace ripemd160 {
+    // The RIPEMD-160 compression function (both lines) on count consecutive 64 byte blocks
+    void compress( uint32_t state[ 5 ], const byte* blocks, std::size_t count );
+}
+
+class Ripemd160 : public HashAlgorithm {
+    public:
+        Ripemd160() { init(); }
+
+        void init() override;
+        void write( const byte* inbuf, int inlen ) override;
+        byte* final() override;
+        unsigned int hash_length() const override { return 20; }
+
+    private:
+        uint32_t mState[ 5 ];
+        byte mBlock[ 64 ];
+        std::size_t mOccupied;
+        uint64_t mLength;
+        byte mDigest[ 20 ];
+};
+
+#endif // RIPEMD160_HPP
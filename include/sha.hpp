@@ -0,0 +1,128 @@
+#ifndef SHA_HPP
+#define SHA_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace sha {
+    /* Implementations of the SHA-1 and SHA-256 compression functions: the Intel SHA extensions,
+     * AVX2 (message schedule of two blocks at a time, rounds in scalar code) and portable C++.
+     * SHA-512 has only the portable implementation; AVX-512 is used only by the two-lane functions. */
+    enum Kernel { Portable, Avx2, Avx512, Extensions };
+
+    // The fastest kernel supported by the CPU, selected (and logged) on the first call
+    extern Kernel kernel();
+    // The kernel of the two-lane SHA-2 rounds (when the SHA extensions do not handle them): AVX-512 or portable
+    extern Kernel lanesKernel();
+    /* The kernel of compress256x2(), which depends on both: the SHA extensions compress the lanes one after the
+     * other, AVX-512 side by side; the kernel of compress512x2() is lanesKernel() */
+    extern Kernel kernel256x2();
+    extern const char* kernelName( Kernel kernel );
+
+    void compress1( uint32_t* state, const byte* blocks, std::size_t count );
+    void compress256( uint32_t* state, const byte* blocks, std::size_t count );
+    void compress512( uint64_t* state, const byte* blocks, std::size_t count );
+
+    /* Two chaining states (stored one after the other) updated over the same blocks, as SHA-224 and SHA-256
+     * (or SHA-384 and SHA-512) do: the message is loaded and scheduled only once for both. */
+    void compress256x2( uint32_t* states, const byte* blocks, std::size_t count );
+    void compress512x2( uint64_t* states, const byte* blocks, std::size_t count );
+
+    /* Buffering and padding of the SHA family: blocks of 16 big endian words, with the bit length of the message
+     * at the end of the last one. Lanes (one or two) chaining states of StateWords words are updated together. */
+    template< typename Word, std::size_t StateWords, std::size_t Lanes = 1 >
+    class Engine {
+        public:
+            typedef void ( *Compress )( Word* states, const byte* blocks, std::size_t count );
+
+            Engine( Compress compress, const Word* firstIv, const Word* secondIv = nullptr );
+
+            void reset();
+            void write( const byte* data, std::size_t length );
+
+            // Writes the first words of the final state of a lane (big endian) and resets the engine
+            void final( byte* digest, std::size_t digestWords, byte* secondDigest = nullptr, std::size_t secondWords = 0 );
+
+        private:
+            static const std::size_t BLOCK_SIZE = 16 * sizeof( Word );
+
+            const Compress mCompress;
+            const Word* mIvs[ Lanes ];
+            Word mStates[ Lanes * StateWords ];
+            byte mBlock[ BLOCK_SIZE ];
+            std::size_t mOccupied;
+            uint64_t mLength;
+    };
+
+    // StateWords is the size of the chaining state, DigestWords of the (possibly truncated) output
+    template< typename Word, std::size_t StateWords, std::size_t DigestWords >
+    class BlockHash : public HashAlgorithm {
+        public:
+            void init() override { mEngine.reset(); }
+            void write( const byte* inbuf, int inlen ) override { mEngine.write( inbuf, inlen ); }
+            byte* final() override {
+                mEngine.final( mDigest, DigestWords );
+                return mDigest;
+            }
+            unsigned int hash_length() const override { return DigestWords * sizeof( Word ); }
+
+        protected:
+            BlockHash( typename Engine< Word, StateWords >::Compress compress, const Word* iv ) : mEngine( compress, iv ) {}
+
+        private:
+            Engine< Word, StateWords > mEngine;
+            byte mDigest[ DigestWords * sizeof( Word ) ];
+    };
+}
+
+class Sha1 : public sha::BlockHash< uint32_t, 5, 5 > {
+    public:
+        Sha1();
+};
+
+class Sha224 : public sha::BlockHash< uint32_t, 8, 7 > {
+    public:
+        Sha224();
+};
+
+class Sha256 : public sha::BlockHash< uint32_t, 8, 8 > {
+    public:
+        Sha256();
+};
+
+class Sha384 : public sha::BlockHash< uint64_t, 8, 6 > {
+    public:
+        Sha384();
+};
+
+class Sha512 : public sha::BlockHash< uint64_t, 8, 8 > {
+    public:
+        Sha512();
+};
+
+/* SHA-224 and SHA-256 of the same message, for little more than the cost of one of them */
+class Sha224And256 {
+    public:
+        Sha224And256();
+
+        void write( const byte* data, std::size_t length ) { mEngine.write( data, length ); }
+        void final( byte sha224[ 28 ], byte sha256[ 32 ] ) { mEngine.final( sha224, 7, sha256, 8 ); }
+
+    private:
+        sha::Engine< uint32_t, 8, 2 > mEngine;
+};
+
+/* SHA-384 and SHA-512 of the same message, for little more than the cost of one of them */
+class Sha384And512 {
+    public:
+        Sha384And512();
+
+        void write( const byte* data, std::size_t length ) { mEngine.write( data, length ); }
+        void final( byte sha384[ 48 ], byte sha512[ 64 ] ) { mEngine.final( sha384, 6, sha512, 8 ); }
+
+    private:
+        sha::Engine< uint64_t, 8, 2 > mEngine;
+};
+
+#endif // SHA_HPP
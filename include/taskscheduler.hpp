@@ -0,0 +1,64 @@
+#ifndef TASKSCHEDULER_HPP
+#define TASKSCHEDULER_HPP
+
+#include <QMutex>
+#include <QWaitCondition>
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/* Pool of worker threads, one per core, shared by all the calculations. Every worker has its own queue of tasks:
+ * it runs the newest one first (its data is likely still in the cache) and, when its queue is empty, it steals
+ * the oldest task of another worker, so that the cores left idle by a calculation take over the work of the others.
+ * The sequential reads are left to the threads of the calculators: only the ranges of the checksums are read by
+ * the tasks that hash them. */
+class TaskScheduler {
+    public:
+        typedef std::function< void() > Task;
+
+        /* Tasks waited for together: while waiting, the calling thread runs queued tasks instead of sleeping,
+         * so that a task can wait for the tasks it submitted without ever blocking a worker. */
+        class Group {
+            public:
+                explicit Group( TaskScheduler& scheduler );
+                ~Group(); //waits for the tasks
+
+                void run( Task task );
+                void wait();
+                bool wait( int pending, unsigned long time ); //until no more than pending tasks are left, or for time ms
+                int pending() const;
+
+            private:
+                TaskScheduler& mScheduler;
+                std::atomic< int > mPending;
+                QMutex mMutex;
+                QWaitCondition mTaskDone;
+        };
+
+        explicit TaskScheduler( int workerCount );
+        ~TaskScheduler();
+
+        static TaskScheduler& instance(); //a worker for each core
+
+        int workerCount() const;
+        void submit( Task task );
+
+    private:
+        class Worker;
+
+        bool runOne(); //runs a queued task on the calling thread, false if there are none
+        bool take( int worker, Task& task );
+        void work( int worker ); //the loop of a worker thread
+
+        std::vector< std::unique_ptr< Worker > > mWorkers;
+        std::deque< Task > mInjected; //tasks submitted from outside the workers
+        std::atomic< int > mQueued; //tasks in all the queues
+        std::atomic< bool > mQuit;
+        QMutex mMutex; //locked when accessing mInjected, and by the workers going to sleep
+        QWaitCondition mTaskQueued;
+};
+
+#endif // TASKSCHEDULER_HPP
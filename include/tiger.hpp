@@ -0,0 +1,31 @@
+#ifndef TIGER_HPP
+#define TIGER_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace tiger {
+    // The Tiger compression function (three passes) on count consecutive 64 byte blocks
+    void compress( uint64_t state[ 3 ], const byte* blocks, std::size_t count );
+}
+
+/* Tiger with the 192 bit output and the original padding */
+class Tiger : public HashAlgorithm {
+    public:
+        Tiger() { init(); }
+
+        void init() override;
+        void write( const byte* inbuf, int inlen ) override;
+        byte* final() override;
+        unsigned int hash_length() const override { return 24; }
+
+    private:
+        uint64_t mState[ 3 ];
+        byte mBlock[ 64 ];
+        std::size_t mOccupied;
+        uint64_t mLength;
+        byte mDigest[ 24 ];
+};
+
+#endif // TIGER_HPP
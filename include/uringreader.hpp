@@ -0,0 +1,36 @@
+#ifndef URINGREADER_HPP
+#define URINGREADER_HPP
+
+#include <QtGlobal>
+
+#include <memory>
+#include <vector>
+
+/* Reads of a file submitted to io_uring (Linux 5.1 and later), so that many large reads are in flight at once
+ * and fast drives or network filesystems are not limited by the latency of each one. The reads go in the buffers
+ * registered with registerBuffers() when possible, so that the kernel does not map them again for every read.
+ * Where io_uring is not available (other systems, older kernels, seccomp filters), isValid() is false and the
+ * file must be read otherwise. */
+class UringReader {
+    public:
+        UringReader( int fd, int depth );
+        ~UringReader(); //waits for the reads still in flight
+
+        bool isValid() const;
+        static bool isSupported(); //by the running kernel
+        void registerBuffers( const std::vector< char* >& buffers, int length );
+
+        bool submit( int buffer, qint64 offset, int length ); //into the buffer with that index
+        bool wait( int& buffer, int& result ); //the next read completed: its length, or -errno
+
+    private:
+        struct Ring;
+
+        const int mFd;
+        std::unique_ptr< Ring > mRing;
+        std::vector< char* > mBuffers;
+        bool mRegistered;
+        int mInFlight;
+};
+
+#endif // URINGREADER_HPP
@@ -0,0 +1,44 @@
+#ifndef XXH3_HPP
+#define XXH3_HPP
+
+#include <cstddef>
+
+#include "hashalgorithm.hpp"
+
+namespace xxh3 {
+    /* Implementations of the accumulation of the 64 byte stripes: AVX2 (the eight 64 bit accumulators in two
+     * vectors), SSE2 (in four) or portable C++. */
+    enum Kernel { Portable, Sse2, Avx2 };
+
+    // The fastest kernel supported by the CPU, selected (and logged) on the first call
+    extern Kernel kernel();
+    extern const char* kernelName( Kernel kernel );
+
+    /* Streaming XXH3 with the default secret and seed: the 64 and 128 bit variants accumulate long inputs in the
+     * same way and differ only in the finalization, so a single state gives both. Inputs of up to 240 bytes
+     * are hashed at the end from the buffer, with the dedicated short-input functions. */
+    class State {
+        public:
+            State() { reset(); }
+
+            void reset();
+            void update( const byte* data, std::size_t length );
+
+            uint64_t digest64() const;
+            void digest128( uint64_t& low, uint64_t& high ) const;
+
+        private:
+            static const std::size_t BUFFER_SIZE = 256;
+
+            void consumeStripes( const byte* input, std::size_t count, uint64_t* acc, std::size_t& stripesSoFar ) const;
+            void digestLong( uint64_t acc[ 8 ] ) const;
+
+            uint64_t mAcc[ 8 ];
+            byte mBuffer[ BUFFER_SIZE ];
+            std::size_t mBufferedSize;
+            std::size_t mStripesSoFar; //in the current block
+            uint64_t mTotalLength;
+    };
+}
+
+#endif // XXH3_HPP
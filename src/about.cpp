@@ -18,6 +18,10 @@ A copy of the GNU General Public License is available at
 #include <QStyle>
 
 #include "about.hpp"
+#include "blake3.hpp"
+#include "multibuffer.hpp"
+#include "sha.hpp"
+#include "xxh3.hpp"
 
 About::About( QWidget* parent ) : QDialog( parent ) {
     setupUi( this );
@@ -26,6 +30,13 @@ About::About( QWidget* parent ) : QDialog( parent ) {
                                       qApp->desktop()->availableGeometry() ) );
     tabWidget->setCurrentIndex( 0 );
     versionLabel->setText( QString( "v%1.%2.%3" ).arg( MAJOR_VER ).arg( MINOR_VER ).arg( PATCH_VER ) );
+    kernelLabel->setText( tr( "SHA-1/SHA-256 kernel: %1, SHA-224+256 kernel: %2, SHA-384+512 kernel: %3, BLAKE3 kernel: %4, XXH3 kernel: %5, multi-buffer kernel: %6" )
+                              .arg( QLatin1String( sha::kernelName( sha::kernel() ) ) )
+                              .arg( QLatin1String( sha::kernelName( sha::kernel256x2() ) ) )
+                              .arg( QLatin1String( sha::kernelName( sha::lanesKernel() ) ) )
+                              .arg( QLatin1String( blake3::kernelName( blake3::kernel() ) ) )
+                              .arg( QLatin1String( xxh3::kernelName( xxh3::kernel() ) ) )
+                              .arg( QLatin1String( multibuffer::kernelName( multibuffer::kernel() ) ) ) );
 }
 
 About::~About() {}
@@ -0,0 +1,86 @@
+#include "algorithms.hpp"
+
+namespace {
+    // Indexed by algorithms::Id, the names are used in the settings file
+    const char* const ALGORITHM_NAMES[ algorithms::Count ] = {
+        "crc16", "crc32", "crc64",
+        "md4", "md5", "sha1",
+        "sha224", "sha256", "sha384", "sha512",
+        "sha3-224", "sha3-256", "sha3-384", "sha3-512",
+        "tiger", "ripemd160",
+        "haval128", "haval160", "haval192", "haval224", "haval256",
+        "crc32c",
+        "blake3",
+        "xxh3-64", "xxh3-128"
+    };
+}
+
+QString algorithms::name( Id id ) {
+    return QString::fromLatin1( ALGORITHM_NAMES[ id ] );
+}
+
+bool algorithms::fromName( const QString& name, Id& id ) {
+    for ( int i = 0; i < Count; ++i ) {
+        if ( name.compare( QLatin1String( ALGORITHM_NAMES[ i ] ), Qt::CaseInsensitive ) == 0 ) {
+            id = static_cast< Id >( i );
+            return true;
+        }
+    }
+    return false;
+}
+
+bool algorithms::isChecksum( Id id ) {
+    return id == CRC16 || id == CRC32 || id == CRC64 || id == CRC32C;
+}
+
+algorithms::Group algorithms::group( Id id ) {
+    switch ( id ) {
+        case CRC16:
+        case CRC32:
+        case CRC64:
+        case CRC32C:
+            return Checksums;
+        case SHA224:
+        case SHA256:
+        case SHA384:
+        case SHA512:
+            return Sha2;
+        case SHA3_224:
+        case SHA3_256:
+        case SHA3_384:
+        case SHA3_512:
+            return Sha3;
+        case HAVAL128:
+        case HAVAL160:
+        case HAVAL192:
+        case HAVAL224:
+        case HAVAL256:
+            return Haval;
+        case BLAKE3:
+            return Blake;
+        case XXH3_64:
+        case XXH3_128:
+            return Xxh3;
+        default:
+            return Legacy; // MD4, MD5, SHA1, Tiger and RIPEMD-160
+    }
+}
+
+QStringList algorithms::toNames( const Set& set ) {
+    QStringList names;
+    foreach ( Id id, set.toList() ) {
+        names << name( id );
+    }
+    return names;
+}
+
+algorithms::Set algorithms::fromNames( const QStringList& names ) {
+    Set set;
+    Id id;
+    foreach ( const QString& name, names ) {
+        if ( fromName( name, id ) ) {
+            set.insert( id );
+        }
+    }
+    return set;
+}
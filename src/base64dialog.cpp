@@ -26,8 +26,7 @@ void Base64Dialog::on_complete( QByteArray base64 ) {
 void Base64Dialog::closeEvent( QCloseEvent* event ) {
     if ( mBase64Calculator != nullptr && mBase64Calculator->isRunning() ) {
         event->ignore();
-        mBase64Calculator->requestInterruption();
-        mBase64Calculator->wait();
+        mBase64Calculator->stop();
         event->accept();
     }
 }
@@ -0,0 +1,319 @@
+#include "batchdialog.hpp"
+
+#include <QCloseEvent>
+#include <QDesktopWidget>
+#include <QDir>
+#include <QFileDialog>
+#include <QHeaderView>
+#include <QMessageBox>
+#include <QPair>
+#include <QProgressBar>
+#include <QStyle>
+
+#include <algorithm>
+
+#include "checksumfile.hpp"
+#include "util.hpp"
+
+BatchDialog::BatchDialog( QWidget* parent, algorithms::Set selected, bool useUppercase )
+    : QDialog( parent ), mUseUppercase( useUppercase ), mQueue( new BatchQueue( this, selected ) ),
+      mHashed( 0 ), mFailed( 0 ) {
+    setupUi( this );
+
+    setWindowFlags( Qt::Window );
+    setGeometry( QStyle::alignedRect( Qt::LeftToRight, Qt::AlignCenter, size(),
+                                      qApp->desktop()->availableGeometry() ) );
+
+    QStringList labels;
+    labels << tr( "File" ) << tr( "Status" );
+    foreach ( algorithms::Id id, selected.toList() ) {
+        mHashColumns.insert( id, labels.size() );
+        labels << algorithms::name( id ).toUpper();
+    }
+    resultsTable->setColumnCount( labels.size() );
+    resultsTable->setHorizontalHeaderLabels( labels );
+    resultsTable->horizontalHeader()->resizeSection( FileColumn, 240 );
+
+    connect( mQueue.get(), SIGNAL( fileStarted( int ) ), this, SLOT( on_fileStarted( int ) ) );
+    connect( mQueue.get(), SIGNAL( newHashString( int, int, QByteArray ) ), this, SLOT( on_newHashString( int, int, QByteArray ) ) );
+    connect( mQueue.get(), SIGNAL( newChecksumValue( int, int, quint64 ) ), this, SLOT( on_newChecksumValue( int, int, quint64 ) ) );
+    connect( mQueue.get(), SIGNAL( progressUpdate( int, float ) ), this, SLOT( on_progressUpdate( int, float ) ) );
+    connect( mQueue.get(), SIGNAL( fileFailed( int, QString ) ), this, SLOT( on_fileFailed( int, QString ) ) );
+    connect( mQueue.get(), SIGNAL( fileEnded( int ) ), this, SLOT( on_fileEnded( int ) ) );
+    connect( mQueue.get(), SIGNAL( finished() ), this, SLOT( on_finished() ) );
+}
+
+BatchDialog::~BatchDialog() {}
+
+void BatchDialog::enqueue( const QStringList& paths, bool cacheNeutral ) {
+    QStringList directories;
+    foreach ( const QString& path, paths ) {
+        if ( QFileInfo( path ).isDir() ) {
+            directories << path;
+        } else {
+            addFile( path, QString(), cacheNeutral );
+        }
+    }
+    if ( !directories.isEmpty() ) {
+        DirectoryWalker* walker = new DirectoryWalker( this, directories );
+        mWalkers.emplace_back( walker );
+        if ( cacheNeutral ) {
+            mCacheNeutralWalkers.insert( walker );
+        }
+        connect( walker, SIGNAL( filesFound( QStringList, QStringList ) ), this, SLOT( on_filesFound( QStringList, QStringList ) ) );
+        connect( walker, SIGNAL( directoryFailed( QString, QString ) ), this, SLOT( on_directoryFailed( QString, QString ) ) );
+        connect( walker, SIGNAL( finished() ), this, SLOT( on_walkerFinished() ) );
+        walker->start();
+    }
+    updateControls();
+}
+
+bool BatchDialog::isRunning() const {
+    return mQueue->isRunning() || isSearching();
+}
+
+void BatchDialog::on_filesFound( QStringList files, QStringList identities ) {
+    bool cacheNeutral = mCacheNeutralWalkers.contains( sender() );
+    for ( int i = 0; i < files.size(); ++i ) {
+        addFile( files.at( i ), identities.at( i ), cacheNeutral );
+    }
+    updateControls();
+}
+
+void BatchDialog::on_directoryFailed( QString directory, QString error ) {
+    mDirectoryErrors << QDir::toNativeSeparators( directory ) + ": " + error;
+}
+
+void BatchDialog::on_walkerFinished() {
+    updateControls();
+}
+
+void BatchDialog::on_fileStarted( int file ) {
+    QProgressBar* progressBar = new QProgressBar( resultsTable );
+    progressBar->setRange( 0, 100 );
+    resultsTable->item( file, StatusColumn )->setText( "" );
+    resultsTable->setCellWidget( file, StatusColumn, progressBar );
+    updateControls();
+}
+
+void BatchDialog::on_newHashString( int file, int id, QByteArray hash ) {
+    setHash( file, id, util::hash_hex( hash, false ), util::hash_hex( hash, mUseUppercase ) );
+}
+
+void BatchDialog::on_newChecksumValue( int file, int id, quint64 value ) {
+    algorithms::Id checksum = static_cast< algorithms::Id >( id );
+    setHash( file, id, checksumfile::checksumText( checksum, value ), util::checksum_hex( value, mUseUppercase ) );
+}
+
+void BatchDialog::on_progressUpdate( int file, float progress ) {
+    QProgressBar* progressBar = qobject_cast< QProgressBar* >( resultsTable->cellWidget( file, StatusColumn ) );
+    if ( progressBar != nullptr ) {
+        progressBar->setValue( progress * 100 );
+    }
+}
+
+void BatchDialog::on_fileFailed( int file, QString error ) {
+    mErrors.insert( file, error );
+}
+
+void BatchDialog::on_fileEnded( int file ) {
+    resultsTable->removeCellWidget( file, StatusColumn );
+    int original = mQueue->original( file );
+    switch ( mQueue->state( file ) ) {
+        case BatchQueue::Hashed:
+            ++mHashed;
+            setStatus( file, tr( "Hashed" ) );
+            if ( original >= 0 ) { //another name of a file already read
+                for ( int column = FirstHashColumn; column < resultsTable->columnCount(); ++column ) {
+                    resultsTable->item( file, column )->setText( resultsTable->item( original, column )->text() );
+                }
+                mHashes.insert( file, mHashes.value( original ) );
+                resultsTable->item( file, StatusColumn )->setToolTip( tr( "Same file as %1" )
+                                                                      .arg( resultsTable->item( original, FileColumn )->text() ) );
+            }
+            break;
+        case BatchQueue::Failed:
+            ++mFailed;
+            setStatus( file, mErrors.value( original >= 0 ? original : file ) );
+            break;
+        default:
+            setStatus( file, tr( "Cancelled" ) );
+            mHashes.remove( file );
+            for ( int column = FirstHashColumn; column < resultsTable->columnCount(); ++column ) {
+                resultsTable->item( file, column )->setText( "" ); //partial results of a stopped file
+            }
+    }
+    updateControls();
+}
+
+void BatchDialog::on_finished() {
+    updateControls();
+}
+
+void BatchDialog::on_resultsTable_itemSelectionChanged() {
+    updateControls();
+}
+
+void BatchDialog::on_pauseButton_clicked() {
+    QList< int > files = selectedFiles();
+    bool resume = true; //resumes the selection only if none of it is running
+    foreach ( int file, files ) {
+        resume = resume && mQueue->state( file ) != BatchQueue::Running;
+    }
+    foreach ( int file, files ) {
+        QProgressBar* progressBar = qobject_cast< QProgressBar* >( resultsTable->cellWidget( file, StatusColumn ) );
+        if ( resume && mQueue->state( file ) == BatchQueue::Paused ) {
+            mQueue->resume( file );
+            progressBar->resetFormat();
+        } else if ( !resume && mQueue->state( file ) == BatchQueue::Running ) {
+            mQueue->pause( file );
+            progressBar->setFormat( tr( "Suspended (%p%)" ) );
+        }
+    }
+    updateControls();
+}
+
+void BatchDialog::on_cancelButton_clicked() {
+    foreach ( int file, selectedFiles() ) {
+        mQueue->cancel( file );
+    }
+}
+
+void BatchDialog::on_cancelAllButton_clicked() {
+    cancelAll();
+}
+
+void BatchDialog::on_saveButton_clicked() {
+    QString listName = QFileDialog::getSaveFileName( this, tr( "Save the hashes" ), QString(),
+                                                     tr( "Checksum lists (*SUMS *.sfv *.txt);;All files (*)" ) );
+    if ( listName.isEmpty() ) {
+        return;
+    }
+
+    /* the names are relative to the directory of the list, as expected when verifying it,
+     * and sorted, so that the same files always give the same list */
+    QDir directory = QFileInfo( listName ).absoluteDir();
+    QList< QPair< QString, int > > names;
+    for ( QMap< int, QMap< int, QString > >::const_iterator it = mHashes.constBegin(); it != mHashes.constEnd(); ++it ) {
+        if ( mQueue->state( it.key() ) == BatchQueue::Hashed ) {
+            QString path = QFileInfo( mQueue->fileName( it.key() ) ).absoluteFilePath();
+            names << qMakePair( directory.relativeFilePath( path ), it.key() );
+        }
+    }
+    std::sort( names.begin(), names.end() );
+
+    QFile list( listName );
+    bool tagged = mHashColumns.size() > 1;
+    bool written = list.open( QFile::WriteOnly | QFile::Truncate );
+    for ( int i = 0; written && i < names.size(); ++i ) {
+        const QMap< int, QString >& hashes = mHashes[ names.at( i ).second ];
+        for ( QMap< int, QString >::const_iterator it = hashes.constBegin(); written && it != hashes.constEnd(); ++it ) {
+            QString line = checksumfile::line( names.at( i ).first, static_cast< algorithms::Id >( it.key() ), it.value(), tagged );
+            written = list.write( line.toUtf8() + '\n' ) >= 0;
+        }
+    }
+    if ( !written ) {
+        QMessageBox::warning( this, tr( "Save the hashes" ), list.errorString() );
+    }
+}
+
+void BatchDialog::addFile( const QString& fileName, const QString& identity, bool cacheNeutral ) {
+    int row = resultsTable->rowCount();
+    resultsTable->insertRow( row );
+    QTableWidgetItem* fileItem = new QTableWidgetItem( QDir::toNativeSeparators( fileName ) );
+    fileItem->setToolTip( fileItem->text() );
+    resultsTable->setItem( row, FileColumn, fileItem );
+    resultsTable->setItem( row, StatusColumn, new QTableWidgetItem( tr( "Queued" ) ) );
+    for ( int column = FirstHashColumn; column < resultsTable->columnCount(); ++column ) {
+        resultsTable->setItem( row, column, new QTableWidgetItem() );
+    }
+    mQueue->enqueue( fileName, identity, cacheNeutral ); //rows and files have the same indices
+}
+
+void BatchDialog::cancelAll() {
+    for ( const std::unique_ptr< DirectoryWalker >& walker : mWalkers ) {
+        walker->stop();
+    }
+    mQueue->cancelAll();
+    updateControls();
+}
+
+bool BatchDialog::isSearching() const {
+    for ( const std::unique_ptr< DirectoryWalker >& walker : mWalkers ) {
+        if ( walker->isRunning() ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QList< int > BatchDialog::selectedFiles() const {
+    QList< int > files;
+    foreach ( const QModelIndex& index, resultsTable->selectionModel()->selectedRows() ) {
+        files << index.row();
+    }
+    return files;
+}
+
+void BatchDialog::setStatus( int file, const QString& status ) {
+    QTableWidgetItem* statusItem = resultsTable->item( file, StatusColumn );
+    statusItem->setText( status );
+    statusItem->setToolTip( status );
+}
+
+void BatchDialog::setHash( int file, int id, const QString& hash, const QString& text ) {
+    mHashes[ file ].insert( id, hash );
+    QTableWidgetItem* hashItem = resultsTable->item( file, mHashColumns.value( id ) );
+    hashItem->setText( text );
+    hashItem->setToolTip( text );
+}
+
+void BatchDialog::updateControls() {
+    bool anyRunning = false;
+    bool anyPaused = false;
+    bool anyQueued = false;
+    foreach ( int file, selectedFiles() ) {
+        anyRunning = anyRunning || mQueue->state( file ) == BatchQueue::Running;
+        anyPaused = anyPaused || mQueue->state( file ) == BatchQueue::Paused;
+        anyQueued = anyQueued || mQueue->state( file ) == BatchQueue::Queued;
+    }
+    pauseButton->setEnabled( anyRunning || anyPaused );
+    pauseButton->setText( anyPaused && !anyRunning ? tr( "Resume" ) : tr( "Pause" ) );
+    cancelButton->setEnabled( anyRunning || anyPaused || anyQueued );
+    cancelAllButton->setEnabled( isRunning() );
+    saveButton->setEnabled( !isRunning() && mHashed > 0 );
+
+    QString status = tr( "%1 of %2 files hashed" ).arg( mHashed ).arg( mQueue->count() );
+    if ( mFailed > 0 ) {
+        status += ", " + tr( "%n failed", "", mFailed );
+    }
+    if ( !mDirectoryErrors.isEmpty() ) {
+        status += ", " + tr( "%n folder(s) could not be read", "", mDirectoryErrors.size() );
+    }
+    if ( isSearching() ) {
+        status += ", " + tr( "searching for more..." );
+    } else if ( mQueue->isRunning() ) {
+        status += ", " + tr( "up to %1 at a time" ).arg( mQueue->maxRunning() );
+    }
+    statusLabel->setText( status );
+    statusLabel->setToolTip( mDirectoryErrors.join( "\n" ) );
+}
+
+void BatchDialog::closeEvent( QCloseEvent* event ) {
+    if ( isRunning() ) {
+        QMessageBox closeMsg( QMessageBox::Question,
+                              tr( "Work in progress..." ),
+                              tr( "Some files haven't been hashed yet. Do you really want to cancel them?" ),
+                              QMessageBox::Yes | QMessageBox::No,
+                              this );
+        closeMsg.setButtonText( QMessageBox::Yes, tr( "Yes" ) );
+        closeMsg.setButtonText( QMessageBox::No, tr( "No" ) );
+        closeMsg.exec();
+        if ( closeMsg.result() == QMessageBox::No ) {
+            event->ignore();
+            return;
+        }
+        cancelAll();
+    }
+    event->accept();
+}
@@ -0,0 +1,220 @@
+#include "batchhashcalculator.hpp"
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+#include <limits>
+
+#include "cachedropper.hpp"
+#include "digest.hpp"
+#include "disklayout.hpp"
+#include "multibuffer.hpp"
+
+#define BUFFER_SIZE 512 * 1024 //512 KB for each lane
+#define BLOCK_SIZE 64
+
+using std::vector;
+using std::unique_ptr;
+using multibuffer::LANES;
+
+struct BatchHashCalculator::Lane {
+    Lane() : file( -1 ), offset( 0 ), available( 0 ), length( 0 ), atEnd( false ) {}
+
+    int file; //index in mFileNames, -1 while the lane is idle
+    unique_ptr< QFile > input;
+    unique_ptr< CacheDropper > dropper; //declared after input, which it refers to
+    vector< char > buffer;
+    std::size_t offset; //of the first byte not yet compressed
+    std::size_t available;
+    quint64 length;
+    bool atEnd;
+    QString error;
+    Digests digests; //the algorithms without a multi-buffer implementation
+};
+
+BatchHashCalculator::BatchHashCalculator( QObject* parent, QStringList fileNames, algorithms::Set selected )
+    : QThread( parent ), mFileNames( fileNames ), mAlgorithms( selected ), mCacheNeutral( false ), mTotalSize( 0 ),
+      mHashedSize( 0 ), mIsPaused( false ) {
+}
+
+BatchHashCalculator::~BatchHashCalculator() {}
+
+void BatchHashCalculator::stop() {
+    disconnect();
+    requestInterruption();
+    wait();
+}
+
+void BatchHashCalculator::resume() {
+    mMutex.lock();
+    mIsPaused = false;
+    mMutex.unlock();
+    mPauseCondition.wakeAll();
+}
+
+void BatchHashCalculator::pause() {
+    QMutexLocker locker( &mMutex );
+    mIsPaused = true;
+}
+
+bool BatchHashCalculator::isPaused() {
+    QMutexLocker locker( &mMutex );
+    return mIsPaused;
+}
+
+void BatchHashCalculator::setCacheNeutral( bool cacheNeutral ) {
+    mCacheNeutral = cacheNeutral;
+}
+
+bool BatchHashCalculator::waitForResume() {
+    mMutex.lock();
+    if ( mIsPaused ) {
+        mPauseCondition.wait( &mMutex ); //wait for a call to resume()
+    }
+    mMutex.unlock();
+    return !isInterruptionRequested();
+}
+
+void BatchHashCalculator::run() {
+    mTotalSize = 0;
+    mHashedSize = 0;
+    std::vector< disklayout::Location > locations;
+    foreach ( const QString& fileName, mFileNames ) {
+        mTotalSize += QFileInfo( fileName ).size();
+        locations.push_back( disklayout::locate( fileName ) );
+    }
+    //the files are opened in the order of their blocks on each disk, the results are still emitted by file
+    const std::vector< int > order = disklayout::readingOrder( locations );
+    mLanes.clear();
+    foreach ( algorithms::Id id, mAlgorithms.toList() ) {
+        if ( multibuffer::Lanes::supports( id ) ) {
+            mLanes.emplace_back( new multibuffer::Lanes( id ) );
+        }
+    }
+
+    Lane lanes[ LANES ];
+    int nextFile = 0;
+    while ( waitForResume() ) {
+        /* gives the idle lanes the next files and finalizes the ones whose file has been read completely,
+         * then compresses the blocks available in all the active lanes at once */
+        unsigned int active = 0;
+        const byte* blocks[ LANES ];
+        std::size_t count = std::numeric_limits< std::size_t >::max();
+        for ( std::size_t i = 0; i < LANES; ++i ) {
+            Lane& lane = lanes[ i ];
+            for ( ;; ) {
+                if ( lane.file < 0 ) {
+                    if ( nextFile >= mFileNames.size() ) {
+                        break;
+                    }
+                    if ( !open( i, lane, order[ nextFile++ ] ) ) {
+                        continue;
+                    }
+                }
+                if ( refill( lane ) ) {
+                    break;
+                }
+                finish( i, lane );
+            }
+            if ( lane.file >= 0 ) {
+                active |= 1u << i;
+                blocks[ i ] = reinterpret_cast< const byte* >( lane.buffer.data() + lane.offset );
+                count = qMin( count, lane.available / BLOCK_SIZE );
+            }
+        }
+        if ( active == 0 ) {
+            break;
+        }
+
+        for ( const unique_ptr< multibuffer::Lanes >& multiLanes : mLanes ) {
+            multiLanes->compress( blocks, active, count );
+        }
+        for ( std::size_t i = 0; i < LANES; ++i ) {
+            if ( ( active & ( 1u << i ) ) != 0 ) {
+                lanes[ i ].offset += count * BLOCK_SIZE;
+                lanes[ i ].available -= count * BLOCK_SIZE;
+            }
+        }
+    }
+}
+
+bool BatchHashCalculator::open( std::size_t index, Lane& lane, int file ) {
+    lane.input.reset( new QFile( mFileNames.at( file ) ) );
+    if ( !lane.input->open( QFile::ReadOnly ) ) {
+        emit fileFailed( file, lane.input->errorString() );
+        lane.input.reset();
+        return false;
+    }
+    lane.dropper.reset( new CacheDropper( *lane.input, mCacheNeutral && !CacheDropper::isInUse( *lane.input ) ) );
+    lane.file = file;
+    lane.offset = 0;
+    lane.available = 0;
+    lane.length = 0;
+    lane.atEnd = false;
+    lane.error.clear();
+    lane.buffer.resize( BUFFER_SIZE );
+    algorithms::Set digestAlgorithms = mAlgorithms;
+    for ( const unique_ptr< multibuffer::Lanes >& multiLanes : mLanes ) {
+        // while idle, the lane may have hashed the blocks of another one
+        multiLanes->reset( index );
+        digestAlgorithms.remove( multiLanes->id() );
+    }
+    lane.digests = Digest::create( digestAlgorithms );
+    return true;
+}
+
+bool BatchHashCalculator::refill( Lane& lane ) {
+    while ( lane.available < BLOCK_SIZE && !lane.atEnd ) {
+        // moves the incomplete block at the start of the buffer and appends the next bytes of the file
+        std::memmove( lane.buffer.data(), lane.buffer.data() + lane.offset, lane.available );
+        lane.offset = 0;
+        qint64 length = lane.input->read( lane.buffer.data() + lane.available,
+                                          static_cast< qint64 >( lane.buffer.size() - lane.available ) );
+        if ( length <= 0 ) {
+            if ( length < 0 ) {
+                lane.error = lane.input->errorString();
+            }
+            lane.atEnd = true;
+            break;
+        }
+        for ( const unique_ptr< Digest >& digest : lane.digests ) {
+            digest->addData( lane.buffer.data() + lane.available, static_cast< int >( length ) );
+        }
+        lane.available += static_cast< std::size_t >( length );
+        lane.length += static_cast< quint64 >( length );
+        lane.dropper->advance( static_cast< qint64 >( lane.length ) );
+
+        mHashedSize += static_cast< quint64 >( length );
+        if ( mTotalSize > 0 ) { //zero for pipes and files of /proc
+            emit progressUpdate( ( float )qMin( mHashedSize, mTotalSize ) / mTotalSize );
+        }
+    }
+    return lane.available >= BLOCK_SIZE;
+}
+
+void BatchHashCalculator::finish( std::size_t index, Lane& lane ) {
+    int file = lane.file;
+    lane.file = -1;
+    lane.dropper.reset();
+    lane.input.reset();
+    Digests digests = std::move( lane.digests );
+    if ( !lane.error.isEmpty() ) {
+        emit fileFailed( file, lane.error );
+        return;
+    }
+
+    const byte* tail = reinterpret_cast< const byte* >( lane.buffer.data() + lane.offset );
+    for ( const unique_ptr< multibuffer::Lanes >& multiLanes : mLanes ) {
+        emit newHashString( file, multiLanes->id(), multiLanes->final( index, tail, lane.available, lane.length ) );
+    }
+    for ( const unique_ptr< Digest >& digest : digests ) {
+        foreach ( algorithms::Id id, digest->ids().toList() ) {
+            if ( algorithms::isChecksum( id ) )
+                emit newChecksumValue( file, id, digest->checksum( id ) );
+            else
+                emit newHashString( file, id, digest->result( id ) );
+        }
+    }
+    emit fileHashed( file );
+}
@@ -0,0 +1,284 @@
+#include "batchqueue.hpp"
+
+#include <QThread>
+
+#include "filehashcalculator.hpp"
+
+/* memory that the buffers of the running files can take: with the default buffers it is enough for twice as
+ * many files as the cores of most machines, and it keeps hundreds of dropped files from being read at once */
+#define MEMORY_BUDGET 256 * 1024 * 1024 //256 MB
+#define SCHEDULE_WINDOW 256 //files at the head of the queue of a disk, among which the next one is chosen
+
+BatchQueue::BatchQueue( QObject* parent, algorithms::Set selected )
+    : QObject( parent ), mAlgorithms( selected ),
+      mMaxRunning( static_cast< int >( qBound< qint64 >( 1, ( MEMORY_BUDGET ) / FileHashCalculator::bufferMemory(),
+                                                         2 * qMax( QThread::idealThreadCount(), 1 ) ) ) ),
+      mUnfinished( 0 ) {}
+
+BatchQueue::~BatchQueue() {
+    disconnect(); //the receivers may be already being destroyed
+    cancelAll();
+}
+
+int BatchQueue::enqueue( const QString& fileName, const QString& identity, bool cacheNeutral ) {
+    int file = count();
+    mJobs.push_back( Job( fileName, cacheNeutral ) );
+    ++mUnfinished;
+    int original = identity.isEmpty() ? -1 : mIdentities.value( identity, -1 );
+    if ( original < 0 ) {
+        if ( !identity.isEmpty() ) {
+            mIdentities.insert( identity, file );
+        }
+        mJobs[ file ].location.device = disklayout::device( fileName );
+        mQueues[ mJobs[ file ].location.device ].push_back( file );
+        startNext();
+    } else {
+        mJobs[ file ].original = original;
+        State originalState = mJobs[ original ].state;
+        if ( originalState == Queued || originalState == Running || originalState == Paused ) {
+            mJobs[ original ].links.push_back( file );
+        } else {
+            end( file, originalState );
+        }
+    }
+    return file;
+}
+
+void BatchQueue::pause( int file ) {
+    Job& job = mJobs.at( file );
+    if ( job.state == Running ) {
+        job.calculator->pause();
+        job.state = Paused; //it keeps its buffers, so it still counts as running, but not as a reader of its disk
+        setReading( job, false );
+        startNext();
+    }
+}
+
+void BatchQueue::resume( int file ) {
+    Job& job = mJobs.at( file );
+    if ( job.state == Paused ) {
+        job.state = Running;
+        if ( hasReader( job.location.device ) ) {
+            setReading( job, true );
+            job.calculator->resume();
+        } else {
+            mWaiting.push_back( file ); //its calculator stays paused until startNext() gives it a reader
+        }
+    }
+}
+
+void BatchQueue::cancel( int file ) {
+    Job& job = mJobs.at( file );
+    if ( job.state == Running || job.state == Paused ) {
+        job.calculator->resume();
+        job.calculator->stop(); //no signal is emitted after it
+        end( file, Cancelled );
+    } else if ( job.state == Queued ) {
+        end( file, Cancelled );
+    }
+}
+
+void BatchQueue::cancelAll() {
+    mQueues.clear(); //nothing else has to start
+    mWaiting.clear();
+    for ( std::size_t file = 0; file < mJobs.size(); ++file ) {
+        cancel( static_cast< int >( file ) );
+    }
+}
+
+int BatchQueue::count() const {
+    return static_cast< int >( mJobs.size() );
+}
+
+QString BatchQueue::fileName( int file ) const {
+    return mJobs.at( file ).fileName;
+}
+
+BatchQueue::State BatchQueue::state( int file ) const {
+    return mJobs.at( file ).state;
+}
+
+int BatchQueue::original( int file ) const {
+    return mJobs.at( file ).original;
+}
+
+bool BatchQueue::isRunning() const {
+    return mUnfinished > 0;
+}
+
+int BatchQueue::maxRunning() const {
+    return mMaxRunning;
+}
+
+algorithms::Set BatchQueue::algorithms() const {
+    return mAlgorithms;
+}
+
+void BatchQueue::on_newHashString( int id, QByteArray hash ) {
+    int file = jobOf( sender() );
+    if ( file >= 0 ) {
+        emit newHashString( file, id, hash );
+    }
+}
+
+void BatchQueue::on_newChecksumValue( int id, quint64 value ) {
+    int file = jobOf( sender() );
+    if ( file >= 0 ) {
+        emit newChecksumValue( file, id, value );
+    }
+}
+
+void BatchQueue::on_progressUpdate( float progress ) {
+    int file = jobOf( sender() );
+    if ( file >= 0 ) {
+        emit progressUpdate( file, progress );
+    }
+}
+
+void BatchQueue::on_failed( QString error ) {
+    int file = jobOf( sender() );
+    if ( file >= 0 ) {
+        mJobs[ file ].state = Failed;
+        emit fileFailed( file, error );
+    }
+}
+
+void BatchQueue::on_finished() {
+    int file = jobOf( sender() );
+    if ( file >= 0 && mJobs[ file ].calculator->isFinished() ) { //not a late signal of a stopped calculator
+        mJobs[ file ].calculator->wait(); //finished() is emitted just before its thread ends
+        end( file, mJobs[ file ].state == Failed ? Failed : Hashed );
+    }
+}
+
+int BatchQueue::jobOf( QObject* calculator ) const {
+    return mRunning.value( calculator, -1 );
+}
+
+void BatchQueue::end( int file, State state ) {
+    finish( file, state );
+    startNext();
+    if ( !isRunning() ) {
+        emit finished();
+    }
+}
+
+void BatchQueue::finish( int file, State state ) {
+    Job& job = mJobs.at( file );
+    setReading( job, false ); //also if it failed: its state is no longer Running
+    mRunning.remove( job.calculator.get() );
+    job.calculator.reset();
+    job.state = state;
+    --mUnfinished;
+    emit fileEnded( file );
+
+    std::vector< int > links = std::move( job.links );
+    for ( int link : links ) {
+        if ( mJobs[ link ].state == Queued ) { //not cancelled in the meantime
+            finish( link, state );
+        }
+    }
+}
+
+void BatchQueue::setReading( Job& job, bool reading ) {
+    if ( job.reading != reading ) {
+        job.reading = reading;
+        mReaders[ job.location.device ] += reading ? 1 : -1;
+    }
+}
+
+void BatchQueue::startNext() {
+    for ( auto waiting = mWaiting.begin(); waiting != mWaiting.end(); ) {
+        Job& job = mJobs[ *waiting ];
+        if ( job.state != Running || job.reading ) {
+            waiting = mWaiting.erase( waiting ); //paused again, cancelled, or resumed twice
+        } else if ( hasReader( job.location.device ) ) {
+            setReading( job, true );
+            job.calculator->resume();
+            waiting = mWaiting.erase( waiting );
+        } else {
+            ++waiting;
+        }
+    }
+    while ( mRunning.size() < mMaxRunning ) {
+        int file = nextFile();
+        if ( file < 0 ) {
+            break;
+        }
+        Job& job = mJobs[ file ];
+        job.state = Running;
+        setReading( job, true );
+        job.calculator.reset( new FileHashCalculator( this, job.fileName, mAlgorithms ) );
+        job.calculator->setCacheNeutral( job.cacheNeutral );
+        FileHashCalculator* calculator = job.calculator.get();
+        mRunning.insert( calculator, file );
+        connect( calculator, SIGNAL( newHashString( int, QByteArray ) ), this, SLOT( on_newHashString( int, QByteArray ) ) );
+        connect( calculator, SIGNAL( newChecksumValue( int, quint64 ) ), this, SLOT( on_newChecksumValue( int, quint64 ) ) );
+        connect( calculator, SIGNAL( progressUpdate( float ) ), this, SLOT( on_progressUpdate( float ) ) );
+        connect( calculator, SIGNAL( failed( QString ) ), this, SLOT( on_failed( QString ) ) );
+        connect( calculator, SIGNAL( finished() ), this, SLOT( on_finished() ) );
+        emit fileStarted( file );
+        calculator->start();
+    }
+}
+
+int BatchQueue::nextFile() {
+    //the disk with the oldest queued file, among those that can read one more file
+    QHash< quint64, std::deque< int > >::iterator queue = mQueues.end();
+    for ( auto disk = mQueues.begin(); disk != mQueues.end(); ++disk ) {
+        std::deque< int >& files = disk.value();
+        while ( !files.empty() && !isStartable( files.front() ) ) {
+            files.pop_front(); //cancelled while waiting
+        }
+        if ( !files.empty() && hasReader( disk.key() ) && ( queue == mQueues.end() || files.front() < queue->front() ) ) {
+            queue = disk;
+        }
+    }
+    if ( queue == mQueues.end() ) {
+        return -1;
+    }
+    //the file after the head of the disk, or its first file when the head is past all of them
+    std::deque< int >& files = queue.value();
+    const quint64 head = mHeads.value( queue.key(), 0 );
+    int next = -1;
+    int first = -1;
+    const int end = static_cast< int >( qMin< std::size_t >( files.size(), SCHEDULE_WINDOW ) );
+    for ( int i = 0; i < end; ++i ) {
+        if ( !isStartable( files[ i ] ) ) {
+            continue;
+        }
+        quint64 offset = location( files[ i ] ).offset;
+        if ( offset >= head && ( next < 0 || offset < location( files[ next ] ).offset ) ) {
+            next = i;
+        }
+        if ( first < 0 || offset < location( files[ first ] ).offset ) {
+            first = i;
+        }
+    }
+    next = next >= 0 ? next : first;
+    int file = files[ next ];
+    files.erase( files.begin() + next );
+    mHeads.insert( queue.key(), mJobs[ file ].location.offset );
+    return file;
+}
+
+bool BatchQueue::hasReader( quint64 device ) {
+    if ( !mMaxReaders.contains( device ) ) {
+        mMaxReaders.insert( device, disklayout::readers( device ) );
+    }
+    int maxReaders = mMaxReaders.value( device );
+    return maxReaders == 0 || mReaders.value( device, 0 ) < maxReaders;
+}
+
+bool BatchQueue::isStartable( int file ) const {
+    return mJobs[ file ].state == Queued && mJobs[ file ].original < 0;
+}
+
+const disklayout::Location& BatchQueue::location( int file ) {
+    Job& job = mJobs[ file ];
+    if ( !job.located ) {
+        job.location.offset = disklayout::locate( job.fileName ).offset; //it stays in the queue of its device
+        job.located = true;
+    }
+    return job.location;
+}
@@ -0,0 +1,771 @@
+#include "blake3.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cpufeatures.hpp"
+#include "taskscheduler.hpp"
+
+#ifdef MRHASH_X86_64
+#include <immintrin.h>
+#endif
+
+using blake3::CHUNK_LENGTH;
+
+namespace {
+    const uint32_t IV[ 8 ] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    // The order of the message words in each of the seven rounds
+    const uint8_t MSG_SCHEDULE[ 7 ][ 16 ] = {
+        { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 },
+        { 2, 6, 3, 10, 7, 0, 4, 13, 1, 11, 12, 5, 9, 14, 15, 8 },
+        { 3, 4, 10, 12, 13, 2, 7, 14, 6, 5, 9, 0, 11, 15, 8, 1 },
+        { 10, 7, 12, 9, 14, 3, 13, 15, 4, 0, 11, 2, 5, 8, 1, 6 },
+        { 12, 13, 9, 11, 15, 10, 14, 8, 7, 2, 5, 3, 0, 1, 6, 4 },
+        { 9, 14, 11, 5, 8, 12, 15, 1, 13, 3, 0, 10, 2, 6, 4, 7 },
+        { 11, 15, 5, 0, 1, 9, 8, 6, 14, 10, 2, 12, 3, 4, 7, 13 }
+    };
+
+    enum Flags { CHUNK_START = 1, CHUNK_END = 2, PARENT = 4, ROOT = 8 };
+
+    const std::size_t BLOCK_LENGTH = 64;
+    const std::size_t OUT_LENGTH = 32;
+    const std::size_t MAX_SIMD_DEGREE = 16;
+
+    /* Subtrees of at least twice this size are split in pieces hashed on the threads of the pool,
+     * each large enough to amortize the scheduling of the task */
+    const std::size_t PARALLEL_MIN_SIZE = 128 * 1024;
+
+    inline uint32_t rotr( uint32_t x, int n ) { return ( x >> n ) | ( x << ( 32 - n ) ); }
+
+    inline uint32_t load32( const byte* data ) {
+        quint32 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    inline void storeCv( const uint32_t cv[ 8 ], byte* out ) {
+        for ( int i = 0; i < 8; ++i ) {
+            qToLittleEndian( static_cast< quint32 >( cv[ i ] ), out + 4 * i );
+        }
+    }
+
+    inline void g( uint32_t* v, int a, int b, int c, int d, uint32_t x, uint32_t y ) {
+        v[ a ] += v[ b ] + x;
+        v[ d ] = rotr( v[ d ] ^ v[ a ], 16 );
+        v[ c ] += v[ d ];
+        v[ b ] = rotr( v[ b ] ^ v[ c ], 12 );
+        v[ a ] += v[ b ] + y;
+        v[ d ] = rotr( v[ d ] ^ v[ a ], 8 );
+        v[ c ] += v[ d ];
+        v[ b ] = rotr( v[ b ] ^ v[ c ], 7 );
+    }
+
+    // The compression function, updating the chaining value in place (the output is truncated to 256 bits)
+    void compressInPlace( uint32_t cv[ 8 ], const byte block[ 64 ], uint32_t blockLength, uint64_t counter, uint32_t flags ) {
+        uint32_t m[ 16 ];
+        for ( int i = 0; i < 16; ++i ) {
+            m[ i ] = load32( block + 4 * i );
+        }
+        uint32_t v[ 16 ] = {
+            cv[ 0 ], cv[ 1 ], cv[ 2 ], cv[ 3 ], cv[ 4 ], cv[ 5 ], cv[ 6 ], cv[ 7 ],
+            IV[ 0 ], IV[ 1 ], IV[ 2 ], IV[ 3 ],
+            static_cast< uint32_t >( counter ), static_cast< uint32_t >( counter >> 32 ), blockLength, flags
+        };
+        for ( int r = 0; r < 7; ++r ) {
+            const uint8_t* s = MSG_SCHEDULE[ r ];
+            g( v, 0, 4, 8, 12, m[ s[ 0 ] ], m[ s[ 1 ] ] );
+            g( v, 1, 5, 9, 13, m[ s[ 2 ] ], m[ s[ 3 ] ] );
+            g( v, 2, 6, 10, 14, m[ s[ 4 ] ], m[ s[ 5 ] ] );
+            g( v, 3, 7, 11, 15, m[ s[ 6 ] ], m[ s[ 7 ] ] );
+            g( v, 0, 5, 10, 15, m[ s[ 8 ] ], m[ s[ 9 ] ] );
+            g( v, 1, 6, 11, 12, m[ s[ 10 ] ], m[ s[ 11 ] ] );
+            g( v, 2, 7, 8, 13, m[ s[ 12 ] ], m[ s[ 13 ] ] );
+            g( v, 3, 4, 9, 14, m[ s[ 14 ] ], m[ s[ 15 ] ] );
+        }
+        for ( int i = 0; i < 8; ++i ) {
+            cv[ i ] = v[ i ] ^ v[ i + 8 ];
+        }
+    }
+
+    /* The arguments of the hashMany functions: count inputs of blocks blocks each, hashed starting from the IV
+     * (chunks, whose counter is incremented from one input to the next, or parent nodes of a single block);
+     * the chaining values are written one after the other to out. */
+    struct Inputs {
+        const byte* const* data;
+        std::size_t count;
+        std::size_t blocks;
+        uint64_t counter;
+        bool incrementCounter;
+        uint32_t flags;
+        uint32_t flagsStart;
+        uint32_t flagsEnd;
+    };
+
+    inline uint32_t blockFlags( const Inputs& inputs, std::size_t block ) {
+        uint32_t flags = inputs.flags;
+        if ( block == 0 ) {
+            flags |= inputs.flagsStart;
+        }
+        if ( block + 1 == inputs.blocks ) {
+            flags |= inputs.flagsEnd;
+        }
+        return flags;
+    }
+
+    // The low and high words of the counters of count consecutive inputs starting with first
+    inline void laneCounters( const Inputs& inputs, std::size_t first, std::size_t count, uint32_t* low, uint32_t* high ) {
+        for ( std::size_t lane = 0; lane < count; ++lane ) {
+            uint64_t counter = inputs.counter + ( inputs.incrementCounter ? first + lane : 0 );
+            low[ lane ] = static_cast< uint32_t >( counter );
+            high[ lane ] = static_cast< uint32_t >( counter >> 32 );
+        }
+    }
+
+    void hashOnePortable( const Inputs& inputs, std::size_t index, byte* out ) {
+        uint32_t cv[ 8 ];
+        std::memcpy( cv, IV, sizeof( cv ) );
+        uint64_t counter = inputs.counter + ( inputs.incrementCounter ? index : 0 );
+        for ( std::size_t block = 0; block < inputs.blocks; ++block ) {
+            compressInPlace( cv, inputs.data[ index ] + block * BLOCK_LENGTH, BLOCK_LENGTH, counter, blockFlags( inputs, block ) );
+        }
+        storeCv( cv, out );
+    }
+
+#ifdef MRHASH_X86_64
+    /* SSE4.1 kernel: four inputs, the words of their blocks transposed 4x4 with the unpack instructions */
+    MRHASH_TARGET( "sse4.1" )
+    inline __m128i rotr128( __m128i x, int n ) {
+        return _mm_or_si128( _mm_srli_epi32( x, n ), _mm_slli_epi32( x, 32 - n ) );
+    }
+
+    MRHASH_TARGET( "sse4.1" )
+    inline void g4( __m128i* v, int a, int b, int c, int d, __m128i x, __m128i y ) {
+        const __m128i rot16 = _mm_setr_epi8( 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 );
+        const __m128i rot8 = _mm_setr_epi8( 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 );
+        v[ a ] = _mm_add_epi32( _mm_add_epi32( v[ a ], v[ b ] ), x );
+        v[ d ] = _mm_shuffle_epi8( _mm_xor_si128( v[ d ], v[ a ] ), rot16 );
+        v[ c ] = _mm_add_epi32( v[ c ], v[ d ] );
+        v[ b ] = rotr128( _mm_xor_si128( v[ b ], v[ c ] ), 12 );
+        v[ a ] = _mm_add_epi32( _mm_add_epi32( v[ a ], v[ b ] ), y );
+        v[ d ] = _mm_shuffle_epi8( _mm_xor_si128( v[ d ], v[ a ] ), rot8 );
+        v[ c ] = _mm_add_epi32( v[ c ], v[ d ] );
+        v[ b ] = rotr128( _mm_xor_si128( v[ b ], v[ c ] ), 7 );
+    }
+
+    MRHASH_TARGET( "sse4.1" )
+    void hash4Sse41( const Inputs& inputs, std::size_t first, byte* out ) {
+        uint32_t low[ 4 ], high[ 4 ];
+        laneCounters( inputs, first, 4, low, high );
+        const byte* const* data = inputs.data + first;
+        __m128i h[ 8 ];
+        for ( int i = 0; i < 8; ++i ) {
+            h[ i ] = _mm_set1_epi32( static_cast< int >( IV[ i ] ) );
+        }
+        for ( std::size_t block = 0; block < inputs.blocks; ++block ) {
+            __m128i m[ 16 ];
+            for ( int group = 0; group < 4; ++group ) {
+                std::size_t offset = block * BLOCK_LENGTH + 16 * group;
+                __m128i r0 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data[ 0 ] + offset ) );
+                __m128i r1 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data[ 1 ] + offset ) );
+                __m128i r2 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data[ 2 ] + offset ) );
+                __m128i r3 = _mm_loadu_si128( reinterpret_cast< const __m128i* >( data[ 3 ] + offset ) );
+                __m128i t0 = _mm_unpacklo_epi32( r0, r1 ), t1 = _mm_unpackhi_epi32( r0, r1 );
+                __m128i t2 = _mm_unpacklo_epi32( r2, r3 ), t3 = _mm_unpackhi_epi32( r2, r3 );
+                m[ 4 * group ] = _mm_unpacklo_epi64( t0, t2 );
+                m[ 4 * group + 1 ] = _mm_unpackhi_epi64( t0, t2 );
+                m[ 4 * group + 2 ] = _mm_unpacklo_epi64( t1, t3 );
+                m[ 4 * group + 3 ] = _mm_unpackhi_epi64( t1, t3 );
+            }
+            __m128i v[ 16 ] = {
+                h[ 0 ], h[ 1 ], h[ 2 ], h[ 3 ], h[ 4 ], h[ 5 ], h[ 6 ], h[ 7 ],
+                _mm_set1_epi32( static_cast< int >( IV[ 0 ] ) ), _mm_set1_epi32( static_cast< int >( IV[ 1 ] ) ),
+                _mm_set1_epi32( static_cast< int >( IV[ 2 ] ) ), _mm_set1_epi32( static_cast< int >( IV[ 3 ] ) ),
+                _mm_loadu_si128( reinterpret_cast< const __m128i* >( low ) ),
+                _mm_loadu_si128( reinterpret_cast< const __m128i* >( high ) ),
+                _mm_set1_epi32( static_cast< int >( BLOCK_LENGTH ) ),
+                _mm_set1_epi32( static_cast< int >( blockFlags( inputs, block ) ) )
+            };
+            for ( int r = 0; r < 7; ++r ) {
+                const uint8_t* s = MSG_SCHEDULE[ r ];
+                g4( v, 0, 4, 8, 12, m[ s[ 0 ] ], m[ s[ 1 ] ] );
+                g4( v, 1, 5, 9, 13, m[ s[ 2 ] ], m[ s[ 3 ] ] );
+                g4( v, 2, 6, 10, 14, m[ s[ 4 ] ], m[ s[ 5 ] ] );
+                g4( v, 3, 7, 11, 15, m[ s[ 6 ] ], m[ s[ 7 ] ] );
+                g4( v, 0, 5, 10, 15, m[ s[ 8 ] ], m[ s[ 9 ] ] );
+                g4( v, 1, 6, 11, 12, m[ s[ 10 ] ], m[ s[ 11 ] ] );
+                g4( v, 2, 7, 8, 13, m[ s[ 12 ] ], m[ s[ 13 ] ] );
+                g4( v, 3, 4, 9, 14, m[ s[ 14 ] ], m[ s[ 15 ] ] );
+            }
+            for ( int i = 0; i < 8; ++i ) {
+                h[ i ] = _mm_xor_si128( v[ i ], v[ i + 8 ] );
+            }
+        }
+        uint32_t cvs[ 8 ][ 4 ];
+        for ( int i = 0; i < 8; ++i ) {
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( cvs[ i ] ), h[ i ] );
+        }
+        for ( std::size_t lane = 0; lane < 4; ++lane ) {
+            for ( int i = 0; i < 8; ++i ) {
+                qToLittleEndian( static_cast< quint32 >( cvs[ i ][ lane ] ), out + OUT_LENGTH * lane + 4 * i );
+            }
+        }
+    }
+
+    /* AVX2 kernel: eight inputs, transposed 8x8 as in the multi-buffer kernels */
+    MRHASH_TARGET( "avx2" )
+    inline __m256i rotr256( __m256i x, int n ) {
+        return _mm256_or_si256( _mm256_srli_epi32( x, n ), _mm256_slli_epi32( x, 32 - n ) );
+    }
+
+    MRHASH_TARGET( "avx2" )
+    inline void g8( __m256i* v, int a, int b, int c, int d, __m256i x, __m256i y ) {
+        const __m256i rot16 = _mm256_setr_epi8( 2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13,
+                                                2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13 );
+        const __m256i rot8 = _mm256_setr_epi8( 1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12,
+                                               1, 2, 3, 0, 5, 6, 7, 4, 9, 10, 11, 8, 13, 14, 15, 12 );
+        v[ a ] = _mm256_add_epi32( _mm256_add_epi32( v[ a ], v[ b ] ), x );
+        v[ d ] = _mm256_shuffle_epi8( _mm256_xor_si256( v[ d ], v[ a ] ), rot16 );
+        v[ c ] = _mm256_add_epi32( v[ c ], v[ d ] );
+        v[ b ] = rotr256( _mm256_xor_si256( v[ b ], v[ c ] ), 12 );
+        v[ a ] = _mm256_add_epi32( _mm256_add_epi32( v[ a ], v[ b ] ), y );
+        v[ d ] = _mm256_shuffle_epi8( _mm256_xor_si256( v[ d ], v[ a ] ), rot8 );
+        v[ c ] = _mm256_add_epi32( v[ c ], v[ d ] );
+        v[ b ] = rotr256( _mm256_xor_si256( v[ b ], v[ c ] ), 7 );
+    }
+
+    MRHASH_TARGET( "avx2" )
+    inline void loadTransposed8( const byte* const* data, std::size_t offset, __m256i* words ) {
+        __m256i rows[ 8 ];
+        for ( int lane = 0; lane < 8; ++lane ) {
+            rows[ lane ] = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( data[ lane ] + offset ) );
+        }
+        __m256i pairs[ 8 ];
+        for ( int i = 0; i < 8; i += 2 ) {
+            pairs[ i ] = _mm256_unpacklo_epi32( rows[ i ], rows[ i + 1 ] );
+            pairs[ i + 1 ] = _mm256_unpackhi_epi32( rows[ i ], rows[ i + 1 ] );
+        }
+        __m256i quads[ 8 ];
+        for ( int i = 0; i < 8; i += 4 ) {
+            quads[ i ] = _mm256_unpacklo_epi64( pairs[ i ], pairs[ i + 2 ] );
+            quads[ i + 1 ] = _mm256_unpackhi_epi64( pairs[ i ], pairs[ i + 2 ] );
+            quads[ i + 2 ] = _mm256_unpacklo_epi64( pairs[ i + 1 ], pairs[ i + 3 ] );
+            quads[ i + 3 ] = _mm256_unpackhi_epi64( pairs[ i + 1 ], pairs[ i + 3 ] );
+        }
+        for ( int i = 0; i < 4; ++i ) {
+            words[ i ] = _mm256_permute2x128_si256( quads[ i ], quads[ i + 4 ], 0x20 );
+            words[ i + 4 ] = _mm256_permute2x128_si256( quads[ i ], quads[ i + 4 ], 0x31 );
+        }
+    }
+
+    MRHASH_TARGET( "avx2" )
+    void hash8Avx2( const Inputs& inputs, std::size_t first, byte* out ) {
+        uint32_t low[ 8 ], high[ 8 ];
+        laneCounters( inputs, first, 8, low, high );
+        const byte* const* data = inputs.data + first;
+        __m256i h[ 8 ];
+        for ( int i = 0; i < 8; ++i ) {
+            h[ i ] = _mm256_set1_epi32( static_cast< int >( IV[ i ] ) );
+        }
+        for ( std::size_t block = 0; block < inputs.blocks; ++block ) {
+            __m256i m[ 16 ];
+            loadTransposed8( data, block * BLOCK_LENGTH, m );
+            loadTransposed8( data, block * BLOCK_LENGTH + 32, m + 8 );
+            __m256i v[ 16 ] = {
+                h[ 0 ], h[ 1 ], h[ 2 ], h[ 3 ], h[ 4 ], h[ 5 ], h[ 6 ], h[ 7 ],
+                _mm256_set1_epi32( static_cast< int >( IV[ 0 ] ) ), _mm256_set1_epi32( static_cast< int >( IV[ 1 ] ) ),
+                _mm256_set1_epi32( static_cast< int >( IV[ 2 ] ) ), _mm256_set1_epi32( static_cast< int >( IV[ 3 ] ) ),
+                _mm256_loadu_si256( reinterpret_cast< const __m256i* >( low ) ),
+                _mm256_loadu_si256( reinterpret_cast< const __m256i* >( high ) ),
+                _mm256_set1_epi32( static_cast< int >( BLOCK_LENGTH ) ),
+                _mm256_set1_epi32( static_cast< int >( blockFlags( inputs, block ) ) )
+            };
+            for ( int r = 0; r < 7; ++r ) {
+                const uint8_t* s = MSG_SCHEDULE[ r ];
+                g8( v, 0, 4, 8, 12, m[ s[ 0 ] ], m[ s[ 1 ] ] );
+                g8( v, 1, 5, 9, 13, m[ s[ 2 ] ], m[ s[ 3 ] ] );
+                g8( v, 2, 6, 10, 14, m[ s[ 4 ] ], m[ s[ 5 ] ] );
+                g8( v, 3, 7, 11, 15, m[ s[ 6 ] ], m[ s[ 7 ] ] );
+                g8( v, 0, 5, 10, 15, m[ s[ 8 ] ], m[ s[ 9 ] ] );
+                g8( v, 1, 6, 11, 12, m[ s[ 10 ] ], m[ s[ 11 ] ] );
+                g8( v, 2, 7, 8, 13, m[ s[ 12 ] ], m[ s[ 13 ] ] );
+                g8( v, 3, 4, 9, 14, m[ s[ 14 ] ], m[ s[ 15 ] ] );
+            }
+            for ( int i = 0; i < 8; ++i ) {
+                h[ i ] = _mm256_xor_si256( v[ i ], v[ i + 8 ] );
+            }
+        }
+        uint32_t cvs[ 8 ][ 8 ];
+        for ( int i = 0; i < 8; ++i ) {
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( cvs[ i ] ), h[ i ] );
+        }
+        for ( std::size_t lane = 0; lane < 8; ++lane ) {
+            for ( int i = 0; i < 8; ++i ) {
+                qToLittleEndian( static_cast< quint32 >( cvs[ i ][ lane ] ), out + OUT_LENGTH * lane + 4 * i );
+            }
+        }
+    }
+#endif
+
+#ifdef MRHASH_AVX512
+#if defined( __GNUC__ ) && !defined( __clang__ )
+    // the unmasked AVX-512 intrinsics of GCC start from _mm512_undefined_epi32(), reported as uninitialized
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+    /* AVX-512 kernel: sixteen inputs, with the native rotations; the 16x16 transposition of the blocks
+     * ends with two rounds of 128 bit shuffles across the registers */
+    MRHASH_TARGET( "avx512f" )
+    inline void g16( __m512i* v, int a, int b, int c, int d, __m512i x, __m512i y ) {
+        v[ a ] = _mm512_add_epi32( _mm512_add_epi32( v[ a ], v[ b ] ), x );
+        v[ d ] = _mm512_ror_epi32( _mm512_xor_si512( v[ d ], v[ a ] ), 16 );
+        v[ c ] = _mm512_add_epi32( v[ c ], v[ d ] );
+        v[ b ] = _mm512_ror_epi32( _mm512_xor_si512( v[ b ], v[ c ] ), 12 );
+        v[ a ] = _mm512_add_epi32( _mm512_add_epi32( v[ a ], v[ b ] ), y );
+        v[ d ] = _mm512_ror_epi32( _mm512_xor_si512( v[ d ], v[ a ] ), 8 );
+        v[ c ] = _mm512_add_epi32( v[ c ], v[ d ] );
+        v[ b ] = _mm512_ror_epi32( _mm512_xor_si512( v[ b ], v[ c ] ), 7 );
+    }
+
+    MRHASH_TARGET( "avx512f" )
+    inline void loadTransposed16( const byte* const* data, std::size_t offset, __m512i* words ) {
+        __m512i rows[ 16 ];
+        for ( int lane = 0; lane < 16; ++lane ) {
+            rows[ lane ] = _mm512_loadu_si512( data[ lane ] + offset );
+        }
+        // within each 128 bit lane j, quads[ 4k + w ] holds the word 4j + w of the rows 4k to 4k + 3
+        __m512i pairs[ 16 ];
+        for ( int i = 0; i < 16; i += 2 ) {
+            pairs[ i ] = _mm512_unpacklo_epi32( rows[ i ], rows[ i + 1 ] );
+            pairs[ i + 1 ] = _mm512_unpackhi_epi32( rows[ i ], rows[ i + 1 ] );
+        }
+        __m512i quads[ 16 ];
+        for ( int i = 0; i < 16; i += 4 ) {
+            quads[ i ] = _mm512_unpacklo_epi64( pairs[ i ], pairs[ i + 2 ] );
+            quads[ i + 1 ] = _mm512_unpackhi_epi64( pairs[ i ], pairs[ i + 2 ] );
+            quads[ i + 2 ] = _mm512_unpacklo_epi64( pairs[ i + 1 ], pairs[ i + 3 ] );
+            quads[ i + 3 ] = _mm512_unpackhi_epi64( pairs[ i + 1 ], pairs[ i + 3 ] );
+        }
+        for ( int w = 0; w < 4; ++w ) {
+            __m512i even01 = _mm512_shuffle_i32x4( quads[ w ], quads[ 4 + w ], 0x88 );
+            __m512i odd01 = _mm512_shuffle_i32x4( quads[ w ], quads[ 4 + w ], 0xdd );
+            __m512i even23 = _mm512_shuffle_i32x4( quads[ 8 + w ], quads[ 12 + w ], 0x88 );
+            __m512i odd23 = _mm512_shuffle_i32x4( quads[ 8 + w ], quads[ 12 + w ], 0xdd );
+            words[ w ] = _mm512_shuffle_i32x4( even01, even23, 0x88 );
+            words[ 4 + w ] = _mm512_shuffle_i32x4( odd01, odd23, 0x88 );
+            words[ 8 + w ] = _mm512_shuffle_i32x4( even01, even23, 0xdd );
+            words[ 12 + w ] = _mm512_shuffle_i32x4( odd01, odd23, 0xdd );
+        }
+    }
+
+    MRHASH_TARGET( "avx512f" )
+    void hash16Avx512( const Inputs& inputs, std::size_t first, byte* out ) {
+        uint32_t low[ 16 ], high[ 16 ];
+        laneCounters( inputs, first, 16, low, high );
+        const byte* const* data = inputs.data + first;
+        __m512i h[ 8 ];
+        for ( int i = 0; i < 8; ++i ) {
+            h[ i ] = _mm512_set1_epi32( static_cast< int >( IV[ i ] ) );
+        }
+        for ( std::size_t block = 0; block < inputs.blocks; ++block ) {
+            __m512i m[ 16 ];
+            loadTransposed16( data, block * BLOCK_LENGTH, m );
+            __m512i v[ 16 ] = {
+                h[ 0 ], h[ 1 ], h[ 2 ], h[ 3 ], h[ 4 ], h[ 5 ], h[ 6 ], h[ 7 ],
+                _mm512_set1_epi32( static_cast< int >( IV[ 0 ] ) ), _mm512_set1_epi32( static_cast< int >( IV[ 1 ] ) ),
+                _mm512_set1_epi32( static_cast< int >( IV[ 2 ] ) ), _mm512_set1_epi32( static_cast< int >( IV[ 3 ] ) ),
+                _mm512_loadu_si512( low ),
+                _mm512_loadu_si512( high ),
+                _mm512_set1_epi32( static_cast< int >( BLOCK_LENGTH ) ),
+                _mm512_set1_epi32( static_cast< int >( blockFlags( inputs, block ) ) )
+            };
+            for ( int r = 0; r < 7; ++r ) {
+                const uint8_t* s = MSG_SCHEDULE[ r ];
+                g16( v, 0, 4, 8, 12, m[ s[ 0 ] ], m[ s[ 1 ] ] );
+                g16( v, 1, 5, 9, 13, m[ s[ 2 ] ], m[ s[ 3 ] ] );
+                g16( v, 2, 6, 10, 14, m[ s[ 4 ] ], m[ s[ 5 ] ] );
+                g16( v, 3, 7, 11, 15, m[ s[ 6 ] ], m[ s[ 7 ] ] );
+                g16( v, 0, 5, 10, 15, m[ s[ 8 ] ], m[ s[ 9 ] ] );
+                g16( v, 1, 6, 11, 12, m[ s[ 10 ] ], m[ s[ 11 ] ] );
+                g16( v, 2, 7, 8, 13, m[ s[ 12 ] ], m[ s[ 13 ] ] );
+                g16( v, 3, 4, 9, 14, m[ s[ 14 ] ], m[ s[ 15 ] ] );
+            }
+            for ( int i = 0; i < 8; ++i ) {
+                h[ i ] = _mm512_xor_si512( v[ i ], v[ i + 8 ] );
+            }
+        }
+        uint32_t cvs[ 8 ][ 16 ];
+        for ( int i = 0; i < 8; ++i ) {
+            _mm512_storeu_si512( cvs[ i ], h[ i ] );
+        }
+        for ( std::size_t lane = 0; lane < 16; ++lane ) {
+            for ( int i = 0; i < 8; ++i ) {
+                qToLittleEndian( static_cast< quint32 >( cvs[ i ][ lane ] ), out + OUT_LENGTH * lane + 4 * i );
+            }
+        }
+    }
+#if defined( __GNUC__ ) && !defined( __clang__ )
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+    blake3::Kernel selectKernel() {
+        blake3::Kernel kernel = blake3::Portable;
+#ifdef MRHASH_X86_64
+        const cpu::Features& features = cpu::features();
+        if ( features.avx2 ) {
+            kernel = blake3::Avx2;
+        } else if ( features.sse41 ) {
+            kernel = blake3::Sse41;
+        }
+#endif
+#ifdef MRHASH_AVX512
+        if ( features.avx512 ) {
+            kernel = blake3::Avx512;
+        }
+#endif
+        qCInfo( cpu::kernels ) << "BLAKE3 kernel:" << blake3::kernelName( kernel );
+        return kernel;
+    }
+
+    std::size_t simdDegree() {
+        switch ( blake3::kernel() ) {
+            case blake3::Avx512:
+                return 16;
+            case blake3::Avx2:
+                return 8;
+            case blake3::Sse41:
+                return 4;
+            default:
+                return 1;
+        }
+    }
+
+    // Hashes the inputs with the widest kernels first, the remaining ones with the narrower
+    void hashMany( const Inputs& inputs, byte* out ) {
+        std::size_t first = 0;
+        const blake3::Kernel kernel = blake3::kernel();
+#ifdef MRHASH_AVX512
+        for ( ; kernel >= blake3::Avx512 && inputs.count - first >= 16; first += 16 ) {
+            hash16Avx512( inputs, first, out + OUT_LENGTH * first );
+        }
+#endif
+#ifdef MRHASH_X86_64
+        for ( ; kernel >= blake3::Avx2 && inputs.count - first >= 8; first += 8 ) {
+            hash8Avx2( inputs, first, out + OUT_LENGTH * first );
+        }
+        for ( ; kernel >= blake3::Sse41 && inputs.count - first >= 4; first += 4 ) {
+            hash4Sse41( inputs, first, out + OUT_LENGTH * first );
+        }
+#endif
+        for ( ; first < inputs.count; ++first ) {
+            hashOnePortable( inputs, first, out + OUT_LENGTH * first );
+        }
+    }
+
+    void parentCv( const byte* children, uint32_t cv[ 8 ], uint32_t flags = PARENT ) {
+        std::memcpy( cv, IV, 8 * sizeof( uint32_t ) );
+        compressInPlace( cv, children, BLOCK_LENGTH, 0, flags );
+    }
+
+    // Hashes the complete chunks of the input (at most simdDegree() of them) and the final partial one, if any
+    std::size_t compressChunks( const byte* input, std::size_t length, uint64_t counter, byte* out ) {
+        const byte* chunks[ MAX_SIMD_DEGREE ];
+        std::size_t count = 0;
+        for ( ; ( count + 1 ) * CHUNK_LENGTH <= length; ++count ) {
+            chunks[ count ] = input + count * CHUNK_LENGTH;
+        }
+        Inputs inputs = { chunks, count, CHUNK_LENGTH / BLOCK_LENGTH, counter, true, 0, CHUNK_START, CHUNK_END };
+        hashMany( inputs, out );
+        if ( count * CHUNK_LENGTH < length ) {
+            blake3::ChunkState chunk;
+            chunk.reset( counter + count );
+            chunk.update( input + count * CHUNK_LENGTH, length - count * CHUNK_LENGTH );
+            uint32_t cv[ 8 ];
+            chunk.chainingValue( cv );
+            storeCv( cv, out + OUT_LENGTH * count );
+            ++count;
+        }
+        return count;
+    }
+
+    // Replaces count chaining values with the ones of their parents (an odd one out is carried over)
+    std::size_t compressParents( const byte* cvs, std::size_t count, byte* out ) {
+        const byte* parents[ MAX_SIMD_DEGREE ];
+        std::size_t parentCount = count / 2;
+        for ( std::size_t i = 0; i < parentCount; ++i ) {
+            parents[ i ] = cvs + 2 * OUT_LENGTH * i;
+        }
+        Inputs inputs = { parents, parentCount, 1, 0, false, PARENT, 0, 0 };
+        hashMany( inputs, out );
+        if ( count % 2 == 1 ) {
+            std::memcpy( out + OUT_LENGTH * parentCount, cvs + OUT_LENGTH * ( count - 1 ), OUT_LENGTH );
+            ++parentCount;
+        }
+        return parentCount;
+    }
+
+    inline std::size_t roundDownToPowerOf2( uint64_t x ) {
+        uint64_t power = 1;
+        while ( power <= x / 2 ) {
+            power *= 2;
+        }
+        return static_cast< std::size_t >( power );
+    }
+
+    /* Hashes a subtree (whose first chunk has the given counter) down to at most simdDegree() chaining values
+     * (at least two if it has more than one chunk), so that the nodes of each level are compressed together */
+    std::size_t compressSubtreeWide( const byte* input, std::size_t length, uint64_t counter, byte* out ) {
+        if ( length <= simdDegree() * CHUNK_LENGTH ) {
+            return compressChunks( input, length, counter, out );
+        }
+        // the left subtree is the largest complete one with fewer chunks than the whole
+        std::size_t leftLength = roundDownToPowerOf2( ( length - 1 ) / CHUNK_LENGTH ) * CHUNK_LENGTH;
+        // the left half fills exactly simdDegree() chaining values (two with the portable kernel, unless it is a single chunk)
+        std::size_t degree = simdDegree();
+        if ( degree == 1 && leftLength > CHUNK_LENGTH ) {
+            degree = 2;
+        }
+        byte cvs[ 2 * MAX_SIMD_DEGREE * OUT_LENGTH ];
+        std::size_t leftCount = compressSubtreeWide( input, leftLength, counter, cvs );
+        std::size_t rightCount = compressSubtreeWide( input + leftLength, length - leftLength,
+                                                      counter + leftLength / CHUNK_LENGTH, cvs + degree * OUT_LENGTH );
+        if ( leftCount == 1 ) { // only with the portable kernel: the two halves are already the children
+            std::memcpy( out, cvs, 2 * OUT_LENGTH );
+            return 2;
+        }
+        return compressParents( cvs, leftCount + rightCount, out );
+    }
+
+    // Reduces a subtree of more than one chunk to the chaining values of its two children
+    void compressSubtreeToChildren( const byte* input, std::size_t length, uint64_t counter, byte* out, std::size_t limit = 2 ) {
+        byte cvs[ MAX_SIMD_DEGREE * OUT_LENGTH ];
+        std::size_t count = compressSubtreeWide( input, length, counter, cvs );
+        while ( count > limit ) {
+            byte parents[ MAX_SIMD_DEGREE * OUT_LENGTH ];
+            count = compressParents( cvs, count, parents );
+            std::memcpy( cvs, parents, count * OUT_LENGTH );
+        }
+        std::memcpy( out, cvs, limit * OUT_LENGTH );
+    }
+
+    /* As compressSubtreeToChildren, for a complete subtree (a power of two chunks): when it is large enough, its
+     * 2^k largest subtrees are hashed as tasks of the scheduler (and on the calling thread) and then merged */
+    void compressSubtreeToParentNode( const byte* input, std::size_t length, uint64_t counter, byte* out ) {
+        std::size_t pieces = 1;
+        TaskScheduler& scheduler = TaskScheduler::instance();
+        const std::size_t threads = static_cast< std::size_t >( scheduler.workerCount() );
+        while ( pieces * 2 <= threads && length / ( pieces * 2 ) >= PARALLEL_MIN_SIZE && pieces * 2 <= MAX_SIMD_DEGREE ) {
+            pieces *= 2;
+        }
+        if ( pieces == 1 ) {
+            compressSubtreeToChildren( input, length, counter, out );
+            return;
+        }
+
+        const std::size_t pieceLength = length / pieces;
+        byte cvs[ MAX_SIMD_DEGREE * OUT_LENGTH ];
+        {
+            /* the calling thread may itself be a worker of the scheduler: while waiting, it hashes
+             * the pieces that were not stolen by the other workers */
+            TaskScheduler::Group group( scheduler );
+            for ( std::size_t i = 1; i < pieces; ++i ) {
+                const byte* pieceInput = input + i * pieceLength;
+                uint64_t pieceCounter = counter + i * pieceLength / CHUNK_LENGTH;
+                byte* cv = cvs + i * OUT_LENGTH;
+                group.run( [pieceInput, pieceLength, pieceCounter, cv]() {
+                    compressSubtreeToChildren( pieceInput, pieceLength, pieceCounter, cv, 1 );
+                } );
+            }
+            compressSubtreeToChildren( input, pieceLength, counter, cvs, 1 );
+            group.wait();
+        }
+
+        std::size_t count = pieces;
+        while ( count > 2 ) {
+            byte parents[ MAX_SIMD_DEGREE * OUT_LENGTH ];
+            count = compressParents( cvs, count, parents );
+            std::memcpy( cvs, parents, count * OUT_LENGTH );
+        }
+        std::memcpy( out, cvs, 2 * OUT_LENGTH );
+    }
+}
+
+blake3::Kernel blake3::kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+const char* blake3::kernelName( Kernel kernel ) {
+    switch ( kernel ) {
+        case Avx512:
+            return "AVX-512";
+        case Avx2:
+            return "AVX2";
+        case Sse41:
+            return "SSE4.1";
+        default:
+            return "portable";
+    }
+}
+
+void blake3::ChunkState::reset( uint64_t counter ) {
+    std::memcpy( mCv, IV, sizeof( mCv ) );
+    mCounter = counter;
+    mBlockLength = 0;
+    mBlocksCompressed = 0;
+}
+
+void blake3::ChunkState::update( const byte* data, std::size_t length ) {
+    // a full block is compressed only when more data follows, since the last one is flagged as CHUNK_END
+    while ( length > 0 ) {
+        if ( mBlockLength == BLOCK_LENGTH ) {
+            compressInPlace( mCv, mBlock, BLOCK_LENGTH, mCounter, mBlocksCompressed == 0 ? CHUNK_START : 0 );
+            ++mBlocksCompressed;
+            mBlockLength = 0;
+        }
+        std::size_t copied = qMin( length, BLOCK_LENGTH - mBlockLength );
+        std::memcpy( mBlock + mBlockLength, data, copied );
+        mBlockLength += copied;
+        data += copied;
+        length -= copied;
+    }
+}
+
+void blake3::ChunkState::chainingValue( uint32_t cv[ 8 ] ) const {
+    byte block[ BLOCK_LENGTH ] = {};
+    std::memcpy( block, mBlock, mBlockLength );
+    std::memcpy( cv, mCv, sizeof( mCv ) );
+    uint32_t flags = CHUNK_END | ( mBlocksCompressed == 0 ? CHUNK_START : 0 );
+    compressInPlace( cv, block, static_cast< uint32_t >( mBlockLength ), mCounter, flags );
+}
+
+void blake3::ChunkState::rootHash( byte hash[ 32 ] ) const {
+    byte block[ BLOCK_LENGTH ] = {};
+    std::memcpy( block, mBlock, mBlockLength );
+    uint32_t cv[ 8 ];
+    std::memcpy( cv, mCv, sizeof( mCv ) );
+    uint32_t flags = CHUNK_END | ROOT | ( mBlocksCompressed == 0 ? CHUNK_START : 0 );
+    compressInPlace( cv, block, static_cast< uint32_t >( mBlockLength ), 0, flags );
+    storeCv( cv, hash );
+}
+
+void Blake3::init() {
+    mChunk.reset( 0 );
+    mCvStackLength = 0;
+}
+
+void Blake3::update( const byte* data, std::size_t length ) {
+    // completes the chunk left partial by the previous call
+    if ( mChunk.length() > 0 ) {
+        std::size_t copied = qMin( length, CHUNK_LENGTH - mChunk.length() );
+        mChunk.update( data, copied );
+        data += copied;
+        length -= copied;
+        if ( length == 0 ) {
+            return;
+        }
+        uint32_t cv[ 8 ];
+        mChunk.chainingValue( cv );
+        pushCv( cv, mChunk.counter() );
+        mChunk.reset( mChunk.counter() + 1 );
+    }
+
+    /* hashes the largest complete subtrees of the input (aligned to their size in the whole tree),
+     * always keeping at least a byte for the chunk state, since the last chunk could be the root */
+    uint64_t counter = mChunk.counter();
+    while ( length > CHUNK_LENGTH ) {
+        std::size_t subtreeLength = roundDownToPowerOf2( length );
+        while ( ( ( subtreeLength - 1 ) & ( counter * CHUNK_LENGTH ) ) != 0 ) {
+            subtreeLength /= 2;
+        }
+        uint64_t subtreeChunks = subtreeLength / CHUNK_LENGTH;
+        if ( subtreeLength <= CHUNK_LENGTH ) {
+            blake3::ChunkState chunk;
+            chunk.reset( counter );
+            chunk.update( data, subtreeLength );
+            uint32_t cv[ 8 ];
+            chunk.chainingValue( cv );
+            pushCv( cv, counter );
+        } else {
+            byte children[ 2 * OUT_LENGTH ];
+            compressSubtreeToParentNode( data, subtreeLength, counter, children );
+            uint32_t cv[ 8 ];
+            for ( int i = 0; i < 8; ++i ) {
+                cv[ i ] = load32( children + 4 * i );
+            }
+            pushCv( cv, counter );
+            for ( int i = 0; i < 8; ++i ) {
+                cv[ i ] = load32( children + OUT_LENGTH + 4 * i );
+            }
+            pushCv( cv, counter + subtreeChunks / 2 );
+        }
+        counter += subtreeChunks;
+        data += subtreeLength;
+        length -= subtreeLength;
+    }
+    mChunk.reset( counter );
+    if ( length > 0 ) {
+        mChunk.update( data, length );
+        mergeCvStack( counter );
+    }
+}
+
+byte* Blake3::final() {
+    if ( mCvStackLength == 0 ) {
+        mChunk.rootHash( mDigest );
+        init();
+        return mDigest;
+    }
+
+    // the output of the last node (the partial chunk or the last two chaining values) is merged up the stack
+    byte block[ 2 * OUT_LENGTH ];
+    std::size_t remaining = mCvStackLength;
+    uint32_t cv[ 8 ];
+    if ( mChunk.length() > 0 ) {
+        mChunk.chainingValue( cv );
+    } else {
+        remaining -= 2;
+        storeCv( mCvStack[ remaining ], block );
+        storeCv( mCvStack[ remaining + 1 ], block + OUT_LENGTH );
+        if ( remaining == 0 ) {
+            parentCv( block, cv, PARENT | ROOT );
+            storeCv( cv, mDigest );
+            init();
+            return mDigest;
+        }
+        parentCv( block, cv );
+    }
+    while ( remaining > 0 ) {
+        --remaining;
+        storeCv( mCvStack[ remaining ], block );
+        storeCv( cv, block + OUT_LENGTH );
+        parentCv( block, cv, remaining == 0 ? PARENT | ROOT : PARENT );
+    }
+    storeCv( cv, mDigest );
+    init();
+    return mDigest;
+}
+
+void Blake3::pushCv( const uint32_t cv[ 8 ], uint64_t chunkCounter ) {
+    mergeCvStack( chunkCounter );
+    std::memcpy( mCvStack[ mCvStackLength++ ], cv, 8 * sizeof( uint32_t ) );
+}
+
+// Merges the completed subtrees, leaving one chaining value for each bit set in the number of chunks so far
+void Blake3::mergeCvStack( uint64_t totalChunks ) {
+    std::size_t mergedLength = 0;
+    for ( uint64_t bits = totalChunks; bits != 0; bits &= bits - 1 ) {
+        ++mergedLength;
+    }
+    while ( mCvStackLength > mergedLength ) {
+        byte block[ 2 * OUT_LENGTH ];
+        storeCv( mCvStack[ mCvStackLength - 2 ], block );
+        storeCv( mCvStack[ mCvStackLength - 1 ], block + OUT_LENGTH );
+        parentCv( block, mCvStack[ mCvStackLength - 2 ] );
+        --mCvStackLength;
+    }
+}
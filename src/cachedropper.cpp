@@ -0,0 +1,46 @@
+#include "cachedropper.hpp"
+
+#include <QFile>
+
+#include "filemapping.hpp"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#endif
+
+#define DROP_STEP 8 * 1024 * 1024 //8 MB
+#define IN_USE_WINDOW_SIZE 64 * 1024 * 1024 //64 MB, checked at the start of the file
+
+CacheDropper::CacheDropper( QFile& file, bool enabled, qint64 offset )
+    : mFile( file ), mEnabled( enabled ), mDropped( offset ), mRead( offset ) {
+#ifdef Q_OS_DARWIN
+    if ( mEnabled ) {
+        fcntl( mFile.handle(), F_NOCACHE, 1 );
+    }
+#endif
+}
+
+CacheDropper::~CacheDropper() {
+    drop( mRead );
+}
+
+void CacheDropper::advance( qint64 offset ) {
+    mRead = qMax( mRead, offset );
+    if ( mRead - mDropped >= ( DROP_STEP ) ) {
+        drop( mRead );
+    }
+}
+
+void CacheDropper::drop( qint64 offset ) {
+#if defined( Q_OS_UNIX ) && !defined( Q_OS_DARWIN )
+    if ( mEnabled && offset > mDropped ) {
+        posix_fadvise( mFile.handle(), mDropped, offset - mDropped, POSIX_FADV_DONTNEED );
+    }
+#endif
+    mDropped = offset;
+}
+
+bool CacheDropper::isInUse( QFile& file ) {
+    FileMapping mapping( file );
+    return mapping.isMappable() && mapping.isCached( 0, qMin< qint64 >( file.size(), IN_USE_WINDOW_SIZE ) );
+}
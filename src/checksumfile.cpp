@@ -0,0 +1,220 @@
+#include "checksumfile.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "util.hpp"
+
+namespace {
+    // Indexed by algorithms::Id, the number of hexadecimal digits of the results (at most, for the checksums)
+    const int HEX_LENGTHS[ algorithms::Count ] = {
+        4, 8, 16,
+        32, 32, 40,
+        56, 64, 96, 128,
+        56, 64, 96, 128,
+        48, 40,
+        32, 40, 48, 56, 64,
+        8,
+        64,
+        16, 32
+    };
+
+    // The algorithms of the untagged lines, when nothing else tells them
+    const algorithms::Id DEFAULT_IDS[] = {
+        algorithms::CRC32, algorithms::MD5, algorithms::SHA1,
+        algorithms::SHA224, algorithms::SHA256, algorithms::SHA384, algorithms::SHA512
+    };
+
+    // Tags used by other tools (BSD, xxhsum) for the supported algorithms
+    const struct {
+        const char* tag;
+        algorithms::Id id;
+    } TAG_ALIASES[] = {
+        { "rmd160", algorithms::RIPEMD160 },
+        { "xxh3", algorithms::XXH3_64 },
+        { "xxh128", algorithms::XXH3_128 }
+    };
+
+    bool matches( algorithms::Id id, const QString& hash ) {
+        return algorithms::isChecksum( id ) ? hash.size() <= HEX_LENGTHS[ id ] : hash.size() == HEX_LENGTHS[ id ];
+    }
+
+    bool isHex( const QString& text ) {
+        foreach ( QChar c, text ) {
+            if ( !( c >= QLatin1Char( '0' ) && c <= QLatin1Char( '9' ) ) && !( c >= QLatin1Char( 'a' ) && c <= QLatin1Char( 'f' ) )
+                    && !( c >= QLatin1Char( 'A' ) && c <= QLatin1Char( 'F' ) ) ) {
+                return false;
+            }
+        }
+        return !text.isEmpty();
+    }
+
+    bool fromTag( QString tag, algorithms::Id& id ) {
+        if ( algorithms::fromName( tag, id ) ) {
+            return true;
+        }
+        tag = tag.toLower().remove( QLatin1Char( '-' ) ); //SHA-256, SHA2-256 is not supported
+        for ( int i = 0; i < algorithms::Count; ++i ) {
+            if ( algorithms::name( static_cast< algorithms::Id >( i ) ).remove( QLatin1Char( '-' ) ) == tag ) {
+                id = static_cast< algorithms::Id >( i );
+                return true;
+            }
+        }
+        for ( std::size_t i = 0; i < sizeof( TAG_ALIASES ) / sizeof( TAG_ALIASES[ 0 ] ); ++i ) {
+            if ( tag == QLatin1String( TAG_ALIASES[ i ].tag ) ) {
+                id = TAG_ALIASES[ i ].id;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // The longest algorithm name contained in the name of the list, e.g. sha256 in SHA256SUMS
+    algorithms::Set fromListName( const QString& listName ) {
+        QString name = QFileInfo( listName ).fileName().toLower();
+        algorithms::Set ids;
+        int longest = 0;
+        for ( int i = 0; i < algorithms::Count; ++i ) {
+            QString algorithm = algorithms::name( static_cast< algorithms::Id >( i ) );
+            if ( algorithm.size() > longest && name.contains( algorithm ) ) {
+                ids = algorithms::Set::of( static_cast< algorithms::Id >( i ) );
+                longest = algorithm.size();
+            }
+        }
+        return ids;
+    }
+
+    bool untaggedId( const QString& hash, const algorithms::Set& hint, const algorithms::Set& listIds, algorithms::Id& id ) {
+        foreach ( algorithms::Id candidate, hint.toList() + listIds.toList() ) {
+            if ( matches( candidate, hash ) ) {
+                id = candidate;
+                return true;
+            }
+        }
+        for ( std::size_t i = 0; i < sizeof( DEFAULT_IDS ) / sizeof( DEFAULT_IDS[ 0 ] ); ++i ) {
+            if ( hash.size() == HEX_LENGTHS[ DEFAULT_IDS[ i ] ] ) {
+                id = DEFAULT_IDS[ i ];
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Reverses the escaping of the names containing backslashes or line breaks (lines starting with a backslash)
+    QString unescape( const QString& name ) {
+        QString result;
+        for ( int i = 0; i < name.size(); ++i ) {
+            if ( name.at( i ) == QLatin1Char( '\\' ) && i + 1 < name.size() ) {
+                QChar next = name.at( ++i );
+                result += next == QLatin1Char( 'n' ) ? QChar( '\n' ) : next == QLatin1Char( 'r' ) ? QChar( '\r' ) : next;
+            } else {
+                result += name.at( i );
+            }
+        }
+        return result;
+    }
+
+    // SHA256 (name) = hash, or SHA256(name)= hash as written by OpenSSL
+    bool parseTagged( const QString& line, checksumfile::Entry& entry ) {
+        int open = line.indexOf( QLatin1Char( '(' ) );
+        int close = line.lastIndexOf( QLatin1Char( ')' ) );
+        if ( open <= 0 || close < open ) {
+            return false;
+        }
+        QString rest = line.mid( close + 1 ).trimmed();
+        if ( !rest.startsWith( QLatin1Char( '=' ) ) || !fromTag( line.left( open ).trimmed(), entry.id ) ) {
+            return false;
+        }
+        entry.fileName = line.mid( open + 1, close - open - 1 );
+        entry.expected = rest.mid( 1 ).trimmed();
+        return isHex( entry.expected ) && matches( entry.id, entry.expected );
+    }
+
+    // hash, a space, a space or an asterisk (binary mode), name
+    bool parseUntagged( const QString& line, const algorithms::Set& hint, const algorithms::Set& listIds,
+                        checksumfile::Entry& entry ) {
+        int separator = line.indexOf( QLatin1Char( ' ' ) );
+        if ( separator <= 0 || separator + 2 > line.size()
+                || ( line.at( separator + 1 ) != QLatin1Char( ' ' ) && line.at( separator + 1 ) != QLatin1Char( '*' ) ) ) {
+            return false;
+        }
+        entry.expected = line.left( separator );
+        entry.fileName = line.mid( separator + 2 );
+        return isHex( entry.expected ) && untaggedId( entry.expected, hint, listIds, entry.id );
+    }
+
+    // name, a space, CRC32
+    bool parseSfv( const QString& line, checksumfile::Entry& entry ) {
+        int separator = line.lastIndexOf( QLatin1Char( ' ' ) );
+        if ( separator <= 0 ) {
+            return false;
+        }
+        entry.id = algorithms::CRC32;
+        entry.fileName = line.left( separator ).trimmed();
+        entry.expected = line.mid( separator + 1 );
+        return isHex( entry.expected ) && matches( entry.id, entry.expected );
+    }
+}
+
+int checksumfile::read( const QString& listName, const algorithms::Set& hint, QList< Entry >& entries, QString& error ) {
+    QFile list( listName );
+    if ( !list.open( QFile::ReadOnly ) ) {
+        error = list.errorString();
+        return -1;
+    }
+    QDir directory = QFileInfo( listName ).absoluteDir();
+    bool isSfv = listName.endsWith( QLatin1String( ".sfv" ), Qt::CaseInsensitive );
+    algorithms::Set listIds = fromListName( listName );
+    int malformed = 0;
+    while ( !list.atEnd() ) {
+        QString line = QString::fromUtf8( list.readLine() );
+        while ( line.endsWith( QLatin1Char( '\n' ) ) || line.endsWith( QLatin1Char( '\r' ) ) ) {
+            line.chop( 1 );
+        }
+        if ( line.trimmed().isEmpty() || ( isSfv && line.startsWith( QLatin1Char( ';' ) ) ) ) {
+            continue; //SFV comments start with a semicolon
+        }
+
+        Entry entry;
+        bool escaped = !isSfv && line.startsWith( QLatin1Char( '\\' ) );
+        if ( escaped ) {
+            line.remove( 0, 1 );
+        }
+        bool valid = isSfv ? parseSfv( line, entry ) : parseTagged( line, entry ) || parseUntagged( line, hint, listIds, entry );
+        if ( !valid || entry.fileName.isEmpty() ) {
+            ++malformed;
+            continue;
+        }
+        if ( escaped ) {
+            entry.fileName = unescape( entry.fileName );
+        }
+        entry.expected = entry.expected.toLower();
+        entry.path = directory.filePath( entry.fileName ); //unchanged if absolute
+        entries << entry;
+    }
+    return malformed;
+}
+
+QString checksumfile::checksumText( algorithms::Id id, quint64 value ) {
+    return util::checksum_hex( value, false ).rightJustified( HEX_LENGTHS[ id ], QLatin1Char( '0' ) );
+}
+
+bool checksumfile::escape( QString& fileName ) {
+    if ( !fileName.contains( QLatin1Char( '\\' ) ) && !fileName.contains( QLatin1Char( '\n' ) )
+            && !fileName.contains( QLatin1Char( '\r' ) ) ) {
+        return false;
+    }
+    fileName.replace( QLatin1String( "\\" ), QLatin1String( "\\\\" ) );
+    fileName.replace( QLatin1String( "\n" ), QLatin1String( "\\n" ) );
+    fileName.replace( QLatin1String( "\r" ), QLatin1String( "\\r" ) );
+    return true;
+}
+
+QString checksumfile::line( QString fileName, algorithms::Id id, const QString& hash, bool tagged ) {
+    QString prefix = escape( fileName ) ? QStringLiteral( "\\" ) : QString();
+    if ( tagged ) {
+        return prefix + algorithms::name( id ).toUpper() + " (" + fileName + ") = " + hash;
+    }
+    return prefix + hash + "  " + fileName;
+}
@@ -0,0 +1,129 @@
+#include "checksumverifier.hpp"
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThread>
+
+#include <memory>
+#include <vector>
+
+#include "cachedropper.hpp"
+#include "digest.hpp"
+#include "disklayout.hpp"
+
+#define BUFFER_SIZE 1024 * 1024 //1 MB
+
+using std::unique_ptr;
+
+// Verifies the entries of the queue of a device, one after the other
+class ChecksumVerifier::Task : public QRunnable {
+    public:
+        Task( ChecksumVerifier& verifier, int queue ) : mVerifier( verifier ), mQueue( queue ) {}
+
+        void run() override {
+            int entry;
+            while ( ( entry = mVerifier.next( mQueue ) ) >= 0 ) {
+                mVerifier.verify( entry );
+            }
+        }
+
+    private:
+        ChecksumVerifier& mVerifier;
+        const int mQueue;
+};
+
+ChecksumVerifier::ChecksumVerifier( QObject* parent, const QList< checksumfile::Entry >& entries )
+    : QObject( parent ), mEntries( entries ), mCacheNeutral( false ), mRemaining( 0 ), mStopped( false ) {
+    // files on different disks (or on an SSD) are read in parallel, so even one core benefits from a few threads
+    mPool.setMaxThreadCount( qMax( QThread::idealThreadCount(), 2 ) );
+}
+
+ChecksumVerifier::~ChecksumVerifier() {
+    stop();
+}
+
+void ChecksumVerifier::setCacheNeutral( bool cacheNeutral ) {
+    mCacheNeutral = cacheNeutral;
+}
+
+void ChecksumVerifier::start() {
+    mRemaining = mEntries.size();
+    //the files are read in the order of their blocks on each disk, each disk with its own queue
+    std::vector< disklayout::Location > locations;
+    foreach ( const checksumfile::Entry& entry, mEntries ) {
+        locations.push_back( disklayout::locate( entry.path ) );
+    }
+    std::vector< quint64 > devices;
+    for ( int entry : disklayout::readingOrder( locations ) ) {
+        if ( devices.empty() || devices.back() != locations[ entry ].device ) {
+            devices.push_back( locations[ entry ].device );
+            mQueues.push_back( std::deque< int >() );
+        }
+        mQueues.back().push_back( entry );
+    }
+    /* as many tasks for each queue as files its disk can read at once (one for the hard disks), the first task
+     * of every disk before the second ones, so that all the disks are read at the same time */
+    std::vector< int > tasks;
+    for ( std::size_t queue = 0; queue < mQueues.size(); ++queue ) {
+        int readers = disklayout::readers( devices[ queue ] );
+        readers = readers > 0 ? qMin( readers, mPool.maxThreadCount() ) : mPool.maxThreadCount();
+        tasks.push_back( qMin( readers, static_cast< int >( mQueues[ queue ].size() ) ) );
+    }
+    for ( int round = 0; round < mPool.maxThreadCount(); ++round ) {
+        for ( std::size_t queue = 0; queue < mQueues.size(); ++queue ) {
+            if ( round < tasks[ queue ] ) {
+                mPool.start( new Task( *this, static_cast< int >( queue ) ) );
+            }
+        }
+    }
+}
+
+void ChecksumVerifier::stop() {
+    disconnect();
+    mStopped = true;
+    mPool.clear(); //the tasks not yet started
+    mPool.waitForDone();
+}
+
+int ChecksumVerifier::next( int queue ) {
+    QMutexLocker locker( &mQueueMutex );
+    if ( mStopped || mQueues[ queue ].empty() ) {
+        return -1;
+    }
+    int entry = mQueues[ queue ].front();
+    mQueues[ queue ].pop_front();
+    return entry;
+}
+
+void ChecksumVerifier::verify( int entry ) {
+    const checksumfile::Entry& listed = mEntries.at( entry );
+    QFile file( listed.path );
+    if ( !file.open( QFile::ReadOnly ) ) {
+        emit entryVerified( entry, file.exists() ? Unreadable : Missing, file.errorString() );
+    } else {
+        unique_ptr< Digest > digest = std::move( Digest::create( algorithms::Set::of( listed.id ) ).front() );
+        CacheDropper dropper( file, mCacheNeutral && !CacheDropper::isInUse( file ) );
+        std::vector< char > buffer( BUFFER_SIZE );
+        qint64 length;
+        while ( ( length = file.read( buffer.data(), static_cast< qint64 >( buffer.size() ) ) ) > 0 && !mStopped ) {
+            digest->addData( buffer.data(), static_cast< int >( length ) );
+            dropper.advance( file.pos() );
+        }
+        if ( mStopped ) {
+            return;
+        }
+        if ( length < 0 ) {
+            emit entryVerified( entry, Unreadable, file.errorString() );
+        } else if ( algorithms::isChecksum( listed.id ) ) {
+            bool match = digest->checksum( listed.id ) == listed.expected.toULongLong( nullptr, 16 );
+            emit entryVerified( entry, match ? Ok : Failed, QString() );
+        } else {
+            bool match = digest->result( listed.id ) == QByteArray::fromHex( listed.expected.toLatin1() );
+            emit entryVerified( entry, match ? Ok : Failed, QString() );
+        }
+    }
+    if ( --mRemaining == 0 ) {
+        emit finished();
+    }
+}
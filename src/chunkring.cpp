@@ -0,0 +1,71 @@
+#include "chunkring.hpp"
+
+ChunkRing::ChunkRing( int chunkCount, int chunkSize, int consumerCount )
+    : mChunkSize( chunkSize ), mConsumerCount( consumerCount ), mSlots( chunkCount ),
+      mReadSequence( consumerCount, 0 ), mWriteSequence( 0 ), mAborted( false ) {
+    for ( Slot& slot : mSlots ) {
+        slot.buffer.resize( chunkSize );
+        slot.data = slot.buffer.data();
+        slot.length = 0;
+        slot.pending = 0;
+    }
+}
+
+char* ChunkRing::acquireWrite() {
+    QMutexLocker locker( &mMutex );
+    Slot& slot = mSlots[ mWriteSequence % mSlots.size() ];
+    while ( !mAborted && slot.pending > 0 ) {
+        mChunkReleased.wait( &mMutex );
+    }
+    return mAborted ? nullptr : slot.buffer.data();
+}
+
+int ChunkRing::tryAcquireWrite( int ahead ) {
+    QMutexLocker locker( &mMutex );
+    int slot = static_cast< int >( ( mWriteSequence + ahead ) % mSlots.size() );
+    return ( mAborted || ahead >= chunkCount() || mSlots[ slot ].pending > 0 ) ? -1 : slot;
+}
+
+void ChunkRing::commitWrite( int length ) {
+    commitWrite( mSlots[ mWriteSequence % mSlots.size() ].buffer.data(), length );
+}
+
+void ChunkRing::commitWrite( const char* data, int length ) {
+    QMutexLocker locker( &mMutex );
+    Slot& slot = mSlots[ mWriteSequence % mSlots.size() ];
+    slot.data = data;
+    slot.length = length;
+    slot.pending = mConsumerCount;
+    ++mWriteSequence;
+}
+
+bool ChunkRing::acquireRead( int consumer, Chunk& chunk ) {
+    QMutexLocker locker( &mMutex );
+    if ( mAborted || mReadSequence[ consumer ] == mWriteSequence ) {
+        return false;
+    }
+    const Slot& slot = mSlots[ mReadSequence[ consumer ] % mSlots.size() ];
+    chunk.data = slot.data;
+    chunk.length = slot.length;
+    return true;
+}
+
+bool ChunkRing::hasChunk( int consumer ) {
+    QMutexLocker locker( &mMutex );
+    return !mAborted && mReadSequence[ consumer ] != mWriteSequence;
+}
+
+void ChunkRing::releaseRead( int consumer ) {
+    QMutexLocker locker( &mMutex );
+    Slot& slot = mSlots[ mReadSequence[ consumer ] % mSlots.size() ];
+    ++mReadSequence[ consumer ];
+    if ( --slot.pending == 0 ) {
+        mChunkReleased.wakeAll();
+    }
+}
+
+void ChunkRing::abort() {
+    QMutexLocker locker( &mMutex );
+    mAborted = true;
+    mChunkReleased.wakeAll();
+}
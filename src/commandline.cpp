@@ -0,0 +1,316 @@
+#include "commandline.hpp"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QLoggingCategory>
+
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+#include "batchhashcalculator.hpp"
+#include "batchqueue.hpp"
+#include "checksumverifier.hpp"
+#include "directorywalker.hpp"
+#include "disklayout.hpp"
+#include "filehashcalculator.hpp"
+#include "multibuffer.hpp"
+#include "util.hpp"
+
+// deprecated by Qt 5.14, which moved them to the Qt namespace
+#if QT_VERSION >= QT_VERSION_CHECK( 5, 14, 0 )
+#define SKIP_EMPTY_PARTS Qt::SkipEmptyParts
+#define ENDL Qt::endl
+#else
+#define SKIP_EMPTY_PARTS QString::SkipEmptyParts
+#define ENDL endl
+#endif
+
+CommandLine::CommandLine( QObject* parent ) : QObject( parent ), mBsdStyle( false ), mNextResult( 0 ), mStatus( 0 ),
+    mOut( stdout ), mErr( stderr ), mQuiet( false ), mMalformedLines( 0 ), mMismatches( 0 ), mUnreadable( 0 ) {
+}
+
+CommandLine::~CommandLine() {}
+
+bool CommandLine::isRequested( int argc, char* argv[] ) {
+    for ( int i = 1; i < argc; ++i ) {
+        // the Finder of older OS X versions starts applications with a -psn_ (process serial number) argument
+        if ( argv[ i ][ 0 ] == '-' && argv[ i ][ 1 ] != '\0' && std::strncmp( argv[ i ], "-psn_", 5 ) != 0 ) {
+            return true;
+        }
+    }
+    return false;
+}
+
+int CommandLine::exec() {
+#ifdef Q_OS_WIN
+    // Mr. Hash is a GUI application, with no console of its own: it writes to the one of the command prompt
+    if ( GetStdHandle( STD_OUTPUT_HANDLE ) == NULL && AttachConsole( ATTACH_PARENT_PROCESS ) ) {
+        std::freopen( "CONOUT$", "w", stdout );
+        std::freopen( "CONOUT$", "w", stderr );
+    }
+#endif
+    // the kernels are reported only when asked through QT_LOGGING_RULES, to keep stderr for the errors
+    QLoggingCategory::setFilterRules( QStringLiteral( "mrhash.kernels.info=false" ) );
+    QCoreApplication::setApplicationVersion( QString( "%1.%2.%3" ).arg( MAJOR_VER ).arg( MINOR_VER ).arg( PATCH_VER ) );
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription( tr( "Calculates the hashes of the given files." ) );
+    parser.addHelpOption();
+    parser.addVersionOption();
+    QCommandLineOption algorithmsOption( QStringList() << "a" << "algorithms",
+                                         tr( "Comma-separated list of the algorithms to calculate, among %1." )
+                                         .arg( algorithms::toNames( algorithms::Set::all() ).join( ", " ) ),
+                                         tr( "list" ), QStringLiteral( "sha256" ) );
+    QCommandLineOption tagOption( "tag", tr( "Print BSD-style lines (always used with more than one algorithm)." ) );
+    QCommandLineOption checkOption( QStringList() << "c" << "check",
+                                    tr( "Verify the files listed in GNU, BSD-style or SFV checksum lists; the algorithm "
+                                        "of the untagged lines is the one given with -a, or the one in the name of the list." ) );
+    QCommandLineOption quietOption( "quiet", tr( "With --check, do not print OK for each file verified successfully." ) );
+    QCommandLineOption recursiveOption( QStringList() << "r" << "recursive",
+                                        tr( "Hash the files in the given directories and in their subdirectories, in sorted order." ) );
+    QCommandLineOption cacheNeutralOption( "cache-neutral",
+                                           tr( "Drop the files read from the page cache, unless another program is using them." ) );
+    QCommandLineOption hddReadersOption( "hdd-readers",
+                                         tr( "Number of files read at once from each hard disk, 0 for no limit (default 1)." ),
+                                         tr( "n" ) );
+    parser.addOption( algorithmsOption );
+    parser.addOption( tagOption );
+    parser.addOption( checkOption );
+    parser.addOption( quietOption );
+    parser.addOption( recursiveOption );
+    parser.addOption( cacheNeutralOption );
+    parser.addOption( hddReadersOption );
+    parser.addPositionalArgument( "files", tr( "The files to hash, or the checksum lists to verify." ), tr( "file..." ) );
+    parser.process( *QCoreApplication::instance() ); //exits on --help, --version and unknown options
+
+    algorithms::Id id;
+    foreach ( const QString& name, parser.values( algorithmsOption ).join( ',' ).split( ',', SKIP_EMPTY_PARTS ) ) {
+        if ( !algorithms::fromName( name.trimmed(), id ) ) {
+            mErr << QCoreApplication::applicationName() << ": " << tr( "unknown algorithm '%1'" ).arg( name ) << ENDL;
+            return 1;
+        }
+        mAlgorithms.insert( id );
+    }
+    if ( parser.isSet( hddReadersOption ) ) {
+        bool valid;
+        int readers = parser.value( hddReadersOption ).toInt( &valid );
+        if ( !valid || readers < 0 ) {
+            mErr << QCoreApplication::applicationName() << ": " << tr( "invalid number of readers '%1'" )
+                 .arg( parser.value( hddReadersOption ) ) << ENDL;
+            return 1;
+        }
+        disklayout::setReaders( disklayout::Rotational, readers );
+    }
+    mFileNames = parser.positionalArguments();
+    if ( mAlgorithms.isEmpty() || mFileNames.isEmpty() ) {
+        mErr << QCoreApplication::applicationName() << ": " << tr( "no algorithms or no files given" ) << ENDL;
+        return 1;
+    }
+    if ( parser.isSet( checkOption ) ) {
+        mQuiet = parser.isSet( quietOption );
+        return check( mFileNames, parser.isSet( algorithmsOption ) ? mAlgorithms : algorithms::Set(),
+                      parser.isSet( cacheNeutralOption ) );
+    }
+    if ( parser.isSet( recursiveOption ) ) {
+        mFileNames = expand( mFileNames );
+        if ( mFileNames.isEmpty() ) {
+            return mStatus; //only empty directories
+        }
+    }
+    mBsdStyle = parser.isSet( tagOption ) || mAlgorithms.toList().size() > 1;
+    mResults.resize( mFileNames.size() );
+
+    if ( mFileNames.size() == 1 ) {
+        mFileCalculator.reset( new FileHashCalculator( this, mFileNames.first(), mAlgorithms ) );
+        mFileCalculator->setCacheNeutral( parser.isSet( cacheNeutralOption ) );
+        connect( mFileCalculator.get(), SIGNAL( newHashString( int, QByteArray ) ), this, SLOT( on_newHashString( int, QByteArray ) ) );
+        connect( mFileCalculator.get(), SIGNAL( newChecksumValue( int, quint64 ) ), this, SLOT( on_newChecksumValue( int, quint64 ) ) );
+        connect( mFileCalculator.get(), SIGNAL( failed( QString ) ), this, SLOT( on_failed( QString ) ) );
+        connect( mFileCalculator.get(), SIGNAL( finished() ), this, SLOT( on_finished() ) );
+        mFileCalculator->start();
+    } else if ( isMultiBuffer( mAlgorithms ) ) {
+        mBatchCalculator.reset( new BatchHashCalculator( this, mFileNames, mAlgorithms ) );
+        mBatchCalculator->setCacheNeutral( parser.isSet( cacheNeutralOption ) );
+        connect( mBatchCalculator.get(), SIGNAL( newHashString( int, int, QByteArray ) ), this, SLOT( on_newHashString( int, int, QByteArray ) ) );
+        connect( mBatchCalculator.get(), SIGNAL( newChecksumValue( int, int, quint64 ) ), this, SLOT( on_newChecksumValue( int, int, quint64 ) ) );
+        connect( mBatchCalculator.get(), SIGNAL( fileHashed( int ) ), this, SLOT( on_fileHashed( int ) ) );
+        connect( mBatchCalculator.get(), SIGNAL( fileFailed( int, QString ) ), this, SLOT( on_fileFailed( int, QString ) ) );
+        connect( mBatchCalculator.get(), SIGNAL( finished() ), this, SLOT( on_finished() ) );
+        mBatchCalculator->start();
+    } else {
+        mQueue.reset( new BatchQueue( this, mAlgorithms ) );
+        connect( mQueue.get(), SIGNAL( newHashString( int, int, QByteArray ) ), this, SLOT( on_newHashString( int, int, QByteArray ) ) );
+        connect( mQueue.get(), SIGNAL( newChecksumValue( int, int, quint64 ) ), this, SLOT( on_newChecksumValue( int, int, quint64 ) ) );
+        connect( mQueue.get(), SIGNAL( fileFailed( int, QString ) ), this, SLOT( on_fileFailed( int, QString ) ) );
+        connect( mQueue.get(), SIGNAL( fileEnded( int ) ), this, SLOT( on_fileHashed( int ) ) ); //the failed ones too
+        connect( mQueue.get(), SIGNAL( finished() ), this, SLOT( on_finished() ) );
+        foreach ( const QString& fileName, mFileNames ) {
+            mQueue->enqueue( fileName, QString(), parser.isSet( cacheNeutralOption ) );
+        }
+    }
+    return QCoreApplication::exec();
+}
+
+bool CommandLine::isMultiBuffer( const algorithms::Set& selected ) {
+    foreach ( algorithms::Id id, selected.toList() ) {
+        if ( !multibuffer::Lanes::supports( id ) ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+QStringList CommandLine::expand( const QStringList& names ) {
+    QStringList fileNames;
+    foreach ( const QString& name, names ) {
+        if ( !QFileInfo( name ).isDir() ) {
+            fileNames << name;
+            continue;
+        }
+        // the whole tree is listed before hashing, so that the output is sorted
+        DirectoryWalker walker( 0, QStringList() << name );
+        walker.start();
+        walker.wait();
+        foreach ( const QString& error, walker.errors() ) {
+            mErr << QCoreApplication::applicationName() << ": " << error << ENDL;
+            mStatus = 1;
+        }
+        fileNames += walker.files();
+    }
+    return fileNames;
+}
+
+int CommandLine::check( const QStringList& listNames, const algorithms::Set& hint, bool cacheNeutral ) {
+    foreach ( const QString& listName, listNames ) {
+        QString error;
+        int malformed = checksumfile::read( listName, hint, mEntries, error );
+        if ( malformed < 0 ) {
+            mErr << QCoreApplication::applicationName() << ": " << listName << ": " << error << ENDL;
+            mStatus = 1;
+        } else {
+            mMalformedLines += malformed;
+        }
+    }
+    if ( mEntries.isEmpty() ) {
+        mErr << QCoreApplication::applicationName() << ": " << tr( "no properly formatted checksum lines found" ) << ENDL;
+        return 1;
+    }
+
+    mVerifier.reset( new ChecksumVerifier( this, mEntries ) );
+    mVerifier->setCacheNeutral( cacheNeutral );
+    connect( mVerifier.get(), SIGNAL( entryVerified( int, int, QString ) ), this, SLOT( on_entryVerified( int, int, QString ) ) );
+    connect( mVerifier.get(), SIGNAL( finished() ), this, SLOT( on_finished() ) );
+    mVerifier->start();
+    return QCoreApplication::exec();
+}
+
+void CommandLine::on_entryVerified( int entry, int result, QString error ) {
+    QString status;
+    switch ( result ) {
+        case ChecksumVerifier::Ok:
+            status = mQuiet ? QString() : QStringLiteral( "OK" );
+            break;
+        case ChecksumVerifier::Failed:
+            status = QStringLiteral( "FAILED" );
+            ++mMismatches;
+            break;
+        case ChecksumVerifier::Missing:
+            status = QStringLiteral( "MISSING" );
+            ++mUnreadable;
+            break;
+        default:
+            status = QStringLiteral( "FAILED open or read" );
+            mErr << QCoreApplication::applicationName() << ": " << mEntries.at( entry ).fileName << ": " << error << ENDL;
+            ++mUnreadable;
+            break;
+    }
+    if ( !status.isEmpty() ) {
+        QString name = mEntries.at( entry ).fileName;
+        if ( checksumfile::escape( name ) ) {
+            mOut << '\\';
+        }
+        mOut << name << ": " << status << '\n';
+        mOut.flush();
+    }
+}
+
+void CommandLine::on_newHashString( int id, QByteArray hash ) {
+    on_newHashString( 0, id, hash );
+}
+
+void CommandLine::on_newChecksumValue( int id, quint64 value ) {
+    on_newChecksumValue( 0, id, value );
+}
+
+void CommandLine::on_failed( QString error ) {
+    on_fileFailed( 0, error );
+}
+
+void CommandLine::on_newHashString( int file, int id, QByteArray hash ) {
+    mResults[ file ].hashes.insert( id, util::hash_hex( hash, false ) );
+}
+
+void CommandLine::on_newChecksumValue( int file, int id, quint64 value ) {
+    mResults[ file ].hashes.insert( id, checksumfile::checksumText( static_cast< algorithms::Id >( id ), value ) );
+}
+
+void CommandLine::on_fileHashed( int file ) {
+    mResults[ file ].done = true;
+    printReady();
+}
+
+void CommandLine::on_fileFailed( int file, QString error ) {
+    mResults[ file ].error = error;
+    mResults[ file ].done = true;
+    printReady();
+}
+
+void CommandLine::on_finished() {
+    if ( mVerifier != nullptr ) {
+        QString application = QCoreApplication::applicationName();
+        if ( mMalformedLines > 0 ) {
+            mErr << application << ": " << tr( "WARNING: %n line(s) improperly formatted", "", mMalformedLines ) << ENDL;
+        }
+        if ( mUnreadable > 0 ) {
+            mErr << application << ": " << tr( "WARNING: %n listed file(s) could not be read", "", mUnreadable ) << ENDL;
+        }
+        if ( mMismatches > 0 ) {
+            mErr << application << ": " << tr( "WARNING: %n computed checksum(s) did NOT match", "", mMismatches ) << ENDL;
+        }
+        QCoreApplication::exit( mStatus != 0 || mUnreadable > 0 || mMismatches > 0 ? 1 : 0 );
+        return;
+    }
+    // FileHashCalculator has no signal for the end of a single file
+    for ( int i = mNextResult; i < mResults.size(); ++i ) {
+        mResults[ i ].done = true;
+    }
+    printReady();
+    QCoreApplication::exit( mStatus );
+}
+
+void CommandLine::printReady() {
+    // the files hashed together may end in any order
+    while ( mNextResult < mResults.size() && mResults[ mNextResult ].done ) {
+        printResult( mFileNames.at( mNextResult ), mResults[ mNextResult ] );
+        mResults[ mNextResult ].hashes.clear(); //no longer needed
+        ++mNextResult;
+    }
+    mOut.flush();
+}
+
+void CommandLine::printResult( const QString& fileName, const Result& result ) {
+    if ( !result.error.isEmpty() ) {
+        mOut.flush();
+        mErr << QCoreApplication::applicationName() << ": " << fileName << ": " << result.error << ENDL;
+        mStatus = 1;
+        return;
+    }
+    for ( QMap< int, QString >::const_iterator it = result.hashes.constBegin(); it != result.hashes.constEnd(); ++it ) {
+        mOut << checksumfile::line( fileName, static_cast< algorithms::Id >( it.key() ), it.value(), mBsdStyle ) << '\n';
+    }
+}
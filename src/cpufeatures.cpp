@@ -0,0 +1,74 @@
+#include "cpufeatures.hpp"
+
+#ifdef MRHASH_X86_64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace {
+#ifdef MRHASH_X86_64
+    void cpuid( unsigned int leaf, unsigned int subleaf, unsigned int regs[4] ) {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuidex( info, leaf, subleaf );
+        for ( int i = 0; i < 4; ++i ) {
+            regs[i] = static_cast< unsigned int >( info[i] );
+        }
+#else
+        __cpuid_count( leaf, subleaf, regs[0], regs[1], regs[2], regs[3] );
+#endif
+    }
+
+    unsigned long long xgetbv() {
+#ifdef _MSC_VER
+        return _xgetbv( 0 );
+#else
+        unsigned int eax, edx;
+        __asm__( "xgetbv" : "=a"( eax ), "=d"( edx ) : "c"( 0 ) );
+        return ( static_cast< unsigned long long >( edx ) << 32 ) | eax;
+#endif
+    }
+#endif
+
+    cpu::Features detect() {
+        cpu::Features features = { false, false, false, false, false, false, false };
+#ifdef MRHASH_X86_64
+        unsigned int regs[4];
+        cpuid( 0, 0, regs );
+        unsigned int maxLeaf = regs[0];
+
+        cpuid( 1, 0, regs );
+        features.sse41 = ( regs[2] & ( 1u << 19 ) ) != 0;
+        features.sse42 = ( regs[2] & ( 1u << 20 ) ) != 0;
+        features.pclmul = ( regs[2] & ( 1u << 1 ) ) != 0;
+        bool osxsave = ( regs[2] & ( 1u << 27 ) ) != 0;
+        bool avx = ( regs[2] & ( 1u << 28 ) ) != 0;
+
+        // the OS must save the YMM (and, for AVX-512, the ZMM and opmask) registers
+        unsigned long long xcr0 = osxsave ? xgetbv() : 0;
+        bool ymmEnabled = ( xcr0 & 0x06 ) == 0x06;
+        bool zmmEnabled = ( xcr0 & 0xE6 ) == 0xE6;
+
+        if ( maxLeaf >= 7 ) {
+            cpuid( 7, 0, regs );
+            features.avx2 = avx && ymmEnabled && ( regs[1] & ( 1u << 5 ) ) != 0;
+            features.avx512 = zmmEnabled && ( regs[1] & ( 1u << 16 ) ) != 0 && ( regs[1] & ( 1u << 31 ) ) != 0;
+            features.sha = ( regs[1] & ( 1u << 29 ) ) != 0;
+            features.bmi2 = ( regs[1] & ( 1u << 8 ) ) != 0;
+        }
+#endif
+        return features;
+    }
+}
+
+namespace cpu {
+    Q_LOGGING_CATEGORY( kernels, "mrhash.kernels" )
+}
+
+const cpu::Features& cpu::features() {
+    static const Features detected = detect();
+    return detected;
+}
@@ -4,25 +4,360 @@
 #include <QDebug>
 #endif
 
-#include "boost/crc.hpp"
+#include <QtEndian>
 
-boost_crc16 crc16_calc;
-boost_crc32 crc32_calc;
-boost_crc64 crc64_calc;
+#include <cstring>
+#include <stdexcept>
+
+#include "cpufeatures.hpp"
+
+#ifdef MRHASH_X86_64
+#include <emmintrin.h>
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+#endif
+
+namespace {
+    const quint64 CASTAGNOLI = 0x1edc6f41;
+
+    quint64 reflect( quint64 value, int width ) {
+        quint64 result = 0;
+        for ( int i = 0; i < width; ++i ) {
+            result |= ( ( value >> i ) & 1 ) << ( width - 1 - i );
+        }
+        return result;
+    }
+
+#ifdef MRHASH_X86_64
+    // x^exponent mod P, in normal bit order
+    quint64 xPowMod( int exponent, quint64 polynomial, int width ) {
+        const quint64 top = quint64( 1 ) << ( width - 1 );
+        const quint64 mask = top | ( top - 1 );
+        quint64 result = 1;
+        for ( int i = 0; i < exponent; ++i ) {
+            bool carry = ( result & top ) != 0;
+            result = ( result << 1 ) & mask;
+            if ( carry ) {
+                result ^= polynomial;
+            }
+        }
+        return result;
+    }
+
+    /* Constants to move a 128 bit block forward by distance bits: with reflected operands, the low qword
+     * (the first eight bytes) is multiplied by x^(distance + 63) mod P and the high one by x^(distance - 1) mod P. */
+    __m128i foldConstants( int distance, quint64 polynomial, int width ) {
+        quint64 low = reflect( xPowMod( distance + 63, polynomial, width ), 64 );
+        quint64 high = reflect( xPowMod( distance - 1, polynomial, width ), 64 );
+        return _mm_set_epi64x( static_cast< long long >( high ), static_cast< long long >( low ) );
+    }
+#endif
+
+    // Polynomial is the normal (not reflected) generator polynomial
+    template< typename T, quint64 Polynomial >
+    struct Engine {
+        enum { WIDTH = sizeof( T ) * 8, SLICES = sizeof( T ) == 2 ? 8 : 16 };
+
+        // table[ s ][ b ] is the CRC of the byte b followed by s zero bytes
+        T table[ SLICES ][ 256 ];
+#ifdef MRHASH_X86_64
+        __m128i fold128;
+        __m128i fold512;
+#endif
+
+        Engine() {
+            const T reflected = static_cast< T >( reflect( Polynomial, WIDTH ) );
+            for ( int b = 0; b < 256; ++b ) {
+                T crc = static_cast< T >( b );
+                for ( int bit = 0; bit < 8; ++bit ) {
+                    crc = static_cast< T >( ( crc & 1 ) ? ( crc >> 1 ) ^ reflected : crc >> 1 );
+                }
+                table[ 0 ][ b ] = crc;
+            }
+            for ( int s = 1; s < SLICES; ++s ) {
+                for ( int b = 0; b < 256; ++b ) {
+                    T previous = table[ s - 1 ][ b ];
+                    table[ s ][ b ] = static_cast< T >( ( previous >> 8 ) ^ table[ 0 ][ previous & 0xff ] );
+                }
+            }
+#ifdef MRHASH_X86_64
+            fold128 = foldConstants( 128, Polynomial, WIDTH );
+            fold512 = foldConstants( 512, Polynomial, WIDTH );
+#endif
+        }
+    };
+
+    template< typename T, quint64 Polynomial >
+    const Engine< T, Polynomial >& engine() {
+        static const Engine< T, Polynomial > instance;
+        return instance;
+    }
+
+    inline quint64 load64( const uchar* data ) {
+        quint64 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    // XOR of the lookups of the eight bytes of value, the first byte going to table[ first + 7 ]
+    template< typename T, int Slices >
+    inline T lookup8( const T ( &table )[ Slices ][ 256 ], int first, quint64 value ) {
+        return static_cast< T >( table[ first + 7 ][ value & 0xff ] ^
+                                 table[ first + 6 ][ ( value >> 8 ) & 0xff ] ^
+                                 table[ first + 5 ][ ( value >> 16 ) & 0xff ] ^
+                                 table[ first + 4 ][ ( value >> 24 ) & 0xff ] ^
+                                 table[ first + 3 ][ ( value >> 32 ) & 0xff ] ^
+                                 table[ first + 2 ][ ( value >> 40 ) & 0xff ] ^
+                                 table[ first + 1 ][ ( value >> 48 ) & 0xff ] ^
+                                 table[ first ][ value >> 56 ] );
+    }
+
+    template< typename T, class Tables >
+    T updateBytewise( const Tables& engine, T crc, const uchar* data, std::size_t length ) {
+        while ( length-- ) {
+            crc = static_cast< T >( engine.table[ 0 ][ ( crc ^ *data++ ) & 0xff ] ^ ( crc >> 8 ) );
+        }
+        return crc;
+    }
+
+    template< quint64 Polynomial >
+    quint16 updateSliced( const Engine< quint16, Polynomial >& engine, quint16 crc, const uchar* data, std::size_t length ) {
+        for ( ; length >= 8; data += 8, length -= 8 ) {
+            crc = lookup8( engine.table, 0, load64( data ) ^ crc );
+        }
+        return updateBytewise( engine, crc, data, length );
+    }
+
+    template< typename T, quint64 Polynomial >
+    T updateSliced( const Engine< T, Polynomial >& engine, T crc, const uchar* data, std::size_t length ) {
+        for ( ; length >= 16; data += 16, length -= 16 ) {
+            crc = lookup8( engine.table, 8, load64( data ) ^ crc ) ^ lookup8( engine.table, 0, load64( data + 8 ) );
+        }
+        return updateBytewise( engine, crc, data, length );
+    }
+
+#ifdef MRHASH_X86_64
+    // Below this length the setup and the final reduction of the folding are not worth it
+    const std::size_t FOLD_MIN_LENGTH = 256;
+
+    MRHASH_TARGET( "sse2,pclmul" )
+    inline __m128i fold( __m128i block, __m128i constants ) {
+        return _mm_xor_si128( _mm_clmulepi64_si128( block, constants, 0x00 ),
+                              _mm_clmulepi64_si128( block, constants, 0x11 ) );
+    }
+
+    MRHASH_TARGET( "sse2,pclmul" )
+    inline __m128i load128( const uchar* data ) {
+        return _mm_loadu_si128( reinterpret_cast< const __m128i* >( data ) );
+    }
+
+    /* Folds four independent 128 bit accumulators across the input, then reduces them to a single block
+     * whose CRC (with a zero register) is the register of the whole folded prefix. */
+    template< typename T, quint64 Polynomial >
+    MRHASH_TARGET( "sse2,pclmul" )
+    T updateFolded( const Engine< T, Polynomial >& engine, T crc, const uchar* data, std::size_t length ) {
+        __m128i x0 = _mm_xor_si128( load128( data ), _mm_cvtsi64_si128( static_cast< long long >( crc ) ) );
+        __m128i x1 = load128( data + 16 );
+        __m128i x2 = load128( data + 32 );
+        __m128i x3 = load128( data + 48 );
+        data += 64;
+        length -= 64;
+
+        for ( ; length >= 64; data += 64, length -= 64 ) {
+            x0 = _mm_xor_si128( fold( x0, engine.fold512 ), load128( data ) );
+            x1 = _mm_xor_si128( fold( x1, engine.fold512 ), load128( data + 16 ) );
+            x2 = _mm_xor_si128( fold( x2, engine.fold512 ), load128( data + 32 ) );
+            x3 = _mm_xor_si128( fold( x3, engine.fold512 ), load128( data + 48 ) );
+        }
+
+        __m128i x = _mm_xor_si128( fold( x0, engine.fold128 ), x1 );
+        x = _mm_xor_si128( fold( x, engine.fold128 ), x2 );
+        x = _mm_xor_si128( fold( x, engine.fold128 ), x3 );
+        for ( ; length >= 16; data += 16, length -= 16 ) {
+            x = _mm_xor_si128( fold( x, engine.fold128 ), load128( data ) );
+        }
+
+        uchar block[ 16 ];
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( block ), x );
+        crc = updateSliced( engine, T( 0 ), block, sizeof( block ) );
+        return updateBytewise( engine, crc, data, length );
+    }
+#endif
+
+    // a * b mod P, with both the operands and the result reflected (x^0 is the most significant bit)
+    template< typename T, quint64 Polynomial >
+    T multiplyMod( T a, T b ) {
+        const T reflected = static_cast< T >( reflect( Polynomial, sizeof( T ) * 8 ) );
+        T product = 0;
+        for ( T bit = static_cast< T >( T( 1 ) << ( sizeof( T ) * 8 - 1 ) ); bit != 0; bit = static_cast< T >( bit >> 1 ) ) {
+            if ( a & bit ) {
+                product ^= b;
+            }
+            b = static_cast< T >( ( b & 1 ) ? ( b >> 1 ) ^ reflected : b >> 1 );
+        }
+        return product;
+    }
+
+    // x^(8 length) mod P, reflected: repeated squaring of x^8, going through the bits of length
+    template< typename T, quint64 Polynomial >
+    T powerOfX8( quint64 length ) {
+        T result = static_cast< T >( T( 1 ) << ( sizeof( T ) * 8 - 1 ) ); // x^0
+        T power = static_cast< T >( T( 1 ) << ( sizeof( T ) * 8 - 9 ) ); // x^8
+        for ( ; length != 0; length >>= 1 ) {
+            if ( length & 1 ) {
+                result = multiplyMod< T, Polynomial >( result, power );
+            }
+            power = multiplyMod< T, Polynomial >( power, power );
+        }
+        return result;
+    }
+
+#ifdef MRHASH_X86_64
+    /* CRC-32C with the SSE 4.2 crc32 instruction: its latency is three times its throughput, so the input is
+     * processed as three interleaved streams (starting from a zero register), which are then joined shifting
+     * the registers of the first ones by the length of the streams that follow. */
+    const std::size_t LONG_STREAM = 8192;
+    const std::size_t SHORT_STREAM = 256;
+
+    struct Castagnoli {
+        // multiplications by x^(8 length) mod P, one table for each byte of the register
+        quint32 shiftLong[ 4 ][ 256 ];
+        quint32 shiftShort[ 4 ][ 256 ];
+
+        Castagnoli() {
+            quint32 powerLong = powerOfX8< quint32, CASTAGNOLI >( LONG_STREAM );
+            quint32 powerShort = powerOfX8< quint32, CASTAGNOLI >( SHORT_STREAM );
+            for ( int k = 0; k < 4; ++k ) {
+                for ( quint32 b = 0; b < 256; ++b ) {
+                    shiftLong[ k ][ b ] = multiplyMod< quint32, CASTAGNOLI >( b << ( 8 * k ), powerLong );
+                    shiftShort[ k ][ b ] = multiplyMod< quint32, CASTAGNOLI >( b << ( 8 * k ), powerShort );
+                }
+            }
+        }
+
+        static const Castagnoli& instance() {
+            static const Castagnoli castagnoli;
+            return castagnoli;
+        }
+    };
+
+    inline quint32 shift( const quint32 ( &table )[ 4 ][ 256 ], quint32 crc ) {
+        return table[ 0 ][ crc & 0xff ] ^ table[ 1 ][ ( crc >> 8 ) & 0xff ] ^
+               table[ 2 ][ ( crc >> 16 ) & 0xff ] ^ table[ 3 ][ crc >> 24 ];
+    }
+
+    MRHASH_TARGET( "sse4.2" )
+    inline quint32 updateStreams( const quint32 ( &table )[ 4 ][ 256 ], std::size_t streamLength,
+                                  quint32 crc, const uchar*& data, std::size_t& length ) {
+        for ( ; length >= 3 * streamLength; data += 3 * streamLength, length -= 3 * streamLength ) {
+            quint64 crc0 = crc;
+            quint64 crc1 = 0;
+            quint64 crc2 = 0;
+            for ( std::size_t i = 0; i < streamLength; i += 8 ) {
+                crc0 = _mm_crc32_u64( crc0, load64( data + i ) );
+                crc1 = _mm_crc32_u64( crc1, load64( data + streamLength + i ) );
+                crc2 = _mm_crc32_u64( crc2, load64( data + 2 * streamLength + i ) );
+            }
+            crc = shift( table, static_cast< quint32 >( crc0 ) ) ^ static_cast< quint32 >( crc1 );
+            crc = shift( table, crc ) ^ static_cast< quint32 >( crc2 );
+        }
+        return crc;
+    }
+
+    MRHASH_TARGET( "sse4.2" )
+    quint32 updateHardware( quint32 crc, const uchar* data, std::size_t length ) {
+        const Castagnoli& castagnoli = Castagnoli::instance();
+        crc = updateStreams( castagnoli.shiftLong, LONG_STREAM, crc, data, length );
+        crc = updateStreams( castagnoli.shiftShort, SHORT_STREAM, crc, data, length );
+        quint64 crc64 = crc;
+        for ( ; length >= 8; data += 8, length -= 8 ) {
+            crc64 = _mm_crc32_u64( crc64, load64( data ) );
+        }
+        crc = static_cast< quint32 >( crc64 );
+        while ( length-- ) {
+            crc = _mm_crc32_u8( crc, *data++ );
+        }
+        return crc;
+    }
+#endif
+
+    // Selects the fastest implementation for each CRC
+    template< typename T, quint64 Polynomial >
+    struct Kernel {
+        static T update( T crc, const uchar* data, std::size_t length ) {
+            const Engine< T, Polynomial >& tables = engine< T, Polynomial >();
+#ifdef MRHASH_X86_64
+            if ( length >= FOLD_MIN_LENGTH && cpu::features().pclmul ) {
+                return updateFolded( tables, crc, data, length );
+            }
+#endif
+            return updateSliced( tables, crc, data, length );
+        }
+    };
+
+    template< quint64 Polynomial >
+    struct Kernel< quint16, Polynomial > {
+        static quint16 update( quint16 crc, const uchar* data, std::size_t length ) {
+            return updateSliced( engine< quint16, Polynomial >(), crc, data, length );
+        }
+    };
+
+    template<>
+    struct Kernel< quint32, CASTAGNOLI > {
+        static quint32 update( quint32 crc, const uchar* data, std::size_t length ) {
+#ifdef MRHASH_X86_64
+            if ( cpu::features().sse42 ) {
+                return updateHardware( crc, data, length );
+            }
+#endif
+            return updateSliced( engine< quint32, CASTAGNOLI >(), crc, data, length );
+        }
+    };
+}
+
+template< typename T, quint64 Polynomial >
+T crc::update( T crc, const void* data, std::size_t length ) {
+    return Kernel< T, Polynomial >::update( crc, static_cast< const uchar* >( data ), length );
+}
+
+// With init == xorout, crc(AB) = crc(A) * x^(8 |B|) + crc(B) mod P
+template< typename T, quint64 Polynomial >
+T crc::combine( T first, T second, quint64 secondLength ) {
+    return static_cast< T >( multiplyMod< T, Polynomial >( first, powerOfX8< T, Polynomial >( secondLength ) ) ^ second );
+}
+
+template quint16 crc::update< quint16, 0x1021 >( quint16, const void*, std::size_t );
+template quint32 crc::update< quint32, 0x04c11db7 >( quint32, const void*, std::size_t );
+template quint32 crc::update< quint32, CASTAGNOLI >( quint32, const void*, std::size_t );
+template quint64 crc::update< quint64, 0x42f0e1eba9ea3693 >( quint64, const void*, std::size_t );
+
+template quint16 crc::combine< quint16, 0x1021 >( quint16, quint16, quint64 );
+template quint32 crc::combine< quint32, 0x04c11db7 >( quint32, quint32, quint64 );
+template quint32 crc::combine< quint32, CASTAGNOLI >( quint32, quint32, quint64 );
+template quint64 crc::combine< quint64, 0x42f0e1eba9ea3693 >( quint64, quint64, quint64 );
 
 quint64 QChecksum::checksum( const QByteArray msg, QChecksum::Algorithm algorithm ) {
     switch ( algorithm ) {
-        case QChecksum::CRC16:
-            crc16_calc.process_bytes( msg.constData(), msg.length() );
-            return crc16_calc.checksum();
-        case QChecksum::CRC32:
-            crc32_calc.reset();
-            crc32_calc.process_bytes( msg.constData(), msg.size() );
-            return crc32_calc.checksum();
-        case QChecksum::CRC64:
-            crc64_calc.reset();
-            crc64_calc.process_bytes( msg.constData(), msg.size() );
-            return crc64_calc.checksum();
+        case QChecksum::CRC16: {
+            Crc16 crc16;
+            crc16.process_bytes( msg.constData(), msg.size() );
+            return crc16.checksum();
+        }
+        case QChecksum::CRC32: {
+            Crc32 crc32;
+            crc32.process_bytes( msg.constData(), msg.size() );
+            return crc32.checksum();
+        }
+        case QChecksum::CRC64: {
+            Crc64 crc64;
+            crc64.process_bytes( msg.constData(), msg.size() );
+            return crc64.checksum();
+        }
+        case QChecksum::CRC32C: {
+            Crc32C crc32c;
+            crc32c.process_bytes( msg.constData(), msg.size() );
+            return crc32c.checksum();
+        }
         default:
             throw std::invalid_argument( "Checksum algorithm not valid!" );
     }
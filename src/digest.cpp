@@ -0,0 +1,328 @@
+#include "digest.hpp"
+
+#include <stdexcept>
+
+#include "qextrahash.hpp"
+#include "haval.hpp"
+#include "crc.hpp"
+#include "md.hpp"
+#include "sha.hpp"
+#include "keccak.hpp"
+#include "tiger.hpp"
+#include "ripemd160.hpp"
+#include "blake3.hpp"
+#include "xxh3.hpp"
+
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+    template< typename Crc >
+    class CrcDigest : public Digest {
+        public:
+            explicit CrcDigest( algorithms::Id id ) : Digest( algorithms::Set::of( id ) ) {}
+
+            void addData( const char* data, int length ) override { mCrc.process_bytes( data, length ); }
+            quint64 checksum( algorithms::Id ) override { return mCrc.checksum(); }
+            void combine( const Digest& next, quint64 nextLength ) override {
+                mCrc.append( static_cast< const CrcDigest& >( next ).mCrc, nextLength );
+            }
+
+        private:
+            Crc mCrc;
+    };
+
+    // In-tree implementations of HashAlgorithm
+    template< typename Hash >
+    class AlgorithmDigest : public Digest {
+        public:
+            explicit AlgorithmDigest( algorithms::Id id ) : Digest( algorithms::Set::of( id ) ) {}
+
+            void addData( const char* data, int length ) override {
+                mHash.write( reinterpret_cast< const byte* >( data ), length );
+            }
+
+            QByteArray result( algorithms::Id ) override {
+                byte* hash = mHash.final();
+                return QByteArray( reinterpret_cast< char* >( hash ), mHash.hash_length() );
+            }
+
+        private:
+            Hash mHash;
+    };
+
+    class ExtraDigest : public Digest {
+        public:
+            ExtraDigest( algorithms::Id id, QExtraHash::Algorithm method ) : Digest( algorithms::Set::of( id ) ), mHash( method ) {}
+
+            void addData( const char* data, int length ) override { mHash.addData( data, length ); }
+            QByteArray result( algorithms::Id ) override { return mHash.result(); }
+
+        private:
+            QExtraHash mHash;
+    };
+
+    /* Runs the HAVAL-5 compression function only once for all the selected output lengths:
+     * the context is forked just before the finalization, which is the only length-dependent step. */
+    class HavalDigest : public Digest {
+        public:
+            explicit HavalDigest( const algorithms::Set& ids ) : Digest( ids ) {}
+
+            void addData( const char* data, int length ) override {
+                mHaval.write( reinterpret_cast< const byte* >( data ), length );
+            }
+
+            QByteArray result( algorithms::Id id ) override {
+                switch ( id ) {
+                    case algorithms::HAVAL128:
+                        return forkResult< 128 >();
+                    case algorithms::HAVAL160:
+                        return forkResult< 160 >();
+                    case algorithms::HAVAL192:
+                        return forkResult< 192 >();
+                    case algorithms::HAVAL224:
+                        return forkResult< 224 >();
+                    default:
+                        return forkResult< 256 >();
+                }
+            }
+
+        private:
+            template< uint16_t Length >
+            QByteArray forkResult() const {
+                Haval< 5, Length > haval = mHaval.fork< Length >();
+                byte* hash = haval.final();
+                return QByteArray( reinterpret_cast< char* >( hash ), haval.hash_length() );
+            }
+
+            Haval< 5, 256 > mHaval;
+    };
+
+    /* Absorbs the message once for all the selected SHA-3 lengths: the sponges whose blocks fill
+     * at the same time are permuted together (see Sha3Set). */
+    class Sha3Digest : public Digest {
+        public:
+            explicit Sha3Digest( const algorithms::Set& ids ) : Digest( ids ), mFinished( false ) {
+                foreach ( algorithms::Id id, ids.toList() ) {
+                    mSponges[ id - algorithms::SHA3_224 ] = mSet.add( length( id ) );
+                }
+            }
+
+            void addData( const char* data, int length ) override {
+                mSet.write( reinterpret_cast< const byte* >( data ), static_cast< std::size_t >( length ) );
+            }
+
+            QByteArray result( algorithms::Id id ) override {
+                if ( !mFinished ) {
+                    mSet.final();
+                    mFinished = true;
+                }
+                const byte* hash = mSet.digest( mSponges[ id - algorithms::SHA3_224 ] );
+                return QByteArray( reinterpret_cast< const char* >( hash ), static_cast< int >( length( id ) ) );
+            }
+
+        private:
+            static std::size_t length( algorithms::Id id ) {
+                switch ( id ) {
+                    case algorithms::SHA3_224:
+                        return 28;
+                    case algorithms::SHA3_256:
+                        return 32;
+                    case algorithms::SHA3_384:
+                        return 48;
+                    default:
+                        return 64;
+                }
+            }
+
+            Sha3Set mSet;
+            std::size_t mSponges[ Sha3Set::MAX_SPONGES ];
+            bool mFinished;
+    };
+
+    /* SHA-224 and SHA-256 (as SHA-384 and SHA-512) differ only in the initial values and in the truncation:
+     * when both are selected their states are updated together, in a single pass over the message. */
+    template< typename Pair, int FirstLength, int SecondLength >
+    class ShaPairDigest : public Digest {
+        public:
+            ShaPairDigest( algorithms::Id first, algorithms::Id second )
+                : Digest( pairOf( first, second ) ), mFirst( first ), mFinished( false ) {}
+
+            void addData( const char* data, int length ) override {
+                mPair.write( reinterpret_cast< const byte* >( data ), static_cast< std::size_t >( length ) );
+            }
+
+            QByteArray result( algorithms::Id id ) override {
+                if ( !mFinished ) {
+                    mPair.final( mFirstHash, mSecondHash );
+                    mFinished = true;
+                }
+                if ( id == mFirst ) {
+                    return QByteArray( reinterpret_cast< char* >( mFirstHash ), FirstLength );
+                }
+                return QByteArray( reinterpret_cast< char* >( mSecondHash ), SecondLength );
+            }
+
+        private:
+            static algorithms::Set pairOf( algorithms::Id first, algorithms::Id second ) {
+                algorithms::Set ids = algorithms::Set::of( first );
+                ids.insert( second );
+                return ids;
+            }
+
+            const algorithms::Id mFirst;
+            Pair mPair;
+            bool mFinished;
+            byte mFirstHash[ FirstLength ];
+            byte mSecondHash[ SecondLength ];
+    };
+
+    /* XXH3-64 and XXH3-128 share the accumulation of the input, so a single state gives both.
+     * The results are the canonical (big endian) representation of the hash values, as printed by xxhsum. */
+    class Xxh3Digest : public Digest {
+        public:
+            explicit Xxh3Digest( const algorithms::Set& ids ) : Digest( ids ) {}
+
+            void addData( const char* data, int length ) override {
+                mState.update( reinterpret_cast< const byte* >( data ), static_cast< std::size_t >( length ) );
+            }
+
+            QByteArray result( algorithms::Id id ) override {
+                QByteArray hash;
+                if ( id == algorithms::XXH3_128 ) {
+                    uint64_t low;
+                    uint64_t high;
+                    mState.digest128( low, high );
+                    appendBigEndian( hash, high );
+                    appendBigEndian( hash, low );
+                } else {
+                    appendBigEndian( hash, mState.digest64() );
+                }
+                return hash;
+            }
+
+        private:
+            static void appendBigEndian( QByteArray& hash, uint64_t value ) {
+                for ( int shift = 56; shift >= 0; shift -= 8 ) {
+                    hash.append( static_cast< char >( value >> shift ) );
+                }
+            }
+
+            xxh3::State mState;
+    };
+}
+
+vector< unique_ptr< Digest > > Digest::create( const algorithms::Set& ids ) {
+    using namespace algorithms;
+    vector< unique_ptr< Digest > > digests;
+    Set remaining = ids;
+    if ( remaining.contains( SHA224 ) && remaining.contains( SHA256 ) ) {
+        digests.emplace_back( new ShaPairDigest< Sha224And256, 28, 32 >( SHA224, SHA256 ) );
+        remaining.remove( SHA224 );
+        remaining.remove( SHA256 );
+    }
+    if ( remaining.contains( SHA384 ) && remaining.contains( SHA512 ) ) {
+        digests.emplace_back( new ShaPairDigest< Sha384And512, 48, 64 >( SHA384, SHA512 ) );
+        remaining.remove( SHA384 );
+        remaining.remove( SHA512 );
+    }
+    Set sha3Ids;
+    Set havalIds;
+    Set xxh3Ids;
+    foreach ( Id id, remaining.toList() ) {
+        if ( group( id ) == algorithms::Sha3 ) {
+            sha3Ids.insert( id );
+        } else if ( group( id ) == algorithms::Haval ) {
+            havalIds.insert( id );
+        } else if ( group( id ) == algorithms::Xxh3 ) {
+            xxh3Ids.insert( id );
+        } else {
+            digests.push_back( create( id ) );
+        }
+    }
+    if ( !sha3Ids.isEmpty() ) {
+        digests.emplace_back( new Sha3Digest( sha3Ids ) );
+    }
+    if ( !havalIds.isEmpty() ) {
+        digests.emplace_back( new HavalDigest( havalIds ) );
+    }
+    if ( !xxh3Ids.isEmpty() ) {
+        digests.emplace_back( new Xxh3Digest( xxh3Ids ) );
+    }
+    return digests;
+}
+
+unique_ptr< Digest > Digest::create( algorithms::Id id ) {
+    using namespace algorithms;
+    switch ( id ) {
+        case CRC16:
+            return unique_ptr< Digest >( new CrcDigest< Crc16 >( id ) );
+        case CRC32:
+            return unique_ptr< Digest >( new CrcDigest< Crc32 >( id ) );
+        case CRC64:
+            return unique_ptr< Digest >( new CrcDigest< Crc64 >( id ) );
+        case CRC32C:
+            return unique_ptr< Digest >( new CrcDigest< Crc32C >( id ) );
+        case MD4:
+            return unique_ptr< Digest >( new AlgorithmDigest< Md4 >( id ) );
+        case MD5:
+            return unique_ptr< Digest >( new AlgorithmDigest< Md5 >( id ) );
+        case SHA1:
+            return unique_ptr< Digest >( new AlgorithmDigest< Sha1 >( id ) );
+        case SHA224:
+            return unique_ptr< Digest >( new AlgorithmDigest< Sha224 >( id ) );
+        case SHA256:
+            return unique_ptr< Digest >( new AlgorithmDigest< Sha256 >( id ) );
+        case SHA384:
+            return unique_ptr< Digest >( new AlgorithmDigest< Sha384 >( id ) );
+        case SHA512:
+            return unique_ptr< Digest >( new AlgorithmDigest< Sha512 >( id ) );
+        case SHA3_224:
+        case SHA3_256:
+        case SHA3_384:
+        case SHA3_512:
+            return unique_ptr< Digest >( new Sha3Digest( Set::of( id ) ) );
+        case TIGER:
+            return unique_ptr< Digest >( new AlgorithmDigest< Tiger >( id ) );
+        case RIPEMD160:
+            return unique_ptr< Digest >( new AlgorithmDigest< Ripemd160 >( id ) );
+        case HAVAL128:
+            return unique_ptr< Digest >( new ExtraDigest( id, QExtraHash::HAVAL128 ) );
+        case HAVAL160:
+            return unique_ptr< Digest >( new ExtraDigest( id, QExtraHash::HAVAL160 ) );
+        case HAVAL192:
+            return unique_ptr< Digest >( new ExtraDigest( id, QExtraHash::HAVAL192 ) );
+        case HAVAL224:
+            return unique_ptr< Digest >( new ExtraDigest( id, QExtraHash::HAVAL224 ) );
+        case HAVAL256:
+            return unique_ptr< Digest >( new ExtraDigest( id, QExtraHash::HAVAL256 ) );
+        case BLAKE3:
+            return unique_ptr< Digest >( new AlgorithmDigest< Blake3 >( id ) );
+        case XXH3_64:
+        case XXH3_128:
+            return unique_ptr< Digest >( new Xxh3Digest( Set::of( id ) ) );
+        default:
+            throw std::invalid_argument( "Algorithm not supported" );
+    }
+}
+
+quint64 Digest::checksum( const QByteArray& data, algorithms::Id id ) {
+    switch ( id ) {
+        case algorithms::CRC16:
+            return QChecksum::checksum( data, QChecksum::CRC16 );
+        case algorithms::CRC32:
+            return QChecksum::checksum( data, QChecksum::CRC32 );
+        case algorithms::CRC64:
+            return QChecksum::checksum( data, QChecksum::CRC64 );
+        case algorithms::CRC32C:
+            return QChecksum::checksum( data, QChecksum::CRC32C );
+        default:
+            throw std::invalid_argument( "Checksum algorithm not valid!" );
+    }
+}
+
+QByteArray Digest::hash( const QByteArray& data, algorithms::Id id ) {
+    unique_ptr< Digest > digest = create( id );
+    digest->addData( data.constData(), data.size() );
+    return digest->result( id );
+}
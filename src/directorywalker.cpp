@@ -0,0 +1,220 @@
+#include "directorywalker.hpp"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+
+#include <algorithm>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/* the entries of a directory are read with getdents64 in batches of this size, instead of the single
+ * page used by readdir, so that large directories take few system calls */
+#define DIRENT_BUFFER_SIZE 64 * 1024 //64 KB
+#endif
+
+namespace {
+    QString childPath( const QString& directory, const QString& name ) {
+        return directory.endsWith( QLatin1Char( '/' ) ) ? directory + name : directory + QLatin1Char( '/' ) + name;
+    }
+
+#ifdef Q_OS_LINUX
+    struct LinuxDirent64 {
+        ino64_t d_ino;
+        off64_t d_off;
+        unsigned short d_reclen;
+        unsigned char d_type;
+        char d_name[ 1 ];
+    };
+#endif
+}
+
+class DirectoryWalker::Task : public QRunnable {
+    public:
+        Task( DirectoryWalker& walker, const QString& directory ) : mWalker( walker ), mDirectory( directory ) {}
+
+        void run() override { mWalker.walk( mDirectory ); }
+
+    private:
+        DirectoryWalker& mWalker;
+        const QString mDirectory;
+};
+
+DirectoryWalker::DirectoryWalker( QObject* parent, const QStringList& directories )
+    : QObject( parent ), mDirectories( directories ), mPending( 0 ), mStopped( false ) {
+    // listing a directory waits on the metadata of the disk much more than on a core
+    mPool.setMaxThreadCount( qMax( 2 * QThread::idealThreadCount(), 4 ) );
+}
+
+DirectoryWalker::~DirectoryWalker() {
+    stop();
+}
+
+void DirectoryWalker::start() {
+    mPending = 1; //so that it cannot end before all the directories are queued
+    foreach ( const QString& directory, mDirectories ) {
+        walkLater( QDir::cleanPath( directory ) );
+    }
+    if ( --mPending == 0 ) {
+        emit finished();
+    }
+}
+
+void DirectoryWalker::stop() {
+    disconnect();
+    mStopped = true;
+    mPool.clear(); //the directories not yet read
+    mPool.waitForDone();
+}
+
+void DirectoryWalker::wait() {
+    mPool.waitForDone();
+}
+
+bool DirectoryWalker::isRunning() const {
+    return mPending > 0 && !mStopped;
+}
+
+QStringList DirectoryWalker::files() const {
+    QMutexLocker locker( &mMutex );
+    QStringList files = mFiles;
+    files.sort();
+    return files;
+}
+
+QStringList DirectoryWalker::errors() const {
+    QMutexLocker locker( &mMutex );
+    return mErrors;
+}
+
+void DirectoryWalker::walkLater( const QString& directory ) {
+    ++mPending;
+    mPool.start( new Task( *this, directory ) );
+}
+
+bool DirectoryWalker::visit( const Identity& directory ) {
+    QMutexLocker locker( &mMutex );
+    if ( mVisited.contains( directory ) ) {
+        return false;
+    }
+    mVisited.insert( directory );
+    return true;
+}
+
+bool DirectoryWalker::visit( const QString& canonicalPath ) {
+    QMutexLocker locker( &mMutex );
+    if ( canonicalPath.isEmpty() || mVisitedPaths.contains( canonicalPath ) ) {
+        return false;
+    }
+    mVisitedPaths.insert( canonicalPath );
+    return true;
+}
+
+void DirectoryWalker::found( const QStringList& files, const QStringList& identities ) {
+    if ( files.isEmpty() ) {
+        return;
+    }
+    mMutex.lock();
+    mFiles += files;
+    mMutex.unlock();
+    emit filesFound( files, identities );
+}
+
+void DirectoryWalker::failed( const QString& directory, const QString& error ) {
+    mMutex.lock();
+    mErrors << directory + ": " + error;
+    mMutex.unlock();
+    emit directoryFailed( directory, error );
+}
+
+void DirectoryWalker::walk( const QString& directory ) {
+    if ( !mStopped ) {
+        QList< Entry > entries;
+        read( directory, entries );
+        std::sort( entries.begin(), entries.end() );
+        QStringList files;
+        QStringList identities;
+        foreach ( const Entry& entry, entries ) {
+            files << entry.first;
+            identities << entry.second;
+        }
+        found( files, identities );
+    }
+    if ( --mPending == 0 ) {
+        emit finished();
+    }
+}
+
+#ifdef Q_OS_LINUX
+void DirectoryWalker::read( const QString& directory, QList< Entry >& entries ) {
+    int fd = ::open( QFile::encodeName( directory ).constData(), O_RDONLY | O_DIRECTORY | O_CLOEXEC );
+    struct stat info;
+    if ( fd < 0 || fstat( fd, &info ) != 0 ) {
+        failed( directory, qt_error_string( errno ) );
+    } else if ( visit( Identity( info.st_dev, info.st_ino ) ) ) {
+        std::vector< char > buffer( DIRENT_BUFFER_SIZE );
+        long length;
+        while ( ( length = syscall( SYS_getdents64, fd, buffer.data(), buffer.size() ) ) > 0 && !mStopped ) {
+            for ( long offset = 0; offset < length; ) {
+                const LinuxDirent64* dirent = reinterpret_cast< const LinuxDirent64* >( buffer.data() + offset );
+                offset += dirent->d_reclen;
+                const char* name = dirent->d_name;
+                if ( name[ 0 ] == '.' && ( name[ 1 ] == '\0' || ( name[ 1 ] == '.' && name[ 2 ] == '\0' ) ) ) {
+                    continue;
+                }
+                QString path = childPath( directory, QFile::decodeName( name ) );
+                if ( dirent->d_type == DT_DIR ) {
+                    walkLater( path ); //its identity is checked when it is opened
+                    continue;
+                }
+                if ( dirent->d_type != DT_REG && dirent->d_type != DT_LNK && dirent->d_type != DT_UNKNOWN ) {
+                    continue; //devices, pipes and sockets are not hashed
+                }
+                struct stat entry;
+                if ( fstatat( fd, name, &entry, 0 ) != 0 ) {
+                    continue; //a dangling link, or a file removed in the meantime
+                }
+                if ( S_ISDIR( entry.st_mode ) ) {
+                    walkLater( path );
+                } else if ( S_ISREG( entry.st_mode ) ) {
+                    QString identity = entry.st_nlink > 1 ? QString( "%1:%2" ).arg( entry.st_dev ).arg( entry.st_ino ) : QString();
+                    entries << Entry( path, identity );
+                }
+            }
+        }
+        if ( length < 0 ) {
+            failed( directory, qt_error_string( errno ) );
+        }
+    }
+    if ( fd >= 0 ) {
+        ::close( fd );
+    }
+}
+#else
+void DirectoryWalker::read( const QString& directory, QList< Entry >& entries ) {
+    // no inode numbers here: the directories are told apart by their canonical paths, and no hard link is detected
+    QDir dir( directory );
+    if ( !dir.exists() || !dir.isReadable() ) {
+        failed( directory, tr( "Permission denied" ) );
+    } else if ( visit( dir.canonicalPath() ) ) {
+        QDir::Filters filters = QDir::Dirs | QDir::Files | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System;
+        foreach ( const QFileInfo& entry, dir.entryInfoList( filters, QDir::Unsorted ) ) {
+            if ( entry.isDir() ) {
+                walkLater( entry.filePath() );
+            } else if ( entry.isFile() ) {
+                entries << Entry( entry.filePath(), QString() );
+            }
+        }
+    }
+}
+#endif
@@ -0,0 +1,119 @@
+#include "disklayout.hpp"
+
+#include <QFile>
+#include <QHash>
+
+#include <algorithm>
+#include <atomic>
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef Q_OS_LINUX
+#include <cstring>
+
+#include <linux/fiemap.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sysmacros.h>
+#endif
+
+namespace {
+    std::atomic< int > gReaders[] = { { 0 }, { 1 }, { 0 } }; //by kind: only the hard disks are limited by default
+}
+
+namespace disklayout {
+    quint64 device( const QString& fileName ) {
+#ifdef Q_OS_UNIX
+        struct stat status;
+        if ( stat( QFile::encodeName( fileName ).constData(), &status ) == 0 ) {
+            return static_cast< quint64 >( status.st_dev );
+        }
+#else
+        Q_UNUSED( fileName )
+#endif
+        return 0;
+    }
+
+    Location locate( const QString& fileName ) {
+        Location location = { 0, 0 };
+#ifdef Q_OS_UNIX
+        //non-blocking, so that opening a named pipe does not wait for a writer
+        int fd = ::open( QFile::encodeName( fileName ).constData(), O_RDONLY | O_NONBLOCK | O_CLOEXEC );
+        if ( fd < 0 ) {
+            return location;
+        }
+        struct stat status;
+        if ( fstat( fd, &status ) == 0 ) {
+            location.device = static_cast< quint64 >( status.st_dev );
+#ifdef Q_OS_LINUX
+            //room for the first extent only
+            quint64 request[ ( sizeof( fiemap ) + sizeof( fiemap_extent ) ) / sizeof( quint64 ) + 1 ];
+            std::memset( request, 0, sizeof( request ) );
+            fiemap* map = reinterpret_cast< fiemap* >( request );
+            map->fm_length = FIEMAP_MAX_OFFSET;
+            map->fm_extent_count = 1;
+            if ( S_ISREG( status.st_mode ) && ioctl( fd, FS_IOC_FIEMAP, map ) == 0 && map->fm_mapped_extents > 0
+                 && !( map->fm_extents[ 0 ].fe_flags & ( FIEMAP_EXTENT_UNKNOWN | FIEMAP_EXTENT_DELALLOC ) ) ) {
+                location.offset = map->fm_extents[ 0 ].fe_physical;
+            }
+#endif
+        }
+        ::close( fd );
+#else
+        Q_UNUSED( fileName )
+#endif
+        return location;
+    }
+
+    Kind kind( quint64 device ) {
+#ifdef Q_OS_LINUX
+        dev_t number = static_cast< dev_t >( device );
+        if ( major( number ) == 0 ) {
+            return Unknown; //not a block device: network and virtual filesystems, btrfs subvolumes
+        }
+        QString path = QString( "/sys/dev/block/%1:%2" ).arg( major( number ) ).arg( minor( number ) );
+        QFile rotational( path + "/queue/rotational" );
+        if ( !rotational.exists() ) {
+            rotational.setFileName( path + "/../queue/rotational" ); //a partition, in the directory of its disk
+        }
+        if ( rotational.open( QFile::ReadOnly ) ) {
+            return rotational.readAll().trimmed() == "1" ? Rotational : SolidState;
+        }
+#else
+        Q_UNUSED( device )
+#endif
+        return Unknown;
+    }
+
+    int readers( quint64 device ) {
+        return gReaders[ kind( device ) ];
+    }
+
+    void setReaders( Kind kind, int readers ) {
+        gReaders[ kind ] = qMax( readers, 0 );
+    }
+
+    std::vector< int > readingOrder( const std::vector< Location >& locations ) {
+        QHash< quint64, int > devices; //device -> rank, in the order of their first file
+        for ( const Location& location : locations ) {
+            if ( !devices.contains( location.device ) ) {
+                devices.insert( location.device, devices.size() );
+            }
+        }
+        std::vector< int > order( locations.size() );
+        for ( std::size_t i = 0; i < order.size(); ++i ) {
+            order[ i ] = static_cast< int >( i );
+        }
+        std::stable_sort( order.begin(), order.end(), [&locations, &devices]( int first, int second ) {
+            int firstDevice = devices.value( locations[ first ].device );
+            int secondDevice = devices.value( locations[ second ].device );
+            return firstDevice != secondDevice ? firstDevice < secondDevice
+                                               : locations[ first ].offset < locations[ second ].offset;
+        } );
+        return order;
+    }
+}
@@ -2,16 +2,30 @@
 
 #include <QFile>
 
-FileBase64Calculator::FileBase64Calculator( QWidget* parent, QString fileName ) : QThread( parent ),
-    mFileName( fileName ) {}
+FileBase64Calculator::FileBase64Calculator( QObject* parent, QString fileName ) : QObject( parent ),
+    mFileName( fileName ), mStopped( false ), mTasks( TaskScheduler::instance() ) {}
 
-FileBase64Calculator::~FileBase64Calculator() {}
+FileBase64Calculator::~FileBase64Calculator() {
+    stop();
+}
+
+void FileBase64Calculator::start() {
+    mTasks.run( [this]() {
+        QFile file( mFileName );
+        if ( file.open( QFile::ReadOnly ) ) {
+            QByteArray content = file.readAll();
+            if ( !mStopped )
+                emit completed( content.toBase64( QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals ) );
+        }
+    } );
+}
+
+void FileBase64Calculator::stop() {
+    disconnect();
+    mStopped = true;
+    mTasks.wait();
+}
 
-void FileBase64Calculator::run() {
-    QFile file( mFileName );
-    if ( file.open( QFile::ReadOnly ) ) {
-        QByteArray content = file.readAll();
-        if ( !isInterruptionRequested() )
-            emit completed( content.toBase64( QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals ) );
-    }
+bool FileBase64Calculator::isRunning() const {
+    return mTasks.pending() > 0;
 }
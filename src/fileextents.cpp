@@ -0,0 +1,98 @@
+#include "fileextents.hpp"
+
+#include <QFile>
+
+#include <limits>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <vector>
+#endif
+
+#if defined( Q_OS_UNIX ) && defined( SEEK_DATA ) && defined( SEEK_HOLE )
+#define MRHASH_SEEK_HOLE
+#endif
+
+#define MIN_HOLE_SIZE 1024 * 1024 //1 MB, as a chunk: the shorter holes are read along with the data around them
+#define MAX_SCAN_SIZE 64 * 1024 * 1024 //64 MB of data searched for holes at once
+
+const int FileExtents::ZerosLength;
+
+FileExtents::FileExtents( QFile& file )
+    : mFile( file ), mSize( file.size() ), mSparse( false ), mStart( 0 ), mEnd( 0 ), mHole( false ) {
+#ifdef MRHASH_SEEK_HOLE
+    //fewer blocks allocated than the size: some of it is not on the disk
+    struct stat status;
+    mSparse = fstat( mFile.handle(), &status ) == 0 && S_ISREG( status.st_mode )
+              && static_cast< qint64 >( status.st_blocks ) * 512 < static_cast< qint64 >( status.st_size );
+#endif
+}
+
+bool FileExtents::isSparse() const {
+    return mSparse;
+}
+
+qint64 FileExtents::extentEnd( qint64 offset, bool& hole ) {
+    if ( !mSparse || offset >= mSize ) {
+        hole = false;
+        return std::numeric_limits< qint64 >::max();
+    }
+    if ( offset < mStart || offset >= mEnd ) {
+        find( offset );
+    }
+    hole = mHole;
+    return mEnd;
+}
+
+void FileExtents::find( qint64 offset ) {
+    mStart = offset;
+    mEnd = std::numeric_limits< qint64 >::max();
+    mHole = false;
+#ifdef MRHASH_SEEK_HOLE
+    int fd = mFile.handle();
+    off_t position = lseek( fd, 0, SEEK_CUR ); //the file may be read with read() in between
+    off_t data = lseek( fd, offset, SEEK_DATA );
+    if ( data < 0 && errno == ENXIO ) {
+        mHole = true; //up to the end of the file
+        mEnd = mSize;
+    } else if ( data > offset ) {
+        mHole = true;
+        mEnd = data;
+    } else if ( data == offset ) {
+        //the data up to the next hole large enough to be skipped
+        qint64 end = offset;
+        while ( end - offset < ( MAX_SCAN_SIZE ) ) {
+            off_t holeStart = lseek( fd, end, SEEK_HOLE );
+            if ( holeStart < 0 || holeStart >= mSize ) {
+                end = std::numeric_limits< qint64 >::max();
+                break;
+            }
+            off_t next = lseek( fd, holeStart, SEEK_DATA );
+            if ( next < 0 || next - holeStart >= ( MIN_HOLE_SIZE ) ) {
+                end = holeStart;
+                break;
+            }
+            end = next;
+        }
+        mEnd = end;
+    }
+    lseek( fd, position, SEEK_SET );
+#endif
+}
+
+const char* FileExtents::zeros() {
+#ifdef Q_OS_UNIX
+    //never written: all its pages are the zero page of the kernel
+    static const void* zeros = mmap( nullptr, ZerosLength, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    static const char* allocated = zeros != MAP_FAILED ? nullptr : new char[ ZerosLength ](); //never freed
+    return zeros != MAP_FAILED ? static_cast< const char* >( zeros ) : allocated;
+#else
+    static const std::vector< char > zeros( ZerosLength );
+    return zeros.data();
+#endif
+}
@@ -1,21 +1,114 @@
 #include "filehashcalculator.hpp"
 
 #include <QFile>
-#include <QCryptographicHash>
 
+#include <atomic>
+#include <deque>
 #include <memory>
+#include <vector>
 
-#include "qtcryptohash/qcryptohash.hpp"
-#include "qextrahash.hpp"
-#include "crc.hpp"
+#include "cachedropper.hpp"
+#include "chunkring.hpp"
+#include "digest.hpp"
+#include "fileextents.hpp"
+#include "filemapping.hpp"
+#include "taskscheduler.hpp"
+#include "uringreader.hpp"
 
-#define BUFFER_SIZE 8 * 1024 //8 KB
+#define BUFFER_SIZE 1024 * 1024 //1 MB
+#define BUFFER_COUNT 8
+#define MIN_BUFFER_SIZE 64 * 1024 //64 KB, for the small files
+#define QUEUE_DEPTH 16 //reads in flight, of BUFFER_SIZE each, for the files read with io_uring
+#define FEED_CHUNKS 4 //hashed by a task before the other tasks get their turn
+
+/* when only checksums are selected, files are split in ranges of this size, hashed independently
+ * by the tasks of the scheduler and then merged with crc::combine */
+#define RANGE_SIZE 32 * 1024 * 1024 //32 MB
+#define PROGRESS_INTERVAL 100 //ms
+
+/* regular files are mapped in memory in windows of this size, and their chunks are hashed straight from the
+ * page cache; BLAKE3 alone hashes whole windows, large enough to be split across the cores (a power of two,
+ * so that every window starts a complete subtree) */
+#define MAP_WINDOW_SIZE 64 * 1024 * 1024 //64 MB
+#define MAP_MIN_SIZE 4 * 1024 * 1024 //4 MB, smaller files are read faster than they are mapped (or queued)
 
 using std::vector;
 using std::unique_ptr;
 
-FileHashCalculator::FileHashCalculator( QWidget* parent, QString fileName )
-    : QThread( parent ), mFileName( fileName ), mIsPaused( false ) {
+namespace {
+    /* Feeds the chunks read by FileHashCalculator to a group of digests, as tasks of the scheduler: each task
+     * hashes the chunks written so far (FEED_CHUNKS at most) and is submitted again when more are written. */
+    class GroupFeeder {
+        public:
+            GroupFeeder( ChunkRing& ring, int consumer, TaskScheduler::Group& tasks, vector< unique_ptr< Digest > > digests )
+                : mRing( ring ), mConsumer( consumer ), mTasks( tasks ), mDigests( std::move( digests ) ), mScheduled( false ) {}
+
+            vector< unique_ptr< Digest > > takeDigests() { return std::move( mDigests ); }
+
+            void schedule() {
+                if ( !mScheduled.exchange( true ) ) {
+                    mTasks.run( [this]() { feed(); } );
+                }
+            }
+
+        private:
+            void feed() {
+                ChunkRing::Chunk chunk;
+                for ( int i = 0; i < FEED_CHUNKS && mRing.acquireRead( mConsumer, chunk ); ++i ) {
+                    for ( const unique_ptr< Digest >& digest : mDigests ) {
+                        digest->addData( chunk.data, chunk.length );
+                    }
+                    mRing.releaseRead( mConsumer );
+                }
+                mScheduled = false;
+                if ( mRing.hasChunk( mConsumer ) ) {
+                    schedule(); //written meanwhile, or left for the next task
+                }
+            }
+
+            ChunkRing& mRing;
+            const int mConsumer;
+            TaskScheduler::Group& mTasks;
+            vector< unique_ptr< Digest > > mDigests;
+            std::atomic< bool > mScheduled;
+    };
+
+    // Hashes a range of a file with its own handle and buffer, no digests if it cannot be read
+    vector< unique_ptr< Digest > > hashRange( const QString& fileName, qint64 offset, qint64 length,
+                                              const algorithms::Set& ids, bool dropCache, std::atomic< qint64 >& progress ) {
+        QFile file( fileName );
+        if ( !file.open( QFile::ReadOnly ) || !file.seek( offset ) ) {
+            return vector< unique_ptr< Digest > >();
+        }
+        CacheDropper dropper( file, dropCache, offset );
+        FileExtents extents( file );
+        vector< unique_ptr< Digest > > digests = Digest::create( ids );
+        vector< char > buffer( BUFFER_SIZE );
+        qint64 remaining = length;
+        while ( remaining > 0 ) {
+            bool hole;
+            qint64 position = offset + length - remaining;
+            qint64 extent = qMin( extents.extentEnd( position, hole ) - position, remaining );
+            const char* data = hole ? FileExtents::zeros() : buffer.data();
+            qint64 read = hole ? qMin< qint64 >( extent, FileExtents::ZerosLength )
+                               : file.read( buffer.data(), qMin< qint64 >( extent, buffer.size() ) );
+            if ( read <= 0 || ( hole && !file.seek( position + read ) ) ) {
+                return vector< unique_ptr< Digest > >();
+            }
+            for ( const unique_ptr< Digest >& digest : digests ) {
+                digest->addData( data, read );
+            }
+            remaining -= read;
+            progress += read;
+            dropper.advance( offset + length - remaining );
+        }
+        return digests;
+    }
+}
+
+FileHashCalculator::FileHashCalculator( QObject* parent, QString fileName, algorithms::Set selected )
+    : QThread( parent ), mFileName( fileName ), mAlgorithms( selected ), mCacheNeutral( false ), mDropCache( false ),
+      mIsPaused( false ) {
 }
 
 FileHashCalculator::~FileHashCalculator() {}
@@ -43,117 +136,380 @@ bool FileHashCalculator::isPaused() {
     return mIsPaused;
 }
 
+void FileHashCalculator::setCacheNeutral( bool cacheNeutral ) {
+    mCacheNeutral = cacheNeutral;
+}
+
+qint64 FileHashCalculator::bufferMemory() {
+    //the ring of the pipelined reads (deeper for the queued reads), or one buffer per range being hashed
+    return static_cast< qint64 >( qMax( qMax( BUFFER_COUNT, QUEUE_DEPTH ), 2 * TaskScheduler::instance().workerCount() ) )
+           * BUFFER_SIZE;
+}
+
+bool FileHashCalculator::waitForResume() {
+    mMutex.lock();
+    if ( mIsPaused ) {
+        mPauseCondition.wait( &mMutex ); //wait for a call to resume()
+    }
+    mMutex.unlock();
+    return !isInterruptionRequested();
+}
+
 void FileHashCalculator::run() {
     QFile file( mFileName );
-    if ( file.open( QFile::ReadOnly ) ) {
-        boost_crc16 crc16;
-        boost_crc32 crc32;
-        boost_crc64 crc64;
-
-        QCryptographicHash md4( QCryptographicHash::Md4 );
-        QCryptographicHash md5( QCryptographicHash::Md5 );
-        QCryptographicHash sha1( QCryptographicHash::Sha1 );
-        QCryptographicHash sha224( QCryptographicHash::Sha224 );
-        QCryptographicHash sha256( QCryptographicHash::Sha256 );
-        QCryptographicHash sha384( QCryptographicHash::Sha384 );
-        QCryptographicHash sha512( QCryptographicHash::Sha512 );
-        QCryptographicHash sha3_224( QCryptographicHash::Sha3_224 );
-        QCryptographicHash sha3_256( QCryptographicHash::Sha3_256 );
-        QCryptographicHash sha3_384( QCryptographicHash::Sha3_384 );
-        QCryptographicHash sha3_512( QCryptographicHash::Sha3_512 );
-
-        QCryptoHash tiger( QCryptoHash::TIGER );
-        QCryptoHash ripemd( QCryptoHash::RMD160 );
-
-        QExtraHash haval128( QExtraHash::HAVAL128 );
-        QExtraHash haval160( QExtraHash::HAVAL160 );
-        QExtraHash haval192( QExtraHash::HAVAL192 );
-        QExtraHash haval224( QExtraHash::HAVAL224 );
-        QExtraHash haval256( QExtraHash::HAVAL256 );
-
-        quint64 current = 0;
-        quint64 total = file.size();
-        while ( !isInterruptionRequested() && !file.atEnd() ) {
-            mMutex.lock();
-            if ( mIsPaused ) {
-                mPauseCondition.wait( &mMutex ); //wait for a call to resume()
-            }
-            mMutex.unlock();
-
-            QByteArray data = file.read( BUFFER_SIZE );
-
-            crc16.process_bytes( data.constData(), data.length() );
-            crc32.process_bytes( data.constData(), data.length() );
-            crc64.process_bytes( data.constData(), data.length() );
-
-            md4.addData( data );
-            md5.addData( data );
-            sha1.addData( data );
-            sha224.addData( data );
-            sha256.addData( data );
-            sha384.addData( data );
-            sha512.addData( data );
-            sha3_224.addData( data );
-            sha3_256.addData( data );
-            sha3_384.addData( data );
-            sha3_512.addData( data );
-
-            tiger.addData( data );
-            ripemd.addData( data );
-
-            haval128.addData( data );
-            haval160.addData( data );
-            haval192.addData( data );
-            haval224.addData( data );
-            haval256.addData( data );
-
-            current += data.size();
-            emit progressUpdate( ( float )current / total );
-        }
-        if ( !isInterruptionRequested() )
-            emit newChecksumValue( 0, crc16.checksum() );
-        if ( !isInterruptionRequested() )
-            emit newChecksumValue( 1, crc32.checksum() );
-        if ( !isInterruptionRequested() )
-            emit newChecksumValue( 2, crc64.checksum() );
-
-        if ( !isInterruptionRequested() )
-            emit newHashString( 3, md4.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 4, md5.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 5, sha1.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 6, sha224.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 7, sha256.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 8, sha384.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 9, sha512.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 10, sha3_224.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 11, sha3_256.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 12, sha3_384.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 13, sha3_512.result() );
-
-        if ( !isInterruptionRequested() )
-            emit newHashString( 14, tiger.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 15, ripemd.result() );
-
-        if ( !isInterruptionRequested() )
-            emit newHashString( 16, haval128.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 17, haval160.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 18, haval192.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 19, haval224.result() );
-        if ( !isInterruptionRequested() )
-            emit newHashString( 20, haval256.result() );
+    if ( !file.open( QFile::ReadOnly ) ) {
+        emit failed( file.errorString() );
+    } else {
+        bool checksumsOnly = !mAlgorithms.isEmpty();
+        foreach ( algorithms::Id id, mAlgorithms.toList() ) {
+            checksumsOnly = checksumsOnly && algorithms::isChecksum( id );
+        }
+
+        //the pages read are dropped from the page cache, unless the file was already there (and not mapped)
+        mDropCache = mCacheNeutral && !CacheDropper::isInUse( file );
+
+        /* CRCs are the only algorithms whose states can be merged, so they are the only ones
+         * whose ranges can be hashed on more than one core (if the ranges fail, it reads it again) */
+        Digests digests;
+        bool hashed = checksumsOnly && file.size() >= 2 * ( RANGE_SIZE ) && TaskScheduler::instance().workerCount() >= 2
+                      && hashRanges( file.size(), digests );
+        if ( !hashed && !mDropCache && mAlgorithms == algorithms::Set::of( algorithms::BLAKE3 ) ) {
+            hashed = hashMapped( file, digests ); //the tree is hashed on all the cores
+        }
+        if ( !hashed ) {
+            digests = hashPipelined( file );
+        }
+
+        for ( const unique_ptr< Digest >& digest : digests ) {
+            foreach ( algorithms::Id id, digest->ids().toList() ) {
+                if ( isInterruptionRequested() )
+                    return;
+                if ( algorithms::isChecksum( id ) )
+                    emit newChecksumValue( id, digest->checksum( id ) );
+                else
+                    emit newHashString( id, digest->result( id ) );
+            }
+        }
+    }
+}
+
+FileHashCalculator::Digests FileHashCalculator::hashPipelined( QFile& file, bool buffered ) {
+    /* each family of algorithms is fed by its own tasks, all hashing the same read-only chunks read by this thread:
+     * the families are hashed in parallel by the idle workers, and the chunks of the other files in between */
+    vector< algorithms::Set > groups;
+    for ( int group = 0; group < algorithms::GroupCount; ++group ) {
+        algorithms::Set groupIds;
+        foreach ( algorithms::Id id, mAlgorithms.toList() ) {
+            if ( algorithms::group( id ) == group ) {
+                groupIds.insert( id );
+            }
+        }
+        if ( !groupIds.isEmpty() ) {
+            groups.push_back( groupIds );
+        }
+    }
+    if ( groups.empty() ) {
+        return Digests();
+    }
+
+    /* the regular files are hashed from the page cache when most of their first window is there, otherwise (on Linux)
+     * they are read with many asynchronous reads in flight; the others, and the small files, are read sequentially
+     * (as are those that must not stay in the page cache, where io_uring is not available) */
+    enum { Buffered, Mapped, Queued } source = Buffered;
+    FileMapping mapping( file );
+    if ( !buffered && file.size() >= MAP_MIN_SIZE && mapping.isMappable() ) {
+        bool cached = !mDropCache && mapping.isCached( 0, qMin< qint64 >( file.size(), MAP_WINDOW_SIZE ) );
+        source = ( !cached && UringReader::isSupported() ) ? Queued : mDropCache ? Buffered : Mapped;
+    }
+    CacheDropper dropper( file, mDropCache );
+    FileExtents extents( file ); //the holes of sparse files are hashed from zeros, never read
+    //the small files get small chunks, so that a batch of them does not allocate a whole ring each
+    int chunkSize = file.isSequential() ? BUFFER_SIZE
+                                        : static_cast< int >( qBound< qint64 >( MIN_BUFFER_SIZE, file.size(), BUFFER_SIZE ) );
+    //the chunks of the mapped files point in the last two windows, so the ring has no buffers of its own
+    int chunkCount = source == Mapped ? ( MAP_WINDOW_SIZE ) / ( BUFFER_SIZE ) : source == Queued ? QUEUE_DEPTH : BUFFER_COUNT;
+    ChunkRing ring( chunkCount, source == Mapped ? 0 : chunkSize, static_cast< int >( groups.size() ) );
+    UringReader uring( source == Queued ? file.handle() : -1, source == Queued ? chunkCount : 0 ); //before the ring is freed
+    TaskScheduler::Group tasks( TaskScheduler::instance() );
+    vector< unique_ptr< GroupFeeder > > feeders;
+    for ( size_t i = 0; i < groups.size(); ++i ) {
+        feeders.emplace_back( new GroupFeeder( ring, static_cast< int >( i ), tasks, Digest::create( groups[ i ] ) ) );
+    }
+    std::function< void() > chunkWritten = [&feeders]() {
+        for ( const unique_ptr< GroupFeeder >& feeder : feeders ) {
+            feeder->schedule();
+        }
+    };
+
+    bool readFailed;
+    switch ( source ) {
+        case Mapped:
+            readFailed = !readMapped( mapping, extents, file.size(), ring, chunkWritten );
+            break;
+        case Queued:
+            readFailed = !readQueued( uring, file, extents, ring, dropper, chunkWritten );
+            break;
+        default:
+            readFailed = !readBuffered( file, extents, ring, dropper, chunkWritten );
+    }
+    if ( isInterruptionRequested() || readFailed ) {
+        ring.abort();
+    } else {
+        ring.acquireWrite();
+        ring.commitWrite( 0 ); //end of file
+        chunkWritten();
+    }
+    tasks.wait();
+
+    if ( source != Buffered && ( readFailed || mapping.isTruncated() ) && !isInterruptionRequested() ) {
+        /* a window could not be mapped, the file was truncated while mapped or the queued reads failed: it is
+         * read again, and the errors are those of read() */
+        return file.seek( 0 ) ? hashPipelined( file, true ) : Digests();
+    }
+    if ( readFailed ) {
+        emit failed( file.errorString() );
+        return Digests();
+    }
+    Digests digests;
+    for ( const unique_ptr< GroupFeeder >& feeder : feeders ) {
+        for ( unique_ptr< Digest >& digest : feeder->takeDigests() ) {
+            digests.push_back( std::move( digest ) );
+        }
+    }
+    return digests;
+}
+
+bool FileHashCalculator::readBuffered( QFile& file, FileExtents& extents, ChunkRing& ring, CacheDropper& dropper,
+                                       const std::function< void() >& chunkWritten ) {
+    qint64 current = 0;
+    quint64 total = file.size();
+    while ( waitForResume() ) {
+        char* buffer = ring.acquireWrite(); //waits for the slowest group
+        bool hole;
+        qint64 extent = extents.extentEnd( current, hole ) - current;
+        qint64 length;
+        if ( hole ) {
+            //a whole chunk of zeros, and the reads go on after it
+            length = qMin< qint64 >( extent, FileExtents::ZerosLength );
+            if ( !file.seek( current + length ) ) {
+                return false;
+            }
+            ring.commitWrite( FileExtents::zeros(), static_cast< int >( length ) );
+        } else {
+            length = file.read( buffer, qMin< qint64 >( extent, ring.chunkSize() ) );
+            if ( length <= 0 ) {
+                return length == 0;
+            }
+            ring.commitWrite( length );
+        }
+        chunkWritten();
+
+        current += length;
+        dropper.advance( current );
+        emit progressUpdate( ( float )current / total );
+    }
+    return true; //stopped
+}
+
+bool FileHashCalculator::readMapped( FileMapping& mapping, FileExtents& extents, qint64 size, ChunkRing& ring,
+                                     const std::function< void() >& chunkWritten ) {
+    const char* previous = nullptr;
+    for ( qint64 offset = 0; offset < size; offset += MAP_WINDOW_SIZE ) {
+        qint64 length = qMin< qint64 >( size - offset, MAP_WINDOW_SIZE );
+        bool hole;
+        const char* window = nullptr; //not mapped if it is all a hole
+        if ( !( extents.extentEnd( offset, hole ) >= offset + length && hole ) ) {
+            window = mapping.map( offset, length );
+            if ( window == nullptr ) {
+                return false;
+            }
+        }
+        for ( qint64 chunk = 0; chunk < length; chunk += BUFFER_SIZE ) {
+            if ( !waitForResume() ) {
+                return true; //stopped
+            }
+            ring.acquireWrite(); //waits for the slowest group
+            int chunkLength = static_cast< int >( qMin< qint64 >( length - chunk, BUFFER_SIZE ) );
+            //the pages of the holes are not even touched
+            bool zeros = extents.extentEnd( offset + chunk, hole ) >= offset + chunk + chunkLength && hole;
+            ring.commitWrite( zeros ? FileExtents::zeros() : window + chunk, chunkLength );
+            chunkWritten();
+            emit progressUpdate( ( float )( offset + chunk + chunkLength ) / size );
+        }
+        if ( previous != nullptr && length == MAP_WINDOW_SIZE ) {
+            mapping.unmap( previous ); //the slots of all its chunks have been acquired again for this window
+            previous = nullptr;
+        }
+        if ( window != nullptr ) { //a hole never takes the place of a mapped window still to be unmapped
+            previous = window;
+        }
+    }
+    return true;
+}
+
+bool FileHashCalculator::readQueued( UringReader& uring, QFile& file, FileExtents& extents, ChunkRing& ring,
+                                     CacheDropper& dropper,
+                                     const std::function< void() >& chunkWritten ) {
+    if ( !uring.isValid() ) {
+        return false;
+    }
+    vector< char* > buffers;
+    for ( int slot = 0; slot < ring.chunkCount(); ++slot ) {
+        buffers.push_back( ring.buffer( slot ) );
+    }
+    uring.registerBuffers( buffers, ring.chunkSize() );
+
+    struct Read {
+        int slot;
+        qint64 offset;
+        int length;
+        bool hole; //not submitted: its chunk is committed from the zeros
+    };
+    std::deque< Read > reads; //submitted, in the order of the file
+    vector< int > results( ring.chunkCount(), -1 ); //of the completed reads not yet committed, by slot
+    qint64 size = file.size();
+    qint64 offset = 0;
+    while ( waitForResume() ) {
+        /* a read in every slot released by the groups, up to the end of the file (the read past it, returning 0,
+         * makes sure that the file did not grow) */
+        while ( offset <= size ) {
+            int slot = ring.tryAcquireWrite( static_cast< int >( reads.size() ) );
+            if ( slot < 0 ) {
+                break;
+            }
+            bool hole;
+            qint64 extent = extents.extentEnd( offset, hole ) - offset;
+            int length = static_cast< int >( qMin< qint64 >( extent, hole ? FileExtents::ZerosLength : ring.chunkSize() ) );
+            if ( !hole && !uring.submit( slot, offset, length ) ) {
+                return false;
+            }
+            reads.push_back( { slot, offset, length, hole } );
+            offset += length;
+        }
+        if ( reads.empty() ) {
+            ring.acquireWrite(); //waits for the slowest group
+            continue;
+        }
+
+        //the chunks are committed in order, while the reads complete in any order
+        const Read read = reads.front();
+        while ( !read.hole && results[ read.slot ] < 0 ) {
+            int slot;
+            int result;
+            if ( !uring.wait( slot, result ) || result < 0 ) {
+                return false;
+            }
+            results[ slot ] = result;
+        }
+        int length = read.hole ? read.length : results[ read.slot ];
+        results[ read.slot ] = -1;
+        reads.pop_front();
+        if ( length < read.length && file.seek( read.offset + length ) ) {
+            //short read: at the end of the file, or cut by the filesystem
+            qint64 rest = file.read( ring.buffer( read.slot ) + length, read.length - length );
+            if ( rest < 0 ) {
+                return false;
+            }
+            length += static_cast< int >( rest );
+        }
+        if ( length == 0 ) {
+            return true; //the reads still in flight are past the end
+        }
+        if ( read.hole ) {
+            ring.commitWrite( FileExtents::zeros(), length );
+        } else {
+            ring.commitWrite( length );
+        }
+        chunkWritten();
+        size = qMax( size, read.offset + length );
+        dropper.advance( read.offset + length );
+        emit progressUpdate( ( float )( read.offset + length ) / size );
+        if ( length < read.length ) {
+            return true;
+        }
+    }
+    return true; //stopped
+}
+
+bool FileHashCalculator::hashRanges( qint64 size, Digests& digests ) {
+    TaskScheduler& scheduler = TaskScheduler::instance();
+    const int rangeCount = static_cast< int >( ( size + ( RANGE_SIZE ) - 1 ) / ( RANGE_SIZE ) );
+    const int maxPending = 2 * scheduler.workerCount(); //the ranges being hashed, each with its own buffer
+    vector< Digests > ranges( rangeCount );
+    std::atomic< qint64 > progress( 0 );
+    std::atomic< bool > complete( true );
+
+    TaskScheduler::Group tasks( scheduler );
+    for ( int i = 0; i < rangeCount && complete; ++i ) {
+        while ( !tasks.wait( maxPending - 1, PROGRESS_INTERVAL ) ) {
+            emit progressUpdate( ( float )progress / size );
+        }
+        if ( !waitForResume() ) {
+            break; //while paused, no more ranges are submitted
+        }
+        qint64 offset = static_cast< qint64 >( i ) * ( RANGE_SIZE );
+        qint64 length = qMin< qint64 >( size - offset, RANGE_SIZE );
+        Digests* range = &ranges[ i ];
+        tasks.run( [this, offset, length, range, &progress, &complete]() {
+            if ( complete && !isInterruptionRequested() ) {
+                *range = hashRange( mFileName, offset, length, mAlgorithms, mDropCache, progress );
+                complete = complete && !range->empty();
+            }
+        } );
+    }
+    while ( !tasks.wait( 0, PROGRESS_INTERVAL ) ) {
+        emit progressUpdate( ( float )progress / size );
+    }
+    if ( !complete || isInterruptionRequested() ) {
+        return isInterruptionRequested(); //nothing to emit if stopped, otherwise hash the file sequentially
+    }
+    emit progressUpdate( 1.0f );
+
+    // Digest::create returns the digests in the same order for each range
+    digests = std::move( ranges.front() );
+    for ( int i = 1; i < rangeCount; ++i ) {
+        qint64 length = qMin< qint64 >( size - static_cast< qint64 >( i ) * ( RANGE_SIZE ), RANGE_SIZE );
+        for ( size_t d = 0; d < digests.size(); ++d ) {
+            digests[ d ]->combine( *ranges[ i ][ d ], length );
+        }
+    }
+    return true;
+}
+
+bool FileHashCalculator::hashMapped( QFile& file, Digests& digests ) {
+    FileMapping mapping( file );
+    if ( !mapping.isMappable() ) {
+        return false; //empty, or not a regular file: nothing to map
+    }
+    const qint64 size = file.size();
+    FileExtents extents( file );
+    Digests mapped = Digest::create( mAlgorithms );
+    for ( qint64 offset = 0; offset < size; offset += MAP_WINDOW_SIZE ) {
+        if ( !waitForResume() ) {
+            return true; //stopped, nothing to emit
+        }
+        qint64 length = qMin< qint64 >( size - offset, MAP_WINDOW_SIZE );
+        bool hole;
+        if ( extents.extentEnd( offset, hole ) >= offset + length && hole ) {
+            for ( const unique_ptr< Digest >& digest : mapped ) {
+                digest->addData( FileExtents::zeros(), static_cast< int >( length ) ); //not mapped
+            }
+            emit progressUpdate( ( float )( offset + length ) / size );
+            continue;
+        }
+        const char* window = mapping.map( offset, length );
+        if ( window == nullptr ) {
+            return false; //read it sequentially instead
+        }
+        for ( const unique_ptr< Digest >& digest : mapped ) {
+            digest->addData( window, static_cast< int >( length ) );
+        }
+        mapping.unmap( window );
+        emit progressUpdate( ( float )( offset + length ) / size );
+    }
+    if ( mapping.isTruncated() ) {
+        return false; //the zeros read past its new end were hashed: read it sequentially instead
     }
+    digests = std::move( mapped );
+    return true;
 }
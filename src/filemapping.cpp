@@ -0,0 +1,176 @@
+#include "filemapping.hpp"
+
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <atomic>
+#include <csignal>
+#include <cstring>
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define MAX_GUARDED_WINDOWS 256
+
+namespace {
+    /* Ranges of the mapped windows, read by the SIGBUS handler: a range is claimed with used, and its begin
+     * is set before its end (and cleared after it), so that the handler never matches a partial range. */
+    struct Guard {
+        std::atomic< bool > used;
+        std::atomic< quintptr > begin;
+        std::atomic< quintptr > end;
+        std::atomic< bool > faulted;
+    };
+
+    Guard gGuards[ MAX_GUARDED_WINDOWS ];
+    struct sigaction gPreviousAction;
+    quintptr gPageSize = 4096;
+
+    void onBusError( int signal, siginfo_t* info, void* context ) {
+        quintptr address = reinterpret_cast< quintptr >( info->si_addr );
+        for ( Guard& guard : gGuards ) {
+            if ( address >= guard.begin && address < guard.end ) {
+                //past the end of the truncated file: the page is replaced with zeros, and the read is retried
+                void* page = reinterpret_cast< void* >( address & ~( gPageSize - 1 ) );
+                if ( mmap( page, gPageSize, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0 ) != MAP_FAILED ) {
+                    guard.faulted = true;
+                    return;
+                }
+            }
+        }
+        //not in a window: handled as if this handler was not installed
+        if ( gPreviousAction.sa_flags & SA_SIGINFO ) {
+            gPreviousAction.sa_sigaction( signal, info, context );
+        } else if ( gPreviousAction.sa_handler != SIG_DFL && gPreviousAction.sa_handler != SIG_IGN ) {
+            gPreviousAction.sa_handler( signal );
+        } else {
+            sigaction( SIGBUS, &gPreviousAction, nullptr ); //the fault is raised again on return
+        }
+    }
+
+    bool installHandler() {
+        gPageSize = static_cast< quintptr >( sysconf( _SC_PAGESIZE ) );
+        struct sigaction action;
+        std::memset( &action, 0, sizeof( action ) );
+        action.sa_sigaction = onBusError;
+        action.sa_flags = SA_SIGINFO;
+        sigemptyset( &action.sa_mask );
+        return sigaction( SIGBUS, &action, &gPreviousAction ) == 0;
+    }
+
+    int guard( const uchar* data, qint64 length ) {
+        static const bool installed = installHandler();
+        if ( !installed ) {
+            return -1;
+        }
+        for ( int i = 0; i < MAX_GUARDED_WINDOWS; ++i ) {
+            bool unused = false;
+            if ( gGuards[ i ].used.compare_exchange_strong( unused, true ) ) {
+                gGuards[ i ].faulted = false;
+                gGuards[ i ].begin = reinterpret_cast< quintptr >( data );
+                gGuards[ i ].end = reinterpret_cast< quintptr >( data ) + static_cast< quintptr >( length );
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    bool unguard( int index ) { //true if the window was truncated
+        gGuards[ index ].end = 0;
+        gGuards[ index ].begin = 0;
+        bool faulted = gGuards[ index ].faulted;
+        gGuards[ index ].used = false;
+        return faulted;
+    }
+}
+#endif
+
+FileMapping::FileMapping( QFile& file ) : mFile( file ), mTruncated( false ) {}
+
+FileMapping::~FileMapping() {
+    while ( !mWindows.empty() ) {
+        unmap( reinterpret_cast< const char* >( mWindows.back().data ) );
+    }
+}
+
+bool FileMapping::isMappable() const {
+#ifdef Q_OS_UNIX
+    struct stat status;
+    return fstat( mFile.handle(), &status ) == 0 && S_ISREG( status.st_mode ) && status.st_size > 0;
+#else
+    return !mFile.isSequential() && mFile.size() > 0;
+#endif
+}
+
+bool FileMapping::isCached( qint64 offset, qint64 length ) {
+#ifdef Q_OS_UNIX
+    uchar* data = mFile.map( offset, length ); //not read: it cannot fault
+    if ( data == nullptr ) {
+        return false;
+    }
+    uchar* page = data - reinterpret_cast< quintptr >( data ) % gPageSize;
+    size_t size = static_cast< size_t >( length + ( data - page ) );
+#ifdef Q_OS_LINUX
+    std::vector< unsigned char > resident( ( size + gPageSize - 1 ) / gPageSize );
+#else
+    std::vector< char > resident( ( size + gPageSize - 1 ) / gPageSize );
+#endif
+    size_t cached = 0;
+    if ( mincore( page, size, resident.data() ) == 0 ) {
+        for ( auto pageResident : resident ) {
+            cached += pageResident & 1;
+        }
+    }
+    mFile.unmap( data );
+    return cached * 2 >= resident.size();
+#else
+    Q_UNUSED( offset ) Q_UNUSED( length )
+    return true; //mapped anyway
+#endif
+}
+
+const char* FileMapping::map( qint64 offset, qint64 length ) {
+    uchar* data = mFile.map( offset, length );
+    if ( data == nullptr ) {
+        return nullptr;
+    }
+    Window window = { data, -1 };
+#ifdef Q_OS_UNIX
+    window.guard = guard( data, length );
+    if ( window.guard < 0 ) {
+        mFile.unmap( data ); //a truncation would kill the process
+        return nullptr;
+    }
+    uchar* page = data - reinterpret_cast< quintptr >( data ) % gPageSize;
+    madvise( page, static_cast< size_t >( length + ( data - page ) ), MADV_SEQUENTIAL );
+    madvise( page, static_cast< size_t >( length + ( data - page ) ), MADV_WILLNEED ); //read ahead the whole window
+#endif
+    //on Windows, a mapped file cannot be truncated
+    mWindows.push_back( window );
+    return reinterpret_cast< const char* >( data );
+}
+
+void FileMapping::unmap( const char* window ) {
+    for ( auto mapped = mWindows.begin(); mapped != mWindows.end(); ++mapped ) {
+        if ( reinterpret_cast< const char* >( mapped->data ) == window ) {
+#ifdef Q_OS_UNIX
+            mTruncated = unguard( mapped->guard ) || mTruncated;
+#endif
+            mFile.unmap( mapped->data );
+            mWindows.erase( mapped );
+            return;
+        }
+    }
+}
+
+bool FileMapping::isTruncated() const {
+#ifdef Q_OS_UNIX
+    for ( const Window& window : mWindows ) {
+        if ( gGuards[ window.guard ].faulted ) {
+            return true;
+        }
+    }
+#endif
+    return mTruncated;
+}
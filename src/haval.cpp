@@ -117,10 +117,6 @@
 
 #include "haval.hpp"
 
-#include <cstdio>
-#include <cstring>
-#include <stdexcept>
-#include <sys/stat.h>
 
 /* Nonlinear F functions */
 
@@ -173,10 +169,8 @@
 	} \
 }
 
-#define HAVAL_VERSION	1
-
-
-void Haval::havalTransform3 ( uint32_t E[8], const byte D[128], uint32_t T[8] ) {
+void haval::transform3( uint32_t E[8], const byte D[128] ) {
+    uint32_t T[8];
 
 #ifndef BIG_ENDIAN_HOST
     uint32_t* W = ( uint32_t* )D;
@@ -302,7 +296,8 @@ void Haval::havalTransform3 ( uint32_t E[8], const byte D[128], uint32_t T[8] )
 
 }
 
-void Haval::havalTransform4 ( uint32_t E[8], const byte D[128], uint32_t T[8] ) {
+void haval::transform4( uint32_t E[8], const byte D[128] ) {
+    uint32_t T[8];
 #ifndef BIG_ENDIAN_HOST
     uint32_t* W = ( uint32_t* )D;
 #else
@@ -464,7 +459,8 @@ void Haval::havalTransform4 ( uint32_t E[8], const byte D[128], uint32_t T[8] )
 
 }
 
-void Haval::havalTransform5 ( uint32_t E[8], const byte D[128], uint32_t T[8] ) {
+void haval::transform5( uint32_t E[8], const byte D[128] ) {
+    uint32_t T[8];
 #ifndef BIG_ENDIAN_HOST
     uint32_t* W = ( uint32_t* )D;
 #else
@@ -663,217 +659,3 @@ void Haval::havalTransform5 ( uint32_t E[8], const byte D[128], uint32_t T[8] )
     E[0] += T[0] = HAVAL_ROTR ( F5 ( T[3], T[6], T[1], T[7], T[5], T[4], T[2] ), 7 ) + HAVAL_ROTR ( T[0], 11 ) + W[15] + 0x409F60C4UL;
 
 }
-
-Haval::Haval( uint16_t hashLength, uint16_t passes ) : mContext( new HAVAL_CONTEXT ), mPasses( passes ), mLength( hashLength )  {
-    if ( passes != 3 && passes != 4 && passes != 5 )
-        throw std::invalid_argument( "Invalid number of passes" );
-    if ( hashLength != 128 && hashLength != 160 && hashLength != 192 &&
-            hashLength != 224 && hashLength != 256 )
-        throw std::invalid_argument( "Invalid hash length" );
-
-}
-
-Haval::~Haval() {
-    delete mContext;
-    mContext = NULL;
-}
-
-void Haval::init() {
-    /* properly initialize HAVAL context: */
-    mhash_bzero( mContext, sizeof ( HAVAL_CONTEXT ) );
-    mContext->digest[0] = 0x243F6A88UL;
-    mContext->digest[1] = 0x85A308D3UL;
-    mContext->digest[2] = 0x13198A2EUL;
-    mContext->digest[3] = 0x03707344UL;
-    mContext->digest[4] = 0xA4093822UL;
-    mContext->digest[5] = 0x299F31D0UL;
-    mContext->digest[6] = 0x082EFA98UL;
-    mContext->digest[7] = 0xEC4E6C89UL;
-}
-
-void Haval::write( const byte* dataBuffer, int dataLength ) {
-    if ( dataBuffer == NULL || dataLength == 0 ) {
-        return; /* nothing to do */
-    }
-
-    /* update bit count: Extra parentheses for Borland C++ --Tines*/
-    if ( ( ( uint32_t )dataLength << 3 ) > ( 0xFFFFFFFFUL - mContext->bitCount[0] ) ) {
-        mContext->bitCount[1]++;
-    }
-    mContext->bitCount[0] += ( uint32_t )dataLength << 3;
-
-    /* if the data buffer is not enough to complete */
-    /* the context data block, just append it: */
-    if ( mContext->occupied + ( uint32_t )dataLength < 128 ) { /* caveat: typecast avoids 16-bit overflow */
-        memcpy ( &mContext->block[mContext->occupied], dataBuffer, dataLength );
-        mContext->occupied += dataLength;
-        return; /* delay processing */
-    }
-
-    /* complete the context data block: */
-    memcpy ( &mContext->block[mContext->occupied], dataBuffer, 128 - mContext->occupied );
-    dataBuffer += 128 - mContext->occupied;
-    dataLength -= 128 - mContext->occupied;
-
-    switch ( mPasses ) {
-        case 3:
-            /* process the completed context data block: */
-            havalTransform3 ( mContext->digest, mContext->block, mContext->temp );
-            /* process data in chunks of 128 bytes: */
-            while ( dataLength >= 128 ) {
-                havalTransform3 ( mContext->digest, dataBuffer, mContext->temp );
-                dataBuffer += 128;
-                dataLength -= 128;
-            }
-            break;
-        case 4:
-            /* process the completed context data block: */
-            havalTransform4 ( mContext->digest, mContext->block, mContext->temp );
-            /* process data in chunks of 128 bytes: */
-            while ( dataLength >= 128 ) {
-                havalTransform4 ( mContext->digest, dataBuffer, mContext->temp );
-                dataBuffer += 128;
-                dataLength -= 128;
-            }
-            break;
-        case 5:
-            /* process the completed context data block: */
-            havalTransform5 ( mContext->digest, mContext->block, mContext->temp );
-            /* process data in chunks of 128 bytes: */
-            while ( dataLength >= 128 ) {
-                havalTransform5 ( mContext->digest, dataBuffer, mContext->temp );
-                dataBuffer += 128;
-                dataLength -= 128;
-            }
-            break;
-    }
-
-    /* delay processing of remaining data: */
-    memcpy ( mContext->block, dataBuffer, dataLength );
-    mContext->occupied = dataLength; /* < 128 */
-}
-
-
-byte* Haval::final() {
-    uint32_t w;
-
-    /* append toggle to the context data block: */
-    mContext->block[mContext->occupied] = 0x01; /* corrected from 0x80 */
-
-    /* pad the message with null bytes to make it 944 (mod 1024) bits long: */
-    if ( mContext->occupied++ >= 118 ) {
-        /* no room for tail data on the current context block */
-        mhash_bzero ( &mContext->block[mContext->occupied], 128 - mContext->occupied );
-        /* process the completed context data block: */
-        switch ( mPasses ) {
-            case 3:
-                havalTransform3 ( mContext->digest, mContext->block, mContext->temp );
-                break;
-            case 4:
-                havalTransform4 ( mContext->digest, mContext->block, mContext->temp );
-                break;
-            case 5:
-                havalTransform5 ( mContext->digest, mContext->block, mContext->temp );
-                break;
-        }
-        mhash_bzero ( mContext->block, 118 );
-    } else {
-        mhash_bzero ( &mContext->block[mContext->occupied], 118 - mContext->occupied );
-    }
-    /* append tail data and process last (padded) message block: */
-    mContext->block[118] = ( byte )(
-                              ( ( mLength & 0x03U ) << 6 ) |
-                              ( ( mPasses & 0x07U ) << 3 ) |
-                              ( HAVAL_VERSION           & 0x07U ) );
-    mContext->block[119] = ( byte ) ( mLength >> 2 );
-    w = mContext->bitCount[0];
-    mContext->block[120] = ( byte )( w );
-    mContext->block[121] = ( byte )( w >>  8 );
-    mContext->block[122] = ( byte )( w >> 16 );
-    mContext->block[123] = ( byte )( w >> 24 );
-    w = mContext->bitCount[1];
-    mContext->block[124] = ( byte )( w );
-    mContext->block[125] = ( byte )( w >>  8 );
-    mContext->block[126] = ( byte )( w >> 16 );
-    mContext->block[127] = ( byte )( w >> 24 );
-    switch ( mPasses ) {
-        case 3:
-            havalTransform3 ( mContext->digest, mContext->block, mContext->temp );
-            break;
-        case 4:
-            havalTransform4 ( mContext->digest, mContext->block, mContext->temp );
-            break;
-        case 5:
-            havalTransform5 ( mContext->digest, mContext->block, mContext->temp );
-            break;
-    }
-
-    /* fold 256-bit digest to fit the desired hash length (blaargh!): */
-    /* Byte reverse each 32-bit section while outputting if big-endian -- Tines*/
-    switch ( mLength ) {
-        case 128:
-            mContext->digest[3] +=
-                ( ( mContext->digest[7] & 0xFF000000UL )
-                  | ( mContext->digest[6] & 0x00FF0000UL )
-                  | ( mContext->digest[5] & 0x0000FF00UL )
-                  | ( mContext->digest[4] & 0x000000FFUL )
-                );
-            mContext->digest[2] +=
-                ( ( ( mContext->digest[7] & 0x00FF0000UL )
-                    | ( mContext->digest[6] & 0x0000FF00UL )
-                    | ( mContext->digest[5] & 0x000000FFUL )
-                  ) << 8 ) |
-                ( ( mContext->digest[4] & 0xFF000000UL ) >> 24 );
-            mContext->digest[1] +=
-                ( ( ( mContext->digest[7] & 0x0000FF00UL )
-                    | ( mContext->digest[6] & 0x000000FFUL ) ) << 16 ) |
-                ( ( ( mContext->digest[5] & 0xFF000000UL )
-                    | ( mContext->digest[4] & 0x00FF0000UL ) ) >> 16 );
-            mContext->digest[0] +=
-                ( ( ( mContext->digest[6] & 0xFF000000UL )
-                    | ( mContext->digest[5] & 0x00FF0000UL )
-                    | ( mContext->digest[4] & 0x0000FF00UL )
-                  ) >> 8 ) |
-                ( ( mContext->digest[7] & 0x000000FFUL ) << 24 );
-            break;
-        case 160:
-            mContext->digest[4] +=
-                ( ( mContext->digest[7] & 0xFE000000UL ) | ( mContext->digest[6] & 0x01F80000UL ) | ( mContext->digest[5] & 0x0007F000UL ) ) >> 12;
-            mContext->digest[3] +=
-                ( ( mContext->digest[7] & 0x01F80000UL ) | ( mContext->digest[6] & 0x0007F000UL ) | ( mContext->digest[5] & 0x00000FC0UL ) ) >> 6;
-            mContext->digest[2] +=
-                ( ( mContext->digest[7] & 0x0007F000UL ) | ( mContext->digest[6] & 0x00000FC0UL ) | ( mContext->digest[5] & 0x0000003FUL ) );
-            mContext->digest[1] +=
-                HAVAL_ROTR
-                ( ( mContext->digest[7] & 0x00000FC0UL ) | ( mContext->digest[6] & 0x0000003FUL ) | ( mContext->digest[5] & 0xFE000000UL ), 25 );
-            mContext->digest[0] +=
-                HAVAL_ROTR
-                ( ( mContext->digest[7] & 0x0000003FUL ) | ( mContext->digest[6] & 0xFE000000UL ) | ( mContext->digest[5] & 0x01F80000UL ), 19 );
-            break;
-        case 192:
-            mContext->digest[5] +=
-                ( ( mContext->digest[7] & 0xFC000000UL ) | ( mContext->digest[6] & 0x03E00000UL ) ) >> 21;
-            mContext->digest[4] +=
-                ( ( mContext->digest[7] & 0x03E00000UL ) | ( mContext->digest[6] & 0x001F0000UL ) ) >> 16;
-            mContext->digest[3] +=
-                ( ( mContext->digest[7] & 0x001F0000UL ) | ( mContext->digest[6] & 0x0000FC00UL ) ) >> 10;
-            mContext->digest[2] +=
-                ( ( mContext->digest[7] & 0x0000FC00UL ) | ( mContext->digest[6] & 0x000003E0UL ) ) >>  5;
-            mContext->digest[1] +=
-                ( ( mContext->digest[7] & 0x000003E0UL ) | ( mContext->digest[6] & 0x0000001FUL ) );
-            mContext->digest[0] +=
-                HAVAL_ROTR
-                ( ( mContext->digest[7] & 0x0000001FUL ) | ( mContext->digest[6] & 0xFC000000UL ), 26 );
-            break;
-        case 224:
-            mContext->digest[6] += ( mContext->digest[7]      ) & 0x0000000FUL;
-            mContext->digest[5] += ( mContext->digest[7] >>  4 ) & 0x0000001FUL;
-            mContext->digest[4] += ( mContext->digest[7] >>  9 ) & 0x0000000FUL;
-            mContext->digest[3] += ( mContext->digest[7] >> 13 ) & 0x0000001FUL;
-            mContext->digest[2] += ( mContext->digest[7] >> 18 ) & 0x0000000FUL;
-            mContext->digest[1] += ( mContext->digest[7] >> 22 ) & 0x0000001FUL;
-            mContext->digest[0] += ( mContext->digest[7] >> 27 ) & 0x0000001FUL;
-            break;
-    }
-    return reinterpret_cast<byte*>( mContext->digest );
-}
@@ -0,0 +1,312 @@
+#include "keccak.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cpufeatures.hpp"
+
+#ifdef MRHASH_X86_64
+#include <immintrin.h>
+#endif
+
+namespace {
+    const uint64_t ROUND_CONSTANTS[ 24 ] = {
+        0x0000000000000001ULL, 0x0000000000008082ULL, 0x800000000000808aULL, 0x8000000080008000ULL,
+        0x000000000000808bULL, 0x0000000080000001ULL, 0x8000000080008081ULL, 0x8000000000008009ULL,
+        0x000000000000008aULL, 0x0000000000000088ULL, 0x0000000080008009ULL, 0x000000008000000aULL,
+        0x000000008000808bULL, 0x800000000000008bULL, 0x8000000000008089ULL, 0x8000000000008003ULL,
+        0x8000000000008002ULL, 0x8000000000000080ULL, 0x000000000000800aULL, 0x800000008000000aULL,
+        0x8000000080008081ULL, 0x8000000000008080ULL, 0x0000000080000001ULL, 0x8000000080008008ULL
+    };
+
+    inline uint64_t rotl( uint64_t x, int n ) { return ( x << n ) | ( x >> ( 64 - n ) ); }
+
+    inline uint64_t load64( const byte* data ) {
+        quint64 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    /* One round with theta, rho and pi, chi and iota unrolled: b is the state after rho and pi,
+     * indexed (as a) by x + 5 y */
+    inline void round( uint64_t a[ 25 ], uint64_t rc ) {
+        const uint64_t c0 = a[ 0 ] ^ a[ 5 ] ^ a[ 10 ] ^ a[ 15 ] ^ a[ 20 ];
+        const uint64_t c1 = a[ 1 ] ^ a[ 6 ] ^ a[ 11 ] ^ a[ 16 ] ^ a[ 21 ];
+        const uint64_t c2 = a[ 2 ] ^ a[ 7 ] ^ a[ 12 ] ^ a[ 17 ] ^ a[ 22 ];
+        const uint64_t c3 = a[ 3 ] ^ a[ 8 ] ^ a[ 13 ] ^ a[ 18 ] ^ a[ 23 ];
+        const uint64_t c4 = a[ 4 ] ^ a[ 9 ] ^ a[ 14 ] ^ a[ 19 ] ^ a[ 24 ];
+        const uint64_t d0 = c4 ^ rotl( c1, 1 );
+        const uint64_t d1 = c0 ^ rotl( c2, 1 );
+        const uint64_t d2 = c1 ^ rotl( c3, 1 );
+        const uint64_t d3 = c2 ^ rotl( c4, 1 );
+        const uint64_t d4 = c3 ^ rotl( c0, 1 );
+        const uint64_t b0 = a[ 0 ] ^ d0;
+        const uint64_t b1 = rotl( a[ 6 ] ^ d1, 44 );
+        const uint64_t b2 = rotl( a[ 12 ] ^ d2, 43 );
+        const uint64_t b3 = rotl( a[ 18 ] ^ d3, 21 );
+        const uint64_t b4 = rotl( a[ 24 ] ^ d4, 14 );
+        const uint64_t b5 = rotl( a[ 3 ] ^ d3, 28 );
+        const uint64_t b6 = rotl( a[ 9 ] ^ d4, 20 );
+        const uint64_t b7 = rotl( a[ 10 ] ^ d0, 3 );
+        const uint64_t b8 = rotl( a[ 16 ] ^ d1, 45 );
+        const uint64_t b9 = rotl( a[ 22 ] ^ d2, 61 );
+        const uint64_t b10 = rotl( a[ 1 ] ^ d1, 1 );
+        const uint64_t b11 = rotl( a[ 7 ] ^ d2, 6 );
+        const uint64_t b12 = rotl( a[ 13 ] ^ d3, 25 );
+        const uint64_t b13 = rotl( a[ 19 ] ^ d4, 8 );
+        const uint64_t b14 = rotl( a[ 20 ] ^ d0, 18 );
+        const uint64_t b15 = rotl( a[ 4 ] ^ d4, 27 );
+        const uint64_t b16 = rotl( a[ 5 ] ^ d0, 36 );
+        const uint64_t b17 = rotl( a[ 11 ] ^ d1, 10 );
+        const uint64_t b18 = rotl( a[ 17 ] ^ d2, 15 );
+        const uint64_t b19 = rotl( a[ 23 ] ^ d3, 56 );
+        const uint64_t b20 = rotl( a[ 2 ] ^ d2, 62 );
+        const uint64_t b21 = rotl( a[ 8 ] ^ d3, 55 );
+        const uint64_t b22 = rotl( a[ 14 ] ^ d4, 39 );
+        const uint64_t b23 = rotl( a[ 15 ] ^ d0, 41 );
+        const uint64_t b24 = rotl( a[ 21 ] ^ d1, 2 );
+        a[ 0 ] = b0 ^ ( ~b1 & b2 ) ^ rc;
+        a[ 1 ] = b1 ^ ( ~b2 & b3 );
+        a[ 2 ] = b2 ^ ( ~b3 & b4 );
+        a[ 3 ] = b3 ^ ( ~b4 & b0 );
+        a[ 4 ] = b4 ^ ( ~b0 & b1 );
+        a[ 5 ] = b5 ^ ( ~b6 & b7 );
+        a[ 6 ] = b6 ^ ( ~b7 & b8 );
+        a[ 7 ] = b7 ^ ( ~b8 & b9 );
+        a[ 8 ] = b8 ^ ( ~b9 & b5 );
+        a[ 9 ] = b9 ^ ( ~b5 & b6 );
+        a[ 10 ] = b10 ^ ( ~b11 & b12 );
+        a[ 11 ] = b11 ^ ( ~b12 & b13 );
+        a[ 12 ] = b12 ^ ( ~b13 & b14 );
+        a[ 13 ] = b13 ^ ( ~b14 & b10 );
+        a[ 14 ] = b14 ^ ( ~b10 & b11 );
+        a[ 15 ] = b15 ^ ( ~b16 & b17 );
+        a[ 16 ] = b16 ^ ( ~b17 & b18 );
+        a[ 17 ] = b17 ^ ( ~b18 & b19 );
+        a[ 18 ] = b18 ^ ( ~b19 & b15 );
+        a[ 19 ] = b19 ^ ( ~b15 & b16 );
+        a[ 20 ] = b20 ^ ( ~b21 & b22 );
+        a[ 21 ] = b21 ^ ( ~b22 & b23 );
+        a[ 22 ] = b22 ^ ( ~b23 & b24 );
+        a[ 23 ] = b23 ^ ( ~b24 & b20 );
+        a[ 24 ] = b24 ^ ( ~b20 & b21 );
+    }
+
+#ifdef MRHASH_X86_64
+    template< int N >
+    MRHASH_TARGET( "avx2" )
+    inline __m256i rotl256( __m256i x ) {
+        return _mm256_or_si256( _mm256_slli_epi64( x, N ), _mm256_srli_epi64( x, 64 - N ) );
+    }
+
+    MRHASH_TARGET( "avx2" )
+    inline __m256i xor5( __m256i a, __m256i b, __m256i c, __m256i d, __m256i e ) {
+        return _mm256_xor_si256( _mm256_xor_si256( _mm256_xor_si256( a, b ), _mm256_xor_si256( c, d ) ), e );
+    }
+
+    // The same round on four states, each in one of the 64 bit elements of the vectors
+    MRHASH_TARGET( "avx2" )
+    inline void roundAvx2( __m256i a[ 25 ], __m256i rc ) {
+        const __m256i c0 = xor5( a[ 0 ], a[ 5 ], a[ 10 ], a[ 15 ], a[ 20 ] );
+        const __m256i c1 = xor5( a[ 1 ], a[ 6 ], a[ 11 ], a[ 16 ], a[ 21 ] );
+        const __m256i c2 = xor5( a[ 2 ], a[ 7 ], a[ 12 ], a[ 17 ], a[ 22 ] );
+        const __m256i c3 = xor5( a[ 3 ], a[ 8 ], a[ 13 ], a[ 18 ], a[ 23 ] );
+        const __m256i c4 = xor5( a[ 4 ], a[ 9 ], a[ 14 ], a[ 19 ], a[ 24 ] );
+        const __m256i d0 = _mm256_xor_si256( c4, rotl256< 1 >( c1 ) );
+        const __m256i d1 = _mm256_xor_si256( c0, rotl256< 1 >( c2 ) );
+        const __m256i d2 = _mm256_xor_si256( c1, rotl256< 1 >( c3 ) );
+        const __m256i d3 = _mm256_xor_si256( c2, rotl256< 1 >( c4 ) );
+        const __m256i d4 = _mm256_xor_si256( c3, rotl256< 1 >( c0 ) );
+        const __m256i b0 = _mm256_xor_si256( a[ 0 ], d0 );
+        const __m256i b1 = rotl256< 44 >( _mm256_xor_si256( a[ 6 ], d1 ) );
+        const __m256i b2 = rotl256< 43 >( _mm256_xor_si256( a[ 12 ], d2 ) );
+        const __m256i b3 = rotl256< 21 >( _mm256_xor_si256( a[ 18 ], d3 ) );
+        const __m256i b4 = rotl256< 14 >( _mm256_xor_si256( a[ 24 ], d4 ) );
+        const __m256i b5 = rotl256< 28 >( _mm256_xor_si256( a[ 3 ], d3 ) );
+        const __m256i b6 = rotl256< 20 >( _mm256_xor_si256( a[ 9 ], d4 ) );
+        const __m256i b7 = rotl256< 3 >( _mm256_xor_si256( a[ 10 ], d0 ) );
+        const __m256i b8 = rotl256< 45 >( _mm256_xor_si256( a[ 16 ], d1 ) );
+        const __m256i b9 = rotl256< 61 >( _mm256_xor_si256( a[ 22 ], d2 ) );
+        const __m256i b10 = rotl256< 1 >( _mm256_xor_si256( a[ 1 ], d1 ) );
+        const __m256i b11 = rotl256< 6 >( _mm256_xor_si256( a[ 7 ], d2 ) );
+        const __m256i b12 = rotl256< 25 >( _mm256_xor_si256( a[ 13 ], d3 ) );
+        const __m256i b13 = rotl256< 8 >( _mm256_xor_si256( a[ 19 ], d4 ) );
+        const __m256i b14 = rotl256< 18 >( _mm256_xor_si256( a[ 20 ], d0 ) );
+        const __m256i b15 = rotl256< 27 >( _mm256_xor_si256( a[ 4 ], d4 ) );
+        const __m256i b16 = rotl256< 36 >( _mm256_xor_si256( a[ 5 ], d0 ) );
+        const __m256i b17 = rotl256< 10 >( _mm256_xor_si256( a[ 11 ], d1 ) );
+        const __m256i b18 = rotl256< 15 >( _mm256_xor_si256( a[ 17 ], d2 ) );
+        const __m256i b19 = rotl256< 56 >( _mm256_xor_si256( a[ 23 ], d3 ) );
+        const __m256i b20 = rotl256< 62 >( _mm256_xor_si256( a[ 2 ], d2 ) );
+        const __m256i b21 = rotl256< 55 >( _mm256_xor_si256( a[ 8 ], d3 ) );
+        const __m256i b22 = rotl256< 39 >( _mm256_xor_si256( a[ 14 ], d4 ) );
+        const __m256i b23 = rotl256< 41 >( _mm256_xor_si256( a[ 15 ], d0 ) );
+        const __m256i b24 = rotl256< 2 >( _mm256_xor_si256( a[ 21 ], d1 ) );
+        a[ 0 ] = _mm256_xor_si256( _mm256_xor_si256( b0, _mm256_andnot_si256( b1, b2 ) ), rc );
+        a[ 1 ] = _mm256_xor_si256( b1, _mm256_andnot_si256( b2, b3 ) );
+        a[ 2 ] = _mm256_xor_si256( b2, _mm256_andnot_si256( b3, b4 ) );
+        a[ 3 ] = _mm256_xor_si256( b3, _mm256_andnot_si256( b4, b0 ) );
+        a[ 4 ] = _mm256_xor_si256( b4, _mm256_andnot_si256( b0, b1 ) );
+        a[ 5 ] = _mm256_xor_si256( b5, _mm256_andnot_si256( b6, b7 ) );
+        a[ 6 ] = _mm256_xor_si256( b6, _mm256_andnot_si256( b7, b8 ) );
+        a[ 7 ] = _mm256_xor_si256( b7, _mm256_andnot_si256( b8, b9 ) );
+        a[ 8 ] = _mm256_xor_si256( b8, _mm256_andnot_si256( b9, b5 ) );
+        a[ 9 ] = _mm256_xor_si256( b9, _mm256_andnot_si256( b5, b6 ) );
+        a[ 10 ] = _mm256_xor_si256( b10, _mm256_andnot_si256( b11, b12 ) );
+        a[ 11 ] = _mm256_xor_si256( b11, _mm256_andnot_si256( b12, b13 ) );
+        a[ 12 ] = _mm256_xor_si256( b12, _mm256_andnot_si256( b13, b14 ) );
+        a[ 13 ] = _mm256_xor_si256( b13, _mm256_andnot_si256( b14, b10 ) );
+        a[ 14 ] = _mm256_xor_si256( b14, _mm256_andnot_si256( b10, b11 ) );
+        a[ 15 ] = _mm256_xor_si256( b15, _mm256_andnot_si256( b16, b17 ) );
+        a[ 16 ] = _mm256_xor_si256( b16, _mm256_andnot_si256( b17, b18 ) );
+        a[ 17 ] = _mm256_xor_si256( b17, _mm256_andnot_si256( b18, b19 ) );
+        a[ 18 ] = _mm256_xor_si256( b18, _mm256_andnot_si256( b19, b15 ) );
+        a[ 19 ] = _mm256_xor_si256( b19, _mm256_andnot_si256( b15, b16 ) );
+        a[ 20 ] = _mm256_xor_si256( b20, _mm256_andnot_si256( b21, b22 ) );
+        a[ 21 ] = _mm256_xor_si256( b21, _mm256_andnot_si256( b22, b23 ) );
+        a[ 22 ] = _mm256_xor_si256( b22, _mm256_andnot_si256( b23, b24 ) );
+        a[ 23 ] = _mm256_xor_si256( b23, _mm256_andnot_si256( b24, b20 ) );
+        a[ 24 ] = _mm256_xor_si256( b24, _mm256_andnot_si256( b20, b21 ) );
+    }
+
+    // Permutes the states selected by the bits of sponges (at least one), leaving the others untouched
+    MRHASH_TARGET( "avx2" )
+    void permuteAvx2( uint64_t states[ 25 ][ 4 ], unsigned int sponges ) {
+        const __m256i selected = _mm256_setr_epi64x( ( sponges & 1 ) ? -1 : 0, ( sponges & 2 ) ? -1 : 0,
+                                                      ( sponges & 4 ) ? -1 : 0, ( sponges & 8 ) ? -1 : 0 );
+        __m256i a[ 25 ];
+        for ( int i = 0; i < 25; ++i ) {
+            a[ i ] = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( states[ i ] ) );
+        }
+        for ( int r = 0; r < 24; ++r ) {
+            roundAvx2( a, _mm256_set1_epi64x( static_cast< long long >( ROUND_CONSTANTS[ r ] ) ) );
+        }
+        for ( int i = 0; i < 25; ++i ) {
+            _mm256_maskstore_epi64( reinterpret_cast< long long* >( states[ i ] ), selected, a[ i ] );
+        }
+    }
+#endif
+
+    keccak::Kernel selectKernel() {
+        keccak::Kernel kernel = keccak::Portable;
+#ifdef MRHASH_X86_64
+        if ( cpu::features().avx2 ) {
+            kernel = keccak::Avx2;
+        }
+#endif
+        qCInfo( cpu::kernels ) << "Keccak kernel:" << keccak::kernelName( kernel );
+        return kernel;
+    }
+}
+
+keccak::Kernel keccak::kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+const char* keccak::kernelName( Kernel kernel ) {
+    switch ( kernel ) {
+        case Avx2:
+            return "AVX2";
+        default:
+            return "portable";
+    }
+}
+
+void keccak::permute( uint64_t state[ 25 ] ) {
+    for ( int r = 0; r < 24; ++r ) {
+        round( state, ROUND_CONSTANTS[ r ] );
+    }
+}
+
+Sha3Set::Sha3Set() : mCount( 0 ) {
+    reset();
+}
+
+std::size_t Sha3Set::add( std::size_t digestLength ) {
+    mLengths[ mCount ] = digestLength;
+    mRates[ mCount ] = 200 - 2 * digestLength;
+    return mCount++;
+}
+
+void Sha3Set::reset() {
+    std::memset( mStates, 0, sizeof( mStates ) );
+    std::memset( mOffsets, 0, sizeof( mOffsets ) );
+}
+
+void Sha3Set::write( const byte* data, std::size_t length ) {
+    // each sponge goes through the data at its own pace, a permutation serves all those with a full block
+    std::size_t positions[ MAX_SPONGES ] = { 0, 0, 0, 0 };
+    for ( ;; ) {
+        unsigned int full = 0;
+        for ( std::size_t i = 0; i < mCount; ++i ) {
+            std::size_t taken = qMin( mRates[ i ] - mOffsets[ i ], length - positions[ i ] );
+            absorb( i, data + positions[ i ], taken );
+            positions[ i ] += taken;
+            if ( mOffsets[ i ] == mRates[ i ] ) {
+                full |= 1u << i;
+                mOffsets[ i ] = 0;
+            }
+        }
+        if ( full == 0 ) {
+            return;
+        }
+        permute( full );
+    }
+}
+
+void Sha3Set::final() {
+    unsigned int all = 0;
+    for ( std::size_t i = 0; i < mCount; ++i ) {
+        absorbByte( i, mOffsets[ i ], 0x06 );
+        absorbByte( i, mRates[ i ] - 1, 0x80 );
+        all |= 1u << i;
+    }
+    permute( all );
+    for ( std::size_t i = 0; i < mCount; ++i ) {
+        for ( std::size_t k = 0; k < mLengths[ i ]; ++k ) {
+            mDigests[ i ][ k ] = static_cast< byte >( mStates[ k / 8 ][ i ] >> ( 8 * ( k % 8 ) ) );
+        }
+    }
+    reset();
+}
+
+void Sha3Set::absorb( std::size_t sponge, const byte* data, std::size_t length ) {
+    std::size_t offset = mOffsets[ sponge ];
+    for ( ; length > 0 && offset % 8 != 0; --length ) {
+        absorbByte( sponge, offset++, *data++ );
+    }
+    for ( ; length >= 8; length -= 8, offset += 8, data += 8 ) {
+        mStates[ offset / 8 ][ sponge ] ^= load64( data );
+    }
+    for ( ; length > 0; --length ) {
+        absorbByte( sponge, offset++, *data++ );
+    }
+    mOffsets[ sponge ] = offset;
+}
+
+void Sha3Set::absorbByte( std::size_t sponge, std::size_t offset, byte value ) {
+    mStates[ offset / 8 ][ sponge ] ^= static_cast< uint64_t >( value ) << ( 8 * ( offset % 8 ) );
+}
+
+void Sha3Set::permute( unsigned int sponges ) {
+#ifdef MRHASH_X86_64
+    // a single state is permuted faster by the scalar code
+    if ( keccak::kernel() == keccak::Avx2 && ( sponges & ( sponges - 1 ) ) != 0 ) {
+        return permuteAvx2( mStates, sponges );
+    }
+#endif
+    for ( std::size_t i = 0; i < mCount; ++i ) {
+        if ( sponges & ( 1u << i ) ) {
+            uint64_t state[ 25 ];
+            for ( int j = 0; j < 25; ++j ) {
+                state[ j ] = mStates[ j ][ i ];
+            }
+            keccak::permute( state );
+            for ( int j = 0; j < 25; ++j ) {
+                mStates[ j ][ i ] = state[ j ];
+            }
+        }
+    }
+}
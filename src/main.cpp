@@ -6,9 +6,16 @@
 #include <QDebug>
 #endif
 
+#include "commandline.hpp"
 #include "mainwindow.hpp"
 
 int main( int argc, char* argv[] ) {
+    if ( CommandLine::isRequested( argc, argv ) ) {
+        QCoreApplication a( argc, argv ); //no widgets, translations or icons
+        CommandLine commandLine;
+        return commandLine.exec();
+    }
+
     QApplication a( argc, argv );
 
     QTranslator translator;
@@ -14,7 +14,6 @@ GNU General Public License for more details.
 A copy of the GNU General Public License is available at
 <http://www.gnu.org/licenses/>.
 */
-#include <QCryptographicHash>
 #include <QDesktopWidget>
 #include <QFileDialog>
 #include <QMimeData>
@@ -24,20 +23,23 @@ A copy of the GNU General Public License is available at
 #include <QDebug>
 #endif
 
-#include "qtcryptohash/qcryptohash.hpp"
-#include "qextrahash.hpp"
-#include "crc.hpp"
+#include "digest.hpp"
 
 #include "mainwindow.hpp"
 #include "base64dialog.hpp"
 #include "about.hpp"
 #include "util.hpp"
+#include "disklayout.hpp"
 
 using namespace std;
 
 #define MAX_BASE64_FILESIZE 5 * 1024 * 1024 // 5 MB
 
 #define UPPERCASE_SETTING QStringLiteral("show_uppercase")
+#define CACHE_NEUTRAL_SETTING QStringLiteral("cache_neutral")
+#define HDD_READERS_SETTING QStringLiteral("hdd_readers")
+#define SSD_READERS_SETTING QStringLiteral("ssd_readers")
+#define ALGORITHMS_SETTING QStringLiteral("algorithms")
 
 #ifdef Q_OS_WIN
 /* Needed to read correctly the file properties on NTFS file systems,
@@ -61,6 +63,10 @@ MainWindow::MainWindow( QWidget* parent ) : QMainWindow( parent ),
     setAcceptDrops( true );
 
     actionUseUppercase->setChecked( mSettings.value( UPPERCASE_SETTING, false ).toBool() );
+    actionCacheNeutral->setChecked( mSettings.value( CACHE_NEUTRAL_SETTING, false ).toBool() );
+    //files read at once from each disk, 0 for no limit
+    disklayout::setReaders( disklayout::Rotational, mSettings.value( HDD_READERS_SETTING, 1 ).toInt() );
+    disklayout::setReaders( disklayout::SolidState, mSettings.value( SSD_READERS_SETTING, 0 ).toInt() );
     fileInfoWidget->setVisible( false );
     closeButton->setVisible( false );
     actionClose->setDisabled( true );
@@ -74,34 +80,41 @@ MainWindow::MainWindow( QWidget* parent ) : QMainWindow( parent ),
     connect( actionOpen, SIGNAL( triggered() ), this, SLOT( on_browseButton_clicked() ) );
     connect( actionClose, SIGNAL( triggered() ), this, SLOT( on_closeButton_clicked() ) );
 
-    mHashEdits.push_front( haval256edit );
-    mHashEdits.push_front( haval224edit );
-    mHashEdits.push_front( haval192edit );
-    mHashEdits.push_front( haval160edit );
-    mHashEdits.push_front( haval128edit );
-    mHashEdits.push_front( ripemdedit );
-    mHashEdits.push_front( tigeredit );
-    mHashEdits.push_front( sha3512edit );
-    mHashEdits.push_front( sha3384edit );
-    mHashEdits.push_front( sha3256edit );
-    mHashEdits.push_front( sha3224edit );
-    mHashEdits.push_front( sha512edit );
-    mHashEdits.push_front( sha384edit );
-    mHashEdits.push_front( sha256edit );
-    mHashEdits.push_front( sha224edit );
-    mHashEdits.push_front( sha1edit );
-    mHashEdits.push_front( md5edit );
-    mHashEdits.push_front( md4edit );
-    mHashEdits.push_front( crc64edit );
-    mHashEdits.push_front( crc32edit );
-    mHashEdits.push_front( crc16edit );
+    addAlgorithm( algorithms::CRC16, crc16check, crc16edit );
+    addAlgorithm( algorithms::CRC32, crc32check, crc32edit );
+    addAlgorithm( algorithms::CRC64, crc64check, crc64edit );
+    addAlgorithm( algorithms::CRC32C, crc32ccheck, crc32cedit );
+    addAlgorithm( algorithms::MD4, md4check, md4edit );
+    addAlgorithm( algorithms::MD5, md5check, md5edit );
+    addAlgorithm( algorithms::SHA1, sha1check, sha1edit );
+    addAlgorithm( algorithms::SHA224, sha224check, sha224edit );
+    addAlgorithm( algorithms::SHA256, sha256check, sha256edit );
+    addAlgorithm( algorithms::SHA384, sha384check, sha384edit );
+    addAlgorithm( algorithms::SHA512, sha512check, sha512edit );
+    addAlgorithm( algorithms::SHA3_224, sha3224check, sha3224edit );
+    addAlgorithm( algorithms::SHA3_256, sha3256check, sha3256edit );
+    addAlgorithm( algorithms::SHA3_384, sha3384check, sha3384edit );
+    addAlgorithm( algorithms::SHA3_512, sha3512check, sha3512edit );
+    addAlgorithm( algorithms::TIGER, tigercheck, tigeredit );
+    addAlgorithm( algorithms::RIPEMD160, ripemdcheck, ripemdedit );
+    addAlgorithm( algorithms::HAVAL128, haval128check, haval128edit );
+    addAlgorithm( algorithms::HAVAL160, haval160check, haval160edit );
+    addAlgorithm( algorithms::HAVAL192, haval192check, haval192edit );
+    addAlgorithm( algorithms::HAVAL224, haval224check, haval224edit );
+    addAlgorithm( algorithms::HAVAL256, haval256check, haval256edit );
+    addAlgorithm( algorithms::BLAKE3, blake3check, blake3edit );
+    addAlgorithm( algorithms::XXH3_64, xxh364check, xxh364edit );
+    addAlgorithm( algorithms::XXH3_128, xxh3128check, xxh3128edit );
 }
 
 MainWindow::~MainWindow() {}
 
 void MainWindow::closeEvent( QCloseEvent* event ) {
     mSettings.setValue( UPPERCASE_SETTING, actionUseUppercase->isChecked() );
-    if ( mHashCalculator != nullptr && mHashCalculator->isRunning() ) {
+    mSettings.setValue( CACHE_NEUTRAL_SETTING, actionCacheNeutral->isChecked() );
+    mSettings.setValue( ALGORITHMS_SETTING, algorithms::toNames( selectedAlgorithms() ) );
+    bool calculatorRunning = mHashCalculator != nullptr && mHashCalculator->isRunning();
+    if ( calculatorRunning || ( mBatchDialog != nullptr && mBatchDialog->isRunning() ) ) {
         event->ignore();
         QMessageBox closeMsg( QMessageBox::Question,
                               tr( "Work in progress..." ),
@@ -112,11 +125,14 @@ void MainWindow::closeEvent( QCloseEvent* event ) {
         closeMsg.setButtonText( QMessageBox::No, tr( "No" ) );
         closeMsg.exec();
         if ( closeMsg.result() == QMessageBox::Yes ) {
-            FileHashCalculator* calculator = mHashCalculator.release();
-            if ( calculator->isPaused() ) {
-                calculator->resume();
+            if ( calculatorRunning ) {
+                FileHashCalculator* calculator = mHashCalculator.release();
+                if ( calculator->isPaused() ) {
+                    calculator->resume();
+                }
+                calculator->stop();
             }
-            calculator->stop();
+            mBatchDialog.reset(); //cancels the files still queued
             event->accept();
         }
     }
@@ -131,9 +147,12 @@ void MainWindow::dropEvent( QDropEvent* event ) {
 
     if ( mimeData->hasUrls() ) {
         QList< QUrl > urlList = mimeData->urls();
-        if ( urlList.length() > 1 ) {
-            QMessageBox::information( this, tr( "Too many files!" ), tr( "Mr. Hash can calculate the hashes of just one file!" ) );
-            event->ignore();
+        if ( urlList.length() > 1 || QFileInfo( urlList.at( 0 ).toLocalFile() ).isDir() ) {
+            QStringList filePaths;
+            foreach ( const QUrl& url, urlList ) {
+                filePaths << url.toLocalFile();
+            }
+            openFiles( filePaths );
         } else {
             tabWidget->setCurrentIndex( 0 );
             openFile( urlList.at( 0 ).toLocalFile() );
@@ -166,8 +185,14 @@ void MainWindow::on_plainTextEdit_textChanged() {
 
 void MainWindow::on_browseButton_clicked() {
     QFileDialog fileDialog( this );
-    if ( fileDialog.exec() == QFileDialog::Accepted && fileDialog.selectedFiles().size() != 0 ) {
-        openFile( fileDialog.selectedFiles()[0] );
+    fileDialog.setFileMode( QFileDialog::ExistingFiles );
+    if ( fileDialog.exec() == QFileDialog::Accepted ) {
+        QStringList selectedFiles = fileDialog.selectedFiles();
+        if ( selectedFiles.size() > 1 ) {
+            openFiles( selectedFiles );
+        } else if ( selectedFiles.size() != 0 ) {
+            openFile( selectedFiles[0] );
+        }
     }
 }
 
@@ -227,6 +252,9 @@ void MainWindow::on_closeButton_clicked() {
         mHashCalculator->stop();
     }
     tabWidget->tabBar()->setEnabled( true );
+    foreach ( QCheckBox* check, mAlgorithmChecks ) {
+        check->setEnabled( true );
+    }
     filePathEdit->clear();
     dragDropLabel->setVisible( true );
     fileInfoWidget->setVisible( false );
@@ -238,27 +266,42 @@ void MainWindow::on_closeButton_clicked() {
     cleanHashEdits();
 }
 
-void MainWindow::on_newHashString( int index, QByteArray hash ) {
-    if ( mHashEdits[index] == base64edit )
-        mHashEdits[index]->setText( hash );
-    else
-        mHashEdits[index]->setText( util::hash_hex( hash, actionUseUppercase->isChecked() ) );
-    mHashEdits[index]->setCursorPosition( 0 );
+void MainWindow::on_algorithmToggled() {
+    foreach ( algorithms::Id id, mAlgorithmChecks.keys() ) {
+        mHashEdits[ id ]->setEnabled( mAlgorithmChecks[ id ]->isChecked() );
+    }
+    if ( tabWidget->currentIndex() != 0 ) { // text tab selected!
+        on_plainTextEdit_textChanged();
+    }
 }
 
-void MainWindow::on_newChecksumValue( int index, quint64 value ) {
-    mHashEdits[index]->setText( util::checksum_hex( value, actionUseUppercase->isChecked() ) );
-    mHashEdits[index]->setCursorPosition( 0 );
+void MainWindow::on_newHashString( int id, QByteArray hash ) {
+    QLineEdit* hashEdit = mHashEdits.value( static_cast< algorithms::Id >( id ) );
+    hashEdit->setText( util::hash_hex( hash, actionUseUppercase->isChecked() ) );
+    hashEdit->setCursorPosition( 0 );
+}
+
+void MainWindow::on_newChecksumValue( int id, quint64 value ) {
+    QLineEdit* hashEdit = mHashEdits.value( static_cast< algorithms::Id >( id ) );
+    hashEdit->setText( util::checksum_hex( value, actionUseUppercase->isChecked() ) );
+    hashEdit->setCursorPosition( 0 );
 }
 
 void MainWindow::on_progressUpdate( float progress ) {
     progressBar->setValue( progress * 100 );
 }
 
+void MainWindow::on_failed( QString error ) {
+    cleanHashEdits( true, error );
+}
+
 void MainWindow::on_finished() {
     progressBar->setVisible( false );
     pauseButton->setVisible( false );
     tabWidget->tabBar()->setEnabled( true );
+    foreach ( QCheckBox* check, mAlgorithmChecks ) {
+        check->setEnabled( true );
+    }
 }
 
 void MainWindow::on_pauseButton_clicked() {
@@ -278,12 +321,32 @@ void MainWindow::on_pauseButton_clicked() {
 void MainWindow::cleanHashEdits( bool usePlaceholder, QString placeholder ) {
     foreach ( QLineEdit* lineEdit, findChildren<QLineEdit*>() ) {
         if ( lineEdit != filePathEdit ) {
-            lineEdit->setPlaceholderText( usePlaceholder && lineEdit != base64edit ? placeholder : "" );
+            bool showPlaceholder = usePlaceholder && lineEdit != base64edit && lineEdit->isEnabled();
+            lineEdit->setPlaceholderText( showPlaceholder ? placeholder : "" );
             lineEdit->clear();
         }
     }
 }
 
+void MainWindow::addAlgorithm( algorithms::Id id, QCheckBox* check, QLineEdit* edit ) {
+    QStringList selected = mSettings.value( ALGORITHMS_SETTING, algorithms::toNames( algorithms::Set::all() ) ).toStringList();
+    check->setChecked( selected.contains( algorithms::name( id ) ) );
+    edit->setEnabled( check->isChecked() );
+    mAlgorithmChecks.insert( id, check );
+    mHashEdits.insert( id, edit );
+    connect( check, SIGNAL( toggled( bool ) ), this, SLOT( on_algorithmToggled() ) );
+}
+
+algorithms::Set MainWindow::selectedAlgorithms() const {
+    algorithms::Set selected;
+    foreach ( algorithms::Id id, mAlgorithmChecks.keys() ) {
+        if ( mAlgorithmChecks[ id ]->isChecked() ) {
+            selected.insert( id );
+        }
+    }
+    return selected;
+}
+
 void MainWindow::openFile( QString filePath ) {
     dragDropLabel->setVisible( false );
 
@@ -296,6 +359,18 @@ void MainWindow::openFile( QString filePath ) {
     calculateFileHashes( filePath );
 }
 
+void MainWindow::openFiles( QStringList filePaths ) {
+    /* the files dropped while the table is open are added to it (with its algorithms),
+     * otherwise a new table is opened with the algorithms selected now */
+    if ( mBatchDialog == nullptr || ( !mBatchDialog->isVisible() && !mBatchDialog->isRunning() ) ) {
+        mBatchDialog.reset( new BatchDialog( this, selectedAlgorithms(), actionUseUppercase->isChecked() ) );
+    }
+    mBatchDialog->enqueue( filePaths, actionCacheNeutral->isChecked() );
+    mBatchDialog->show();
+    mBatchDialog->raise();
+    mBatchDialog->activateWindow();
+}
+
 void MainWindow::readFileInfo( QString filePath ) {
 #ifdef Q_OS_WIN
     qt_ntfs_permission_lookup++;
@@ -317,42 +392,33 @@ void MainWindow::calculateFileHashes( QString fileName ) {
         mHashCalculator->stop();
     }
     tabWidget->tabBar()->setEnabled( false );
+    foreach ( QCheckBox* check, mAlgorithmChecks ) {
+        check->setEnabled( false );
+    }
     cleanHashEdits( true );
-    mHashCalculator.reset( new FileHashCalculator( this, fileName ) );
+    mHashCalculator.reset( new FileHashCalculator( this, fileName, selectedAlgorithms() ) );
+    mHashCalculator->setCacheNeutral( actionCacheNeutral->isChecked() );
     connect( mHashCalculator.get(), SIGNAL( newHashString( int, QByteArray ) ), this, SLOT( on_newHashString( int, QByteArray ) ) );
     connect( mHashCalculator.get(), SIGNAL( newChecksumValue( int, quint64 ) ), this, SLOT( on_newChecksumValue( int, quint64 ) ) );
     connect( mHashCalculator.get(), SIGNAL( progressUpdate( float ) ), this, SLOT( on_progressUpdate( float ) ) );
+    connect( mHashCalculator.get(), SIGNAL( failed( QString ) ), this, SLOT( on_failed( QString ) ) );
     connect( mHashCalculator.get(), SIGNAL( finished() ), this, SLOT( on_finished() ) );
     mHashCalculator->start();
 }
 
 void MainWindow::calculateHashes( QByteArray content, bool show_uppercase ) {
     using namespace util;
-    crc16edit->setText( checksum_hex( QChecksum::checksum( content, QChecksum::CRC16 ), show_uppercase ) );
-    crc32edit->setText( checksum_hex( QChecksum::checksum( content, QChecksum::CRC32 ), show_uppercase ) );
-    crc64edit->setText( checksum_hex( QChecksum::checksum( content, QChecksum::CRC64 ), show_uppercase ) );
-    md4edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Md4 ), show_uppercase ) );
-    md5edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Md5 ), show_uppercase ) );
-    sha1edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha1 ), show_uppercase ) );
-    sha224edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha224 ), show_uppercase ) );
-    sha256edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha256 ), show_uppercase ) );
-    sha384edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha384 ), show_uppercase ) );
-    sha512edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha512 ), show_uppercase ) );
-    sha3224edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha3_224 ), show_uppercase ) );
-    sha3256edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha3_256 ), show_uppercase ) );
-    sha3384edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha3_384 ), show_uppercase ) );
-    sha3512edit->setText( hash_hex( QCryptographicHash::hash( content, QCryptographicHash::Sha3_512 ), show_uppercase ) );
-    tigeredit->setText( hash_hex( QCryptoHash::hash( content, QCryptoHash::TIGER ), show_uppercase ) );
-    ripemdedit->setText( hash_hex( QCryptoHash::hash( content, QCryptoHash::RMD160 ), show_uppercase ) );
-    haval128edit->setText( hash_hex( QExtraHash::hash( content, QExtraHash::HAVAL128 ), show_uppercase ) );
-    haval160edit->setText( hash_hex( QExtraHash::hash( content, QExtraHash::HAVAL160 ), show_uppercase ) );
-    haval192edit->setText( hash_hex( QExtraHash::hash( content, QExtraHash::HAVAL192 ), show_uppercase ) );
-    haval224edit->setText( hash_hex( QExtraHash::hash( content, QExtraHash::HAVAL224 ), show_uppercase ) );
-    haval256edit->setText( hash_hex( QExtraHash::hash( content, QExtraHash::HAVAL256 ), show_uppercase ) );
+    algorithms::Set selected = selectedAlgorithms();
+    foreach ( algorithms::Id id, mHashEdits.keys() ) {
+        QLineEdit* hashEdit = mHashEdits[ id ];
+        if ( !selected.contains( id ) ) {
+            hashEdit->clear();
+        } else if ( algorithms::isChecksum( id ) ) {
+            hashEdit->setText( checksum_hex( Digest::checksum( content, id ), show_uppercase ) );
+        } else {
+            hashEdit->setText( hash_hex( Digest::hash( content, id ), show_uppercase ) );
+            hashEdit->setCursorPosition( 0 );
+        }
+    }
     base64edit->setText( content.toBase64( QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals ) );
-
-    sha384edit->setCursorPosition( 0 );
-    sha512edit->setCursorPosition( 0 );
-    sha3384edit->setCursorPosition( 0 );
-    sha3512edit->setCursorPosition( 0 );
 }
@@ -0,0 +1,242 @@
+#include "md.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+    inline uint32_t rotl( uint32_t x, int n ) { return ( x << n ) | ( x >> ( 32 - n ) ); }
+
+    inline uint32_t load32( const byte* data ) {
+        quint32 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    // The boolean functions of the four rounds of MD5; MD4 uses the first, the majority (4) and the third
+    template< int F >
+    inline uint32_t f( uint32_t x, uint32_t y, uint32_t z );
+
+    template<>
+    inline uint32_t f< 0 >( uint32_t x, uint32_t y, uint32_t z ) { return z ^ ( x & ( y ^ z ) ); }
+
+    template<>
+    inline uint32_t f< 1 >( uint32_t x, uint32_t y, uint32_t z ) { return y ^ ( z & ( x ^ y ) ); }
+
+    template<>
+    inline uint32_t f< 2 >( uint32_t x, uint32_t y, uint32_t z ) { return x ^ y ^ z; }
+
+    template<>
+    inline uint32_t f< 3 >( uint32_t x, uint32_t y, uint32_t z ) { return y ^ ( x | ~z ); }
+
+    template<>
+    inline uint32_t f< 4 >( uint32_t x, uint32_t y, uint32_t z ) { return ( x & y ) | ( z & ( x | y ) ); }
+
+    template< int F >
+    inline void step4( uint32_t& a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t k, int s ) {
+        a = rotl( a + f< F >( b, c, d ) + x + k, s );
+    }
+
+    template< int F >
+    inline void step5( uint32_t& a, uint32_t b, uint32_t c, uint32_t d, uint32_t x, uint32_t k, int s ) {
+        a = b + rotl( a + f< F >( b, c, d ) + x + k, s );
+    }
+}
+
+const uint32_t md::IV[ 4 ] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476 };
+
+void md::compress4( uint32_t state[ 4 ], const byte* blocks, std::size_t count ) {
+    for ( ; count > 0; --count, blocks += 64 ) {
+        uint32_t x[ 16 ];
+        for ( int i = 0; i < 16; ++i ) {
+            x[ i ] = load32( blocks + 4 * i );
+        }
+        uint32_t a = state[ 0 ], b = state[ 1 ], c = state[ 2 ], d = state[ 3 ];
+        step4< 0 >( a, b, c, d, x[ 0 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 1 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 2 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 3 ], 0, 19 );
+        step4< 0 >( a, b, c, d, x[ 4 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 5 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 6 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 7 ], 0, 19 );
+        step4< 0 >( a, b, c, d, x[ 8 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 9 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 10 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 11 ], 0, 19 );
+        step4< 0 >( a, b, c, d, x[ 12 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 13 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 14 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 15 ], 0, 19 );
+
+        step4< 4 >( a, b, c, d, x[ 0 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 4 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 8 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 12 ], 0x5a827999, 13 );
+        step4< 4 >( a, b, c, d, x[ 1 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 5 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 9 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 13 ], 0x5a827999, 13 );
+        step4< 4 >( a, b, c, d, x[ 2 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 6 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 10 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 14 ], 0x5a827999, 13 );
+        step4< 4 >( a, b, c, d, x[ 3 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 7 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 11 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 15 ], 0x5a827999, 13 );
+
+        step4< 2 >( a, b, c, d, x[ 0 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 8 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 4 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 12 ], 0x6ed9eba1, 15 );
+        step4< 2 >( a, b, c, d, x[ 2 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 10 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 6 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 14 ], 0x6ed9eba1, 15 );
+        step4< 2 >( a, b, c, d, x[ 1 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 9 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 5 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 13 ], 0x6ed9eba1, 15 );
+        step4< 2 >( a, b, c, d, x[ 3 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 11 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 7 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 15 ], 0x6ed9eba1, 15 );
+
+        state[ 0 ] += a;
+        state[ 1 ] += b;
+        state[ 2 ] += c;
+        state[ 3 ] += d;
+    }
+}
+
+void md::compress5( uint32_t state[ 4 ], const byte* blocks, std::size_t count ) {
+    for ( ; count > 0; --count, blocks += 64 ) {
+        uint32_t x[ 16 ];
+        for ( int i = 0; i < 16; ++i ) {
+            x[ i ] = load32( blocks + 4 * i );
+        }
+        uint32_t a = state[ 0 ], b = state[ 1 ], c = state[ 2 ], d = state[ 3 ];
+        step5< 0 >( a, b, c, d, x[ 0 ], 0xd76aa478, 7 );
+        step5< 0 >( d, a, b, c, x[ 1 ], 0xe8c7b756, 12 );
+        step5< 0 >( c, d, a, b, x[ 2 ], 0x242070db, 17 );
+        step5< 0 >( b, c, d, a, x[ 3 ], 0xc1bdceee, 22 );
+        step5< 0 >( a, b, c, d, x[ 4 ], 0xf57c0faf, 7 );
+        step5< 0 >( d, a, b, c, x[ 5 ], 0x4787c62a, 12 );
+        step5< 0 >( c, d, a, b, x[ 6 ], 0xa8304613, 17 );
+        step5< 0 >( b, c, d, a, x[ 7 ], 0xfd469501, 22 );
+        step5< 0 >( a, b, c, d, x[ 8 ], 0x698098d8, 7 );
+        step5< 0 >( d, a, b, c, x[ 9 ], 0x8b44f7af, 12 );
+        step5< 0 >( c, d, a, b, x[ 10 ], 0xffff5bb1, 17 );
+        step5< 0 >( b, c, d, a, x[ 11 ], 0x895cd7be, 22 );
+        step5< 0 >( a, b, c, d, x[ 12 ], 0x6b901122, 7 );
+        step5< 0 >( d, a, b, c, x[ 13 ], 0xfd987193, 12 );
+        step5< 0 >( c, d, a, b, x[ 14 ], 0xa679438e, 17 );
+        step5< 0 >( b, c, d, a, x[ 15 ], 0x49b40821, 22 );
+
+        step5< 1 >( a, b, c, d, x[ 1 ], 0xf61e2562, 5 );
+        step5< 1 >( d, a, b, c, x[ 6 ], 0xc040b340, 9 );
+        step5< 1 >( c, d, a, b, x[ 11 ], 0x265e5a51, 14 );
+        step5< 1 >( b, c, d, a, x[ 0 ], 0xe9b6c7aa, 20 );
+        step5< 1 >( a, b, c, d, x[ 5 ], 0xd62f105d, 5 );
+        step5< 1 >( d, a, b, c, x[ 10 ], 0x02441453, 9 );
+        step5< 1 >( c, d, a, b, x[ 15 ], 0xd8a1e681, 14 );
+        step5< 1 >( b, c, d, a, x[ 4 ], 0xe7d3fbc8, 20 );
+        step5< 1 >( a, b, c, d, x[ 9 ], 0x21e1cde6, 5 );
+        step5< 1 >( d, a, b, c, x[ 14 ], 0xc33707d6, 9 );
+        step5< 1 >( c, d, a, b, x[ 3 ], 0xf4d50d87, 14 );
+        step5< 1 >( b, c, d, a, x[ 8 ], 0x455a14ed, 20 );
+        step5< 1 >( a, b, c, d, x[ 13 ], 0xa9e3e905, 5 );
+        step5< 1 >( d, a, b, c, x[ 2 ], 0xfcefa3f8, 9 );
+        step5< 1 >( c, d, a, b, x[ 7 ], 0x676f02d9, 14 );
+        step5< 1 >( b, c, d, a, x[ 12 ], 0x8d2a4c8a, 20 );
+
+        step5< 2 >( a, b, c, d, x[ 5 ], 0xfffa3942, 4 );
+        step5< 2 >( d, a, b, c, x[ 8 ], 0x8771f681, 11 );
+        step5< 2 >( c, d, a, b, x[ 11 ], 0x6d9d6122, 16 );
+        step5< 2 >( b, c, d, a, x[ 14 ], 0xfde5380c, 23 );
+        step5< 2 >( a, b, c, d, x[ 1 ], 0xa4beea44, 4 );
+        step5< 2 >( d, a, b, c, x[ 4 ], 0x4bdecfa9, 11 );
+        step5< 2 >( c, d, a, b, x[ 7 ], 0xf6bb4b60, 16 );
+        step5< 2 >( b, c, d, a, x[ 10 ], 0xbebfbc70, 23 );
+        step5< 2 >( a, b, c, d, x[ 13 ], 0x289b7ec6, 4 );
+        step5< 2 >( d, a, b, c, x[ 0 ], 0xeaa127fa, 11 );
+        step5< 2 >( c, d, a, b, x[ 3 ], 0xd4ef3085, 16 );
+        step5< 2 >( b, c, d, a, x[ 6 ], 0x04881d05, 23 );
+        step5< 2 >( a, b, c, d, x[ 9 ], 0xd9d4d039, 4 );
+        step5< 2 >( d, a, b, c, x[ 12 ], 0xe6db99e5, 11 );
+        step5< 2 >( c, d, a, b, x[ 15 ], 0x1fa27cf8, 16 );
+        step5< 2 >( b, c, d, a, x[ 2 ], 0xc4ac5665, 23 );
+
+        step5< 3 >( a, b, c, d, x[ 0 ], 0xf4292244, 6 );
+        step5< 3 >( d, a, b, c, x[ 7 ], 0x432aff97, 10 );
+        step5< 3 >( c, d, a, b, x[ 14 ], 0xab9423a7, 15 );
+        step5< 3 >( b, c, d, a, x[ 5 ], 0xfc93a039, 21 );
+        step5< 3 >( a, b, c, d, x[ 12 ], 0x655b59c3, 6 );
+        step5< 3 >( d, a, b, c, x[ 3 ], 0x8f0ccc92, 10 );
+        step5< 3 >( c, d, a, b, x[ 10 ], 0xffeff47d, 15 );
+        step5< 3 >( b, c, d, a, x[ 1 ], 0x85845dd1, 21 );
+        step5< 3 >( a, b, c, d, x[ 8 ], 0x6fa87e4f, 6 );
+        step5< 3 >( d, a, b, c, x[ 15 ], 0xfe2ce6e0, 10 );
+        step5< 3 >( c, d, a, b, x[ 6 ], 0xa3014314, 15 );
+        step5< 3 >( b, c, d, a, x[ 13 ], 0x4e0811a1, 21 );
+        step5< 3 >( a, b, c, d, x[ 4 ], 0xf7537e82, 6 );
+        step5< 3 >( d, a, b, c, x[ 11 ], 0xbd3af235, 10 );
+        step5< 3 >( c, d, a, b, x[ 2 ], 0x2ad7d2bb, 15 );
+        step5< 3 >( b, c, d, a, x[ 9 ], 0xeb86d391, 21 );
+
+        state[ 0 ] += a;
+        state[ 1 ] += b;
+        state[ 2 ] += c;
+        state[ 3 ] += d;
+    }
+}
+
+void md::BlockHash::init() {
+    std::memcpy( mState, IV, sizeof( mState ) );
+    mOccupied = 0;
+    mLength = 0;
+}
+
+void md::BlockHash::write( const byte* inbuf, int inlen ) {
+    std::size_t length = static_cast< std::size_t >( inlen );
+    mLength += length;
+    if ( mOccupied > 0 ) {
+        std::size_t copied = qMin( length, sizeof( mBlock ) - mOccupied );
+        std::memcpy( mBlock + mOccupied, inbuf, copied );
+        mOccupied += copied;
+        inbuf += copied;
+        length -= copied;
+        if ( mOccupied < sizeof( mBlock ) ) {
+            return;
+        }
+        mCompress( mState, mBlock, 1 );
+        mOccupied = 0;
+    }
+    std::size_t count = length / sizeof( mBlock );
+    if ( count > 0 ) {
+        mCompress( mState, inbuf, count );
+        inbuf += count * sizeof( mBlock );
+        length -= count * sizeof( mBlock );
+    }
+    std::memcpy( mBlock, inbuf, length );
+    mOccupied = length;
+}
+
+byte* md::BlockHash::final() {
+    quint64 bitCount = mLength * 8;
+    mBlock[ mOccupied++ ] = 0x80;
+    if ( mOccupied > sizeof( mBlock ) - 8 ) {
+        std::memset( mBlock + mOccupied, 0, sizeof( mBlock ) - mOccupied );
+        mCompress( mState, mBlock, 1 );
+        mOccupied = 0;
+    }
+    std::memset( mBlock + mOccupied, 0, sizeof( mBlock ) - 8 - mOccupied );
+    qToLittleEndian( bitCount, mBlock + sizeof( mBlock ) - 8 );
+    mCompress( mState, mBlock, 1 );
+    for ( int i = 0; i < 4; ++i ) {
+        qToLittleEndian( static_cast< quint32 >( mState[ i ] ), mDigest + 4 * i );
+    }
+    init();
+    return mDigest;
+}
@@ -0,0 +1,453 @@
+#include "multibuffer.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cpufeatures.hpp"
+#include "md.hpp"
+#include "sha.hpp"
+
+#ifdef MRHASH_X86_64
+#include <immintrin.h>
+#endif
+
+using multibuffer::LANES;
+
+namespace {
+    const uint32_t SHA1_IV[ 5 ] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+    const uint32_t SHA1_K[ 4 ] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+    /* Below this number of active lanes, compressing them one after the other with the single-message
+     * functions is faster than running the vector kernel with most of its lanes wasted. */
+    const int MIN_VECTOR_LANES = 3;
+
+    int bitCount( unsigned int bits ) {
+        int count = 0;
+        for ( ; bits != 0; bits &= bits - 1 ) {
+            ++count;
+        }
+        return count;
+    }
+
+#ifdef MRHASH_X86_64
+    MRHASH_TARGET( "avx2" )
+    inline __m256i rotl256( __m256i x, int n ) {
+        return _mm256_or_si256( _mm256_slli_epi32( x, n ), _mm256_srli_epi32( x, 32 - n ) );
+    }
+
+    MRHASH_TARGET( "avx2" )
+    inline __m256i add256( __m256i x, __m256i y, __m256i z ) {
+        return _mm256_add_epi32( _mm256_add_epi32( x, y ), z );
+    }
+
+    /* Loads the eight consecutive words at offset of the blocks of all the lanes and transposes them,
+     * so that the i-th vector holds the i-th word of every lane */
+    MRHASH_TARGET( "avx2" )
+    inline void loadTransposed( const byte* const blocks[ LANES ], std::size_t offset, __m256i* words ) {
+        __m256i rows[ LANES ];
+        for ( std::size_t lane = 0; lane < LANES; ++lane ) {
+            rows[ lane ] = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( blocks[ lane ] + offset ) );
+        }
+        __m256i pairs[ LANES ];
+        for ( std::size_t i = 0; i < LANES; i += 2 ) {
+            pairs[ i ] = _mm256_unpacklo_epi32( rows[ i ], rows[ i + 1 ] );
+            pairs[ i + 1 ] = _mm256_unpackhi_epi32( rows[ i ], rows[ i + 1 ] );
+        }
+        __m256i quads[ LANES ];
+        for ( std::size_t i = 0; i < LANES; i += 4 ) {
+            quads[ i ] = _mm256_unpacklo_epi64( pairs[ i ], pairs[ i + 2 ] );
+            quads[ i + 1 ] = _mm256_unpackhi_epi64( pairs[ i ], pairs[ i + 2 ] );
+            quads[ i + 2 ] = _mm256_unpacklo_epi64( pairs[ i + 1 ], pairs[ i + 3 ] );
+            quads[ i + 3 ] = _mm256_unpackhi_epi64( pairs[ i + 1 ], pairs[ i + 3 ] );
+        }
+        for ( std::size_t i = 0; i < 4; ++i ) {
+            words[ i ] = _mm256_permute2x128_si256( quads[ i ], quads[ i + 4 ], 0x20 );
+            words[ i + 4 ] = _mm256_permute2x128_si256( quads[ i ], quads[ i + 4 ], 0x31 );
+        }
+    }
+
+    MRHASH_TARGET( "avx2" )
+    inline void loadMessage( const byte* const blocks[ LANES ], std::size_t offset, __m256i x[ 16 ] ) {
+        loadTransposed( blocks, offset, x );
+        loadTransposed( blocks, offset + 32, x + 8 );
+    }
+
+    MRHASH_TARGET( "avx2" )
+    inline void loadBigEndianMessage( const byte* const blocks[ LANES ], std::size_t offset, __m256i x[ 16 ] ) {
+        const __m256i bswap = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+        loadMessage( blocks, offset, x );
+        for ( int i = 0; i < 16; ++i ) {
+            x[ i ] = _mm256_shuffle_epi8( x[ i ], bswap );
+        }
+    }
+
+    // The boolean functions of MD4, MD5 and SHA-1 (see md.cpp for the numbering)
+    template< int F >
+    inline __m256i f( __m256i x, __m256i y, __m256i z );
+
+    template<>
+    MRHASH_TARGET( "avx2" )
+    inline __m256i f< 0 >( __m256i x, __m256i y, __m256i z ) {
+        return _mm256_xor_si256( z, _mm256_and_si256( x, _mm256_xor_si256( y, z ) ) );
+    }
+
+    template<>
+    MRHASH_TARGET( "avx2" )
+    inline __m256i f< 1 >( __m256i x, __m256i y, __m256i z ) {
+        return _mm256_xor_si256( y, _mm256_and_si256( z, _mm256_xor_si256( x, y ) ) );
+    }
+
+    template<>
+    MRHASH_TARGET( "avx2" )
+    inline __m256i f< 2 >( __m256i x, __m256i y, __m256i z ) {
+        return _mm256_xor_si256( _mm256_xor_si256( x, y ), z );
+    }
+
+    template<>
+    MRHASH_TARGET( "avx2" )
+    inline __m256i f< 3 >( __m256i x, __m256i y, __m256i z ) {
+        return _mm256_xor_si256( y, _mm256_or_si256( x, _mm256_xor_si256( z, _mm256_set1_epi32( -1 ) ) ) );
+    }
+
+    template<>
+    MRHASH_TARGET( "avx2" )
+    inline __m256i f< 4 >( __m256i x, __m256i y, __m256i z ) {
+        return _mm256_or_si256( _mm256_and_si256( x, y ), _mm256_and_si256( z, _mm256_or_si256( x, y ) ) );
+    }
+
+    template< int F >
+    MRHASH_TARGET( "avx2" )
+    inline void step4( __m256i& a, __m256i b, __m256i c, __m256i d, __m256i x, uint32_t k, int s ) {
+        a = rotl256( add256( a, f< F >( b, c, d ), _mm256_add_epi32( x, _mm256_set1_epi32( static_cast< int >( k ) ) ) ), s );
+    }
+
+    template< int F >
+    MRHASH_TARGET( "avx2" )
+    inline void step5( __m256i& a, __m256i b, __m256i c, __m256i d, __m256i x, uint32_t k, int s ) {
+        a = _mm256_add_epi32( b, rotl256( add256( a, f< F >( b, c, d ), _mm256_add_epi32( x, _mm256_set1_epi32( static_cast< int >( k ) ) ) ), s ) );
+    }
+
+    MRHASH_TARGET( "avx2" )
+    void compress4Avx2( uint32_t states[][ LANES ], const byte* const blocks[ LANES ], std::size_t count ) {
+        __m256i* state = reinterpret_cast< __m256i* >( states );
+        for ( std::size_t offset = 0; offset < count * 64; offset += 64 ) {
+            __m256i x[ 16 ];
+            loadMessage( blocks, offset, x );
+            __m256i a = _mm256_loadu_si256( state ), b = _mm256_loadu_si256( state + 1 );
+            __m256i c = _mm256_loadu_si256( state + 2 ), d = _mm256_loadu_si256( state + 3 );
+        step4< 0 >( a, b, c, d, x[ 0 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 1 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 2 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 3 ], 0, 19 );
+        step4< 0 >( a, b, c, d, x[ 4 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 5 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 6 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 7 ], 0, 19 );
+        step4< 0 >( a, b, c, d, x[ 8 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 9 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 10 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 11 ], 0, 19 );
+        step4< 0 >( a, b, c, d, x[ 12 ], 0, 3 );
+        step4< 0 >( d, a, b, c, x[ 13 ], 0, 7 );
+        step4< 0 >( c, d, a, b, x[ 14 ], 0, 11 );
+        step4< 0 >( b, c, d, a, x[ 15 ], 0, 19 );
+
+        step4< 4 >( a, b, c, d, x[ 0 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 4 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 8 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 12 ], 0x5a827999, 13 );
+        step4< 4 >( a, b, c, d, x[ 1 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 5 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 9 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 13 ], 0x5a827999, 13 );
+        step4< 4 >( a, b, c, d, x[ 2 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 6 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 10 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 14 ], 0x5a827999, 13 );
+        step4< 4 >( a, b, c, d, x[ 3 ], 0x5a827999, 3 );
+        step4< 4 >( d, a, b, c, x[ 7 ], 0x5a827999, 5 );
+        step4< 4 >( c, d, a, b, x[ 11 ], 0x5a827999, 9 );
+        step4< 4 >( b, c, d, a, x[ 15 ], 0x5a827999, 13 );
+
+        step4< 2 >( a, b, c, d, x[ 0 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 8 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 4 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 12 ], 0x6ed9eba1, 15 );
+        step4< 2 >( a, b, c, d, x[ 2 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 10 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 6 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 14 ], 0x6ed9eba1, 15 );
+        step4< 2 >( a, b, c, d, x[ 1 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 9 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 5 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 13 ], 0x6ed9eba1, 15 );
+        step4< 2 >( a, b, c, d, x[ 3 ], 0x6ed9eba1, 3 );
+        step4< 2 >( d, a, b, c, x[ 11 ], 0x6ed9eba1, 9 );
+        step4< 2 >( c, d, a, b, x[ 7 ], 0x6ed9eba1, 11 );
+        step4< 2 >( b, c, d, a, x[ 15 ], 0x6ed9eba1, 15 );
+
+            _mm256_storeu_si256( state, _mm256_add_epi32( _mm256_loadu_si256( state ), a ) );
+            _mm256_storeu_si256( state + 1, _mm256_add_epi32( _mm256_loadu_si256( state + 1 ), b ) );
+            _mm256_storeu_si256( state + 2, _mm256_add_epi32( _mm256_loadu_si256( state + 2 ), c ) );
+            _mm256_storeu_si256( state + 3, _mm256_add_epi32( _mm256_loadu_si256( state + 3 ), d ) );
+        }
+    }
+
+    MRHASH_TARGET( "avx2" )
+    void compress5Avx2( uint32_t states[][ LANES ], const byte* const blocks[ LANES ], std::size_t count ) {
+        __m256i* state = reinterpret_cast< __m256i* >( states );
+        for ( std::size_t offset = 0; offset < count * 64; offset += 64 ) {
+            __m256i x[ 16 ];
+            loadMessage( blocks, offset, x );
+            __m256i a = _mm256_loadu_si256( state ), b = _mm256_loadu_si256( state + 1 );
+            __m256i c = _mm256_loadu_si256( state + 2 ), d = _mm256_loadu_si256( state + 3 );
+        step5< 0 >( a, b, c, d, x[ 0 ], 0xd76aa478, 7 );
+        step5< 0 >( d, a, b, c, x[ 1 ], 0xe8c7b756, 12 );
+        step5< 0 >( c, d, a, b, x[ 2 ], 0x242070db, 17 );
+        step5< 0 >( b, c, d, a, x[ 3 ], 0xc1bdceee, 22 );
+        step5< 0 >( a, b, c, d, x[ 4 ], 0xf57c0faf, 7 );
+        step5< 0 >( d, a, b, c, x[ 5 ], 0x4787c62a, 12 );
+        step5< 0 >( c, d, a, b, x[ 6 ], 0xa8304613, 17 );
+        step5< 0 >( b, c, d, a, x[ 7 ], 0xfd469501, 22 );
+        step5< 0 >( a, b, c, d, x[ 8 ], 0x698098d8, 7 );
+        step5< 0 >( d, a, b, c, x[ 9 ], 0x8b44f7af, 12 );
+        step5< 0 >( c, d, a, b, x[ 10 ], 0xffff5bb1, 17 );
+        step5< 0 >( b, c, d, a, x[ 11 ], 0x895cd7be, 22 );
+        step5< 0 >( a, b, c, d, x[ 12 ], 0x6b901122, 7 );
+        step5< 0 >( d, a, b, c, x[ 13 ], 0xfd987193, 12 );
+        step5< 0 >( c, d, a, b, x[ 14 ], 0xa679438e, 17 );
+        step5< 0 >( b, c, d, a, x[ 15 ], 0x49b40821, 22 );
+
+        step5< 1 >( a, b, c, d, x[ 1 ], 0xf61e2562, 5 );
+        step5< 1 >( d, a, b, c, x[ 6 ], 0xc040b340, 9 );
+        step5< 1 >( c, d, a, b, x[ 11 ], 0x265e5a51, 14 );
+        step5< 1 >( b, c, d, a, x[ 0 ], 0xe9b6c7aa, 20 );
+        step5< 1 >( a, b, c, d, x[ 5 ], 0xd62f105d, 5 );
+        step5< 1 >( d, a, b, c, x[ 10 ], 0x02441453, 9 );
+        step5< 1 >( c, d, a, b, x[ 15 ], 0xd8a1e681, 14 );
+        step5< 1 >( b, c, d, a, x[ 4 ], 0xe7d3fbc8, 20 );
+        step5< 1 >( a, b, c, d, x[ 9 ], 0x21e1cde6, 5 );
+        step5< 1 >( d, a, b, c, x[ 14 ], 0xc33707d6, 9 );
+        step5< 1 >( c, d, a, b, x[ 3 ], 0xf4d50d87, 14 );
+        step5< 1 >( b, c, d, a, x[ 8 ], 0x455a14ed, 20 );
+        step5< 1 >( a, b, c, d, x[ 13 ], 0xa9e3e905, 5 );
+        step5< 1 >( d, a, b, c, x[ 2 ], 0xfcefa3f8, 9 );
+        step5< 1 >( c, d, a, b, x[ 7 ], 0x676f02d9, 14 );
+        step5< 1 >( b, c, d, a, x[ 12 ], 0x8d2a4c8a, 20 );
+
+        step5< 2 >( a, b, c, d, x[ 5 ], 0xfffa3942, 4 );
+        step5< 2 >( d, a, b, c, x[ 8 ], 0x8771f681, 11 );
+        step5< 2 >( c, d, a, b, x[ 11 ], 0x6d9d6122, 16 );
+        step5< 2 >( b, c, d, a, x[ 14 ], 0xfde5380c, 23 );
+        step5< 2 >( a, b, c, d, x[ 1 ], 0xa4beea44, 4 );
+        step5< 2 >( d, a, b, c, x[ 4 ], 0x4bdecfa9, 11 );
+        step5< 2 >( c, d, a, b, x[ 7 ], 0xf6bb4b60, 16 );
+        step5< 2 >( b, c, d, a, x[ 10 ], 0xbebfbc70, 23 );
+        step5< 2 >( a, b, c, d, x[ 13 ], 0x289b7ec6, 4 );
+        step5< 2 >( d, a, b, c, x[ 0 ], 0xeaa127fa, 11 );
+        step5< 2 >( c, d, a, b, x[ 3 ], 0xd4ef3085, 16 );
+        step5< 2 >( b, c, d, a, x[ 6 ], 0x04881d05, 23 );
+        step5< 2 >( a, b, c, d, x[ 9 ], 0xd9d4d039, 4 );
+        step5< 2 >( d, a, b, c, x[ 12 ], 0xe6db99e5, 11 );
+        step5< 2 >( c, d, a, b, x[ 15 ], 0x1fa27cf8, 16 );
+        step5< 2 >( b, c, d, a, x[ 2 ], 0xc4ac5665, 23 );
+
+        step5< 3 >( a, b, c, d, x[ 0 ], 0xf4292244, 6 );
+        step5< 3 >( d, a, b, c, x[ 7 ], 0x432aff97, 10 );
+        step5< 3 >( c, d, a, b, x[ 14 ], 0xab9423a7, 15 );
+        step5< 3 >( b, c, d, a, x[ 5 ], 0xfc93a039, 21 );
+        step5< 3 >( a, b, c, d, x[ 12 ], 0x655b59c3, 6 );
+        step5< 3 >( d, a, b, c, x[ 3 ], 0x8f0ccc92, 10 );
+        step5< 3 >( c, d, a, b, x[ 10 ], 0xffeff47d, 15 );
+        step5< 3 >( b, c, d, a, x[ 1 ], 0x85845dd1, 21 );
+        step5< 3 >( a, b, c, d, x[ 8 ], 0x6fa87e4f, 6 );
+        step5< 3 >( d, a, b, c, x[ 15 ], 0xfe2ce6e0, 10 );
+        step5< 3 >( c, d, a, b, x[ 6 ], 0xa3014314, 15 );
+        step5< 3 >( b, c, d, a, x[ 13 ], 0x4e0811a1, 21 );
+        step5< 3 >( a, b, c, d, x[ 4 ], 0xf7537e82, 6 );
+        step5< 3 >( d, a, b, c, x[ 11 ], 0xbd3af235, 10 );
+        step5< 3 >( c, d, a, b, x[ 2 ], 0x2ad7d2bb, 15 );
+        step5< 3 >( b, c, d, a, x[ 9 ], 0xeb86d391, 21 );
+
+            _mm256_storeu_si256( state, _mm256_add_epi32( _mm256_loadu_si256( state ), a ) );
+            _mm256_storeu_si256( state + 1, _mm256_add_epi32( _mm256_loadu_si256( state + 1 ), b ) );
+            _mm256_storeu_si256( state + 2, _mm256_add_epi32( _mm256_loadu_si256( state + 2 ), c ) );
+            _mm256_storeu_si256( state + 3, _mm256_add_epi32( _mm256_loadu_si256( state + 3 ), d ) );
+        }
+    }
+
+    // The next word of the SHA-1 message schedule, computed in place in the sliding window w
+    MRHASH_TARGET( "avx2" )
+    inline __m256i schedule1( __m256i w[ 16 ], int t ) {
+        if ( t >= 16 ) {
+            __m256i mixed = _mm256_xor_si256( _mm256_xor_si256( w[ ( t - 3 ) & 15 ], w[ ( t - 8 ) & 15 ] ),
+                                              _mm256_xor_si256( w[ ( t - 14 ) & 15 ], w[ t & 15 ] ) );
+            w[ t & 15 ] = rotl256( mixed, 1 );
+        }
+        return w[ t & 15 ];
+    }
+
+    template< int F >
+    MRHASH_TARGET( "avx2" )
+    inline void step1( __m256i a, __m256i& b, __m256i c, __m256i d, __m256i& e, __m256i wk ) {
+        e = add256( e, rotl256( a, 5 ), _mm256_add_epi32( f< F >( b, c, d ), wk ) );
+        b = rotl256( b, 30 );
+    }
+
+    template< int F >
+    MRHASH_TARGET( "avx2" )
+    inline void rounds1Of20( __m256i& a, __m256i& b, __m256i& c, __m256i& d, __m256i& e, __m256i w[ 16 ], int first ) {
+        const __m256i k = _mm256_set1_epi32( static_cast< int >( SHA1_K[ first / 20 ] ) );
+        for ( int t = first; t < first + 20; t += 5 ) {
+            step1< F >( a, b, c, d, e, _mm256_add_epi32( schedule1( w, t ), k ) );
+            step1< F >( e, a, b, c, d, _mm256_add_epi32( schedule1( w, t + 1 ), k ) );
+            step1< F >( d, e, a, b, c, _mm256_add_epi32( schedule1( w, t + 2 ), k ) );
+            step1< F >( c, d, e, a, b, _mm256_add_epi32( schedule1( w, t + 3 ), k ) );
+            step1< F >( b, c, d, e, a, _mm256_add_epi32( schedule1( w, t + 4 ), k ) );
+        }
+    }
+
+    MRHASH_TARGET( "avx2" )
+    void compress1Avx2( uint32_t states[][ LANES ], const byte* const blocks[ LANES ], std::size_t count ) {
+        __m256i* state = reinterpret_cast< __m256i* >( states );
+        for ( std::size_t offset = 0; offset < count * 64; offset += 64 ) {
+            __m256i w[ 16 ];
+            loadBigEndianMessage( blocks, offset, w );
+            __m256i a = _mm256_loadu_si256( state ), b = _mm256_loadu_si256( state + 1 );
+            __m256i c = _mm256_loadu_si256( state + 2 ), d = _mm256_loadu_si256( state + 3 );
+            __m256i e = _mm256_loadu_si256( state + 4 );
+            rounds1Of20< 0 >( a, b, c, d, e, w, 0 );
+            rounds1Of20< 2 >( a, b, c, d, e, w, 20 );
+            rounds1Of20< 4 >( a, b, c, d, e, w, 40 );
+            rounds1Of20< 2 >( a, b, c, d, e, w, 60 );
+            _mm256_storeu_si256( state, _mm256_add_epi32( _mm256_loadu_si256( state ), a ) );
+            _mm256_storeu_si256( state + 1, _mm256_add_epi32( _mm256_loadu_si256( state + 1 ), b ) );
+            _mm256_storeu_si256( state + 2, _mm256_add_epi32( _mm256_loadu_si256( state + 2 ), c ) );
+            _mm256_storeu_si256( state + 3, _mm256_add_epi32( _mm256_loadu_si256( state + 3 ), d ) );
+            _mm256_storeu_si256( state + 4, _mm256_add_epi32( _mm256_loadu_si256( state + 4 ), e ) );
+        }
+    }
+#endif
+
+    multibuffer::Kernel selectKernel() {
+        multibuffer::Kernel kernel = multibuffer::Portable;
+#ifdef MRHASH_X86_64
+        if ( cpu::features().avx2 ) {
+            kernel = multibuffer::Avx2;
+        }
+#endif
+        qCInfo( cpu::kernels ) << "Multi-buffer MD4/MD5/SHA-1 kernel:" << multibuffer::kernelName( kernel );
+        return kernel;
+    }
+}
+
+multibuffer::Kernel multibuffer::kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+const char* multibuffer::kernelName( Kernel kernel ) {
+    switch ( kernel ) {
+        case Avx2:
+            return "AVX2";
+        default:
+            return "portable";
+    }
+}
+
+bool multibuffer::Lanes::supports( algorithms::Id id ) {
+    return id == algorithms::MD4 || id == algorithms::MD5 || id == algorithms::SHA1;
+}
+
+/* With the SHA extensions a single SHA-1 message is already faster than eight in the AVX2 lanes,
+ * so in that case the lanes are compressed one after the other with sha::compress1. */
+multibuffer::Lanes::Lanes( algorithms::Id id )
+    : mId( id ),
+      mStateWords( id == algorithms::SHA1 ? 5 : 4 ),
+      mCompress( id == algorithms::MD4 ? md::compress4 : ( id == algorithms::MD5 ? md::compress5 : sha::compress1 ) ),
+      mVectorized( kernel() == Avx2 && ( id != algorithms::SHA1 || sha::kernel() != sha::Extensions ) ) {
+    for ( std::size_t lane = 0; lane < LANES; ++lane ) {
+        reset( lane );
+    }
+}
+
+void multibuffer::Lanes::reset( std::size_t lane ) {
+    const uint32_t* iv = mId == algorithms::SHA1 ? SHA1_IV : md::IV;
+    for ( std::size_t i = 0; i < mStateWords; ++i ) {
+        mStates[ i ][ lane ] = iv[ i ];
+    }
+}
+
+void multibuffer::Lanes::compress( const byte* const blocks[ LANES ], unsigned int active, std::size_t count ) {
+    if ( count == 0 || active == 0 ) {
+        return;
+    }
+#ifdef MRHASH_X86_64
+    if ( mVectorized && bitCount( active ) >= MIN_VECTOR_LANES ) {
+        // the idle lanes hash the blocks of an active one, their states are reset before being used again
+        const byte* lanes[ LANES ];
+        std::size_t first = 0;
+        while ( ( active & ( 1u << first ) ) == 0 ) {
+            ++first;
+        }
+        for ( std::size_t lane = 0; lane < LANES; ++lane ) {
+            lanes[ lane ] = ( active & ( 1u << lane ) ) != 0 ? blocks[ lane ] : blocks[ first ];
+        }
+        switch ( mId ) {
+            case algorithms::MD4:
+                return compress4Avx2( mStates, lanes, count );
+            case algorithms::MD5:
+                return compress5Avx2( mStates, lanes, count );
+            default:
+                return compress1Avx2( mStates, lanes, count );
+        }
+    }
+#endif
+    for ( std::size_t lane = 0; lane < LANES; ++lane ) {
+        if ( ( active & ( 1u << lane ) ) != 0 ) {
+            compressLane( lane, blocks[ lane ], count );
+        }
+    }
+}
+
+void multibuffer::Lanes::compressLane( std::size_t lane, const byte* blocks, std::size_t count ) {
+    uint32_t state[ 5 ];
+    for ( std::size_t i = 0; i < mStateWords; ++i ) {
+        state[ i ] = mStates[ i ][ lane ];
+    }
+    mCompress( state, blocks, count );
+    for ( std::size_t i = 0; i < mStateWords; ++i ) {
+        mStates[ i ][ lane ] = state[ i ];
+    }
+}
+
+QByteArray multibuffer::Lanes::final( std::size_t lane, const byte* tail, std::size_t tailLength, uint64_t length ) {
+    // MD4 and MD5 store the bit length and the digest in little endian, SHA-1 in big endian
+    const bool bigEndian = mId == algorithms::SHA1;
+    byte blocks[ 128 ];
+    std::memcpy( blocks, tail, tailLength );
+    blocks[ tailLength ] = 0x80;
+    std::size_t padded = tailLength + 1 + 8 <= 64 ? 64 : 128;
+    std::memset( blocks + tailLength + 1, 0, padded - 8 - tailLength - 1 );
+    if ( bigEndian ) {
+        qToBigEndian( static_cast< quint64 >( length * 8 ), blocks + padded - 8 );
+    } else {
+        qToLittleEndian( static_cast< quint64 >( length * 8 ), blocks + padded - 8 );
+    }
+    compressLane( lane, blocks, padded / 64 );
+
+    QByteArray digest( static_cast< int >( 4 * mStateWords ), '\0' );
+    for ( std::size_t i = 0; i < mStateWords; ++i ) {
+        uchar* word = reinterpret_cast< uchar* >( digest.data() ) + 4 * i;
+        if ( bigEndian ) {
+            qToBigEndian( static_cast< quint32 >( mStates[ i ][ lane ] ), word );
+        } else {
+            qToLittleEndian( static_cast< quint32 >( mStates[ i ][ lane ] ), word );
+        }
+    }
+    reset( lane );
+    return digest;
+}
@@ -5,27 +5,66 @@
 
 #include <stdexcept>
 
+namespace {
+    template< typename Algorithm >
+    QByteArray hashWith( const QByteArray& data ) {
+        Algorithm algorithm; // on the stack, no allocations needed
+        algorithm.write( reinterpret_cast< const byte* >( data.constData() ), data.length() );
+        byte* hash_array = algorithm.final();
+        return QByteArray( reinterpret_cast< char* >( hash_array ), algorithm.hash_length() );
+    }
+}
+
 QExtraHash::QExtraHash( Algorithm method ) {
     switch ( method ) {
         case QExtraHash::HAVAL128:
-            mHashAlgorithm = new Haval( 128, 5 );
+            mHashAlgorithm = new Haval< 5, 128 >();
             break;
         case QExtraHash::HAVAL160:
-            mHashAlgorithm = new Haval( 160, 5 );
+            mHashAlgorithm = new Haval< 5, 160 >();
             break;
         case QExtraHash::HAVAL192:
-            mHashAlgorithm = new Haval( 192, 5 );
+            mHashAlgorithm = new Haval< 5, 192 >();
             break;
         case QExtraHash::HAVAL224:
-            mHashAlgorithm = new Haval( 224, 5 );
+            mHashAlgorithm = new Haval< 5, 224 >();
             break;
         case QExtraHash::HAVAL256:
-            mHashAlgorithm = new Haval( 256, 5 );
+            mHashAlgorithm = new Haval< 5, 256 >();
+            break;
+        case QExtraHash::HAVAL3_128:
+            mHashAlgorithm = new Haval< 3, 128 >();
+            break;
+        case QExtraHash::HAVAL3_160:
+            mHashAlgorithm = new Haval< 3, 160 >();
+            break;
+        case QExtraHash::HAVAL3_192:
+            mHashAlgorithm = new Haval< 3, 192 >();
+            break;
+        case QExtraHash::HAVAL3_224:
+            mHashAlgorithm = new Haval< 3, 224 >();
+            break;
+        case QExtraHash::HAVAL3_256:
+            mHashAlgorithm = new Haval< 3, 256 >();
+            break;
+        case QExtraHash::HAVAL4_128:
+            mHashAlgorithm = new Haval< 4, 128 >();
+            break;
+        case QExtraHash::HAVAL4_160:
+            mHashAlgorithm = new Haval< 4, 160 >();
+            break;
+        case QExtraHash::HAVAL4_192:
+            mHashAlgorithm = new Haval< 4, 192 >();
+            break;
+        case QExtraHash::HAVAL4_224:
+            mHashAlgorithm = new Haval< 4, 224 >();
+            break;
+        case QExtraHash::HAVAL4_256:
+            mHashAlgorithm = new Haval< 4, 256 >();
             break;
         default:
             throw std::invalid_argument( "Algorithm not supported" );
     }
-    reset();
 }
 
 QExtraHash::~QExtraHash() {
@@ -39,8 +78,12 @@ void QExtraHash::reset() {
     mHashAlgorithm->init();
 }
 
+void QExtraHash::addData( const char* data, int length ) {
+    mHashAlgorithm->write( reinterpret_cast< const byte* >( data ), length );
+}
+
 void QExtraHash::addData( const QByteArray &data ) {
-    mHashAlgorithm->write( reinterpret_cast< const byte* >( data.constData() ), data.length() );
+    addData( data.constData(), data.length() );
 }
 
 QByteArray QExtraHash::result() const {
@@ -49,7 +92,38 @@ QByteArray QExtraHash::result() const {
 }
 
 QByteArray QExtraHash::hash( const QByteArray &data, QExtraHash::Algorithm method ) {
-    QExtraHash hash( method );
-    hash.addData( data );
-    return hash.result();
+    switch ( method ) {
+        case QExtraHash::HAVAL128:
+            return hashWith< Haval< 5, 128 > >( data );
+        case QExtraHash::HAVAL160:
+            return hashWith< Haval< 5, 160 > >( data );
+        case QExtraHash::HAVAL192:
+            return hashWith< Haval< 5, 192 > >( data );
+        case QExtraHash::HAVAL224:
+            return hashWith< Haval< 5, 224 > >( data );
+        case QExtraHash::HAVAL256:
+            return hashWith< Haval< 5, 256 > >( data );
+        case QExtraHash::HAVAL3_128:
+            return hashWith< Haval< 3, 128 > >( data );
+        case QExtraHash::HAVAL3_160:
+            return hashWith< Haval< 3, 160 > >( data );
+        case QExtraHash::HAVAL3_192:
+            return hashWith< Haval< 3, 192 > >( data );
+        case QExtraHash::HAVAL3_224:
+            return hashWith< Haval< 3, 224 > >( data );
+        case QExtraHash::HAVAL3_256:
+            return hashWith< Haval< 3, 256 > >( data );
+        case QExtraHash::HAVAL4_128:
+            return hashWith< Haval< 4, 128 > >( data );
+        case QExtraHash::HAVAL4_160:
+            return hashWith< Haval< 4, 160 > >( data );
+        case QExtraHash::HAVAL4_192:
+            return hashWith< Haval< 4, 192 > >( data );
+        case QExtraHash::HAVAL4_224:
+            return hashWith< Haval< 4, 224 > >( data );
+        case QExtraHash::HAVAL4_256:
+            return hashWith< Haval< 4, 256 > >( data );
+        default:
+            throw std::invalid_argument( "Algorithm not supported" );
+    }
 }
@@ -0,0 +1,276 @@
+#include "ripemd160.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+namespace {
+    inline uint32_t rotl( uint32_t x, int n ) { return ( x << n ) | ( x >> ( 32 - n ) ); }
+
+    inline uint32_t load32( const byte* data ) {
+        quint32 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    // The five boolean functions, used in opposite order by the two lines
+    template< int F >
+    inline uint32_t f( uint32_t x, uint32_t y, uint32_t z );
+
+    template<>
+    inline uint32_t f< 0 >( uint32_t x, uint32_t y, uint32_t z ) { return x ^ y ^ z; }
+
+    template<>
+    inline uint32_t f< 1 >( uint32_t x, uint32_t y, uint32_t z ) { return z ^ ( x & ( y ^ z ) ); }
+
+    template<>
+    inline uint32_t f< 2 >( uint32_t x, uint32_t y, uint32_t z ) { return ( x | ~y ) ^ z; }
+
+    template<>
+    inline uint32_t f< 3 >( uint32_t x, uint32_t y, uint32_t z ) { return y ^ ( z & ( x ^ y ) ); }
+
+    template<>
+    inline uint32_t f< 4 >( uint32_t x, uint32_t y, uint32_t z ) { return x ^ ( y | ~z ); }
+
+    template< int F >
+    inline void step( uint32_t& a, uint32_t b, uint32_t& c, uint32_t d, uint32_t e, uint32_t wk, int s ) {
+        a = rotl( a + f< F >( b, c, d ) + wk, s ) + e;
+        c = rotl( c, 10 );
+    }
+}
+
+void ripemd160::compress( uint32_t state[ 5 ], const byte* blocks, std::size_t count ) {
+    for ( ; count > 0; --count, blocks += 64 ) {
+        uint32_t x[ 16 ];
+        for ( int i = 0; i < 16; ++i ) {
+            x[ i ] = load32( blocks + 4 * i );
+        }
+        uint32_t al = state[ 0 ], bl = state[ 1 ], cl = state[ 2 ], dl = state[ 3 ], el = state[ 4 ];
+        uint32_t ar = al, br = bl, cr = cl, dr = dl, er = el;
+        /* The steps of the left and of the right line alternate, so that the two independent dependency
+         * chains fill the pipeline; the roles of the variables rotate instead of their values. */
+        step< 0 >( al, bl, cl, dl, el, x[ 0 ], 11 );
+        step< 4 >( ar, br, cr, dr, er, x[ 5 ] + 0x50a28be6, 8 );
+        step< 0 >( el, al, bl, cl, dl, x[ 1 ], 14 );
+        step< 4 >( er, ar, br, cr, dr, x[ 14 ] + 0x50a28be6, 9 );
+        step< 0 >( dl, el, al, bl, cl, x[ 2 ], 15 );
+        step< 4 >( dr, er, ar, br, cr, x[ 7 ] + 0x50a28be6, 9 );
+        step< 0 >( cl, dl, el, al, bl, x[ 3 ], 12 );
+        step< 4 >( cr, dr, er, ar, br, x[ 0 ] + 0x50a28be6, 11 );
+        step< 0 >( bl, cl, dl, el, al, x[ 4 ], 5 );
+        step< 4 >( br, cr, dr, er, ar, x[ 9 ] + 0x50a28be6, 13 );
+        step< 0 >( al, bl, cl, dl, el, x[ 5 ], 8 );
+        step< 4 >( ar, br, cr, dr, er, x[ 2 ] + 0x50a28be6, 15 );
+        step< 0 >( el, al, bl, cl, dl, x[ 6 ], 7 );
+        step< 4 >( er, ar, br, cr, dr, x[ 11 ] + 0x50a28be6, 15 );
+        step< 0 >( dl, el, al, bl, cl, x[ 7 ], 9 );
+        step< 4 >( dr, er, ar, br, cr, x[ 4 ] + 0x50a28be6, 5 );
+        step< 0 >( cl, dl, el, al, bl, x[ 8 ], 11 );
+        step< 4 >( cr, dr, er, ar, br, x[ 13 ] + 0x50a28be6, 7 );
+        step< 0 >( bl, cl, dl, el, al, x[ 9 ], 13 );
+        step< 4 >( br, cr, dr, er, ar, x[ 6 ] + 0x50a28be6, 7 );
+        step< 0 >( al, bl, cl, dl, el, x[ 10 ], 14 );
+        step< 4 >( ar, br, cr, dr, er, x[ 15 ] + 0x50a28be6, 8 );
+        step< 0 >( el, al, bl, cl, dl, x[ 11 ], 15 );
+        step< 4 >( er, ar, br, cr, dr, x[ 8 ] + 0x50a28be6, 11 );
+        step< 0 >( dl, el, al, bl, cl, x[ 12 ], 6 );
+        step< 4 >( dr, er, ar, br, cr, x[ 1 ] + 0x50a28be6, 14 );
+        step< 0 >( cl, dl, el, al, bl, x[ 13 ], 7 );
+        step< 4 >( cr, dr, er, ar, br, x[ 10 ] + 0x50a28be6, 14 );
+        step< 0 >( bl, cl, dl, el, al, x[ 14 ], 9 );
+        step< 4 >( br, cr, dr, er, ar, x[ 3 ] + 0x50a28be6, 12 );
+        step< 0 >( al, bl, cl, dl, el, x[ 15 ], 8 );
+        step< 4 >( ar, br, cr, dr, er, x[ 12 ] + 0x50a28be6, 6 );
+
+        step< 1 >( el, al, bl, cl, dl, x[ 7 ] + 0x5a827999, 7 );
+        step< 3 >( er, ar, br, cr, dr, x[ 6 ] + 0x5c4dd124, 9 );
+        step< 1 >( dl, el, al, bl, cl, x[ 4 ] + 0x5a827999, 6 );
+        step< 3 >( dr, er, ar, br, cr, x[ 11 ] + 0x5c4dd124, 13 );
+        step< 1 >( cl, dl, el, al, bl, x[ 13 ] + 0x5a827999, 8 );
+        step< 3 >( cr, dr, er, ar, br, x[ 3 ] + 0x5c4dd124, 15 );
+        step< 1 >( bl, cl, dl, el, al, x[ 1 ] + 0x5a827999, 13 );
+        step< 3 >( br, cr, dr, er, ar, x[ 7 ] + 0x5c4dd124, 7 );
+        step< 1 >( al, bl, cl, dl, el, x[ 10 ] + 0x5a827999, 11 );
+        step< 3 >( ar, br, cr, dr, er, x[ 0 ] + 0x5c4dd124, 12 );
+        step< 1 >( el, al, bl, cl, dl, x[ 6 ] + 0x5a827999, 9 );
+        step< 3 >( er, ar, br, cr, dr, x[ 13 ] + 0x5c4dd124, 8 );
+        step< 1 >( dl, el, al, bl, cl, x[ 15 ] + 0x5a827999, 7 );
+        step< 3 >( dr, er, ar, br, cr, x[ 5 ] + 0x5c4dd124, 9 );
+        step< 1 >( cl, dl, el, al, bl, x[ 3 ] + 0x5a827999, 15 );
+        step< 3 >( cr, dr, er, ar, br, x[ 10 ] + 0x5c4dd124, 11 );
+        step< 1 >( bl, cl, dl, el, al, x[ 12 ] + 0x5a827999, 7 );
+        step< 3 >( br, cr, dr, er, ar, x[ 14 ] + 0x5c4dd124, 7 );
+        step< 1 >( al, bl, cl, dl, el, x[ 0 ] + 0x5a827999, 12 );
+        step< 3 >( ar, br, cr, dr, er, x[ 15 ] + 0x5c4dd124, 7 );
+        step< 1 >( el, al, bl, cl, dl, x[ 9 ] + 0x5a827999, 15 );
+        step< 3 >( er, ar, br, cr, dr, x[ 8 ] + 0x5c4dd124, 12 );
+        step< 1 >( dl, el, al, bl, cl, x[ 5 ] + 0x5a827999, 9 );
+        step< 3 >( dr, er, ar, br, cr, x[ 12 ] + 0x5c4dd124, 7 );
+        step< 1 >( cl, dl, el, al, bl, x[ 2 ] + 0x5a827999, 11 );
+        step< 3 >( cr, dr, er, ar, br, x[ 4 ] + 0x5c4dd124, 6 );
+        step< 1 >( bl, cl, dl, el, al, x[ 14 ] + 0x5a827999, 7 );
+        step< 3 >( br, cr, dr, er, ar, x[ 9 ] + 0x5c4dd124, 15 );
+        step< 1 >( al, bl, cl, dl, el, x[ 11 ] + 0x5a827999, 13 );
+        step< 3 >( ar, br, cr, dr, er, x[ 1 ] + 0x5c4dd124, 13 );
+        step< 1 >( el, al, bl, cl, dl, x[ 8 ] + 0x5a827999, 12 );
+        step< 3 >( er, ar, br, cr, dr, x[ 2 ] + 0x5c4dd124, 11 );
+
+        step< 2 >( dl, el, al, bl, cl, x[ 3 ] + 0x6ed9eba1, 11 );
+        step< 2 >( dr, er, ar, br, cr, x[ 15 ] + 0x6d703ef3, 9 );
+        step< 2 >( cl, dl, el, al, bl, x[ 10 ] + 0x6ed9eba1, 13 );
+        step< 2 >( cr, dr, er, ar, br, x[ 5 ] + 0x6d703ef3, 7 );
+        step< 2 >( bl, cl, dl, el, al, x[ 14 ] + 0x6ed9eba1, 6 );
+        step< 2 >( br, cr, dr, er, ar, x[ 1 ] + 0x6d703ef3, 15 );
+        step< 2 >( al, bl, cl, dl, el, x[ 4 ] + 0x6ed9eba1, 7 );
+        step< 2 >( ar, br, cr, dr, er, x[ 3 ] + 0x6d703ef3, 11 );
+        step< 2 >( el, al, bl, cl, dl, x[ 9 ] + 0x6ed9eba1, 14 );
+        step< 2 >( er, ar, br, cr, dr, x[ 7 ] + 0x6d703ef3, 8 );
+        step< 2 >( dl, el, al, bl, cl, x[ 15 ] + 0x6ed9eba1, 9 );
+        step< 2 >( dr, er, ar, br, cr, x[ 14 ] + 0x6d703ef3, 6 );
+        step< 2 >( cl, dl, el, al, bl, x[ 8 ] + 0x6ed9eba1, 13 );
+        step< 2 >( cr, dr, er, ar, br, x[ 6 ] + 0x6d703ef3, 6 );
+        step< 2 >( bl, cl, dl, el, al, x[ 1 ] + 0x6ed9eba1, 15 );
+        step< 2 >( br, cr, dr, er, ar, x[ 9 ] + 0x6d703ef3, 14 );
+        step< 2 >( al, bl, cl, dl, el, x[ 2 ] + 0x6ed9eba1, 14 );
+        step< 2 >( ar, br, cr, dr, er, x[ 11 ] + 0x6d703ef3, 12 );
+        step< 2 >( el, al, bl, cl, dl, x[ 7 ] + 0x6ed9eba1, 8 );
+        step< 2 >( er, ar, br, cr, dr, x[ 8 ] + 0x6d703ef3, 13 );
+        step< 2 >( dl, el, al, bl, cl, x[ 0 ] + 0x6ed9eba1, 13 );
+        step< 2 >( dr, er, ar, br, cr, x[ 12 ] + 0x6d703ef3, 5 );
+        step< 2 >( cl, dl, el, al, bl, x[ 6 ] + 0x6ed9eba1, 6 );
+        step< 2 >( cr, dr, er, ar, br, x[ 2 ] + 0x6d703ef3, 14 );
+        step< 2 >( bl, cl, dl, el, al, x[ 13 ] + 0x6ed9eba1, 5 );
+        step< 2 >( br, cr, dr, er, ar, x[ 10 ] + 0x6d703ef3, 13 );
+        step< 2 >( al, bl, cl, dl, el, x[ 11 ] + 0x6ed9eba1, 12 );
+        step< 2 >( ar, br, cr, dr, er, x[ 0 ] + 0x6d703ef3, 13 );
+        step< 2 >( el, al, bl, cl, dl, x[ 5 ] + 0x6ed9eba1, 7 );
+        step< 2 >( er, ar, br, cr, dr, x[ 4 ] + 0x6d703ef3, 7 );
+        step< 2 >( dl, el, al, bl, cl, x[ 12 ] + 0x6ed9eba1, 5 );
+        step< 2 >( dr, er, ar, br, cr, x[ 13 ] + 0x6d703ef3, 5 );
+
+        step< 3 >( cl, dl, el, al, bl, x[ 1 ] + 0x8f1bbcdc, 11 );
+        step< 1 >( cr, dr, er, ar, br, x[ 8 ] + 0x7a6d76e9, 15 );
+        step< 3 >( bl, cl, dl, el, al, x[ 9 ] + 0x8f1bbcdc, 12 );
+        step< 1 >( br, cr, dr, er, ar, x[ 6 ] + 0x7a6d76e9, 5 );
+        step< 3 >( al, bl, cl, dl, el, x[ 11 ] + 0x8f1bbcdc, 14 );
+        step< 1 >( ar, br, cr, dr, er, x[ 4 ] + 0x7a6d76e9, 8 );
+        step< 3 >( el, al, bl, cl, dl, x[ 10 ] + 0x8f1bbcdc, 15 );
+        step< 1 >( er, ar, br, cr, dr, x[ 1 ] + 0x7a6d76e9, 11 );
+        step< 3 >( dl, el, al, bl, cl, x[ 0 ] + 0x8f1bbcdc, 14 );
+        step< 1 >( dr, er, ar, br, cr, x[ 3 ] + 0x7a6d76e9, 14 );
+        step< 3 >( cl, dl, el, al, bl, x[ 8 ] + 0x8f1bbcdc, 15 );
+        step< 1 >( cr, dr, er, ar, br, x[ 11 ] + 0x7a6d76e9, 14 );
+        step< 3 >( bl, cl, dl, el, al, x[ 12 ] + 0x8f1bbcdc, 9 );
+        step< 1 >( br, cr, dr, er, ar, x[ 15 ] + 0x7a6d76e9, 6 );
+        step< 3 >( al, bl, cl, dl, el, x[ 4 ] + 0x8f1bbcdc, 8 );
+        step< 1 >( ar, br, cr, dr, er, x[ 0 ] + 0x7a6d76e9, 14 );
+        step< 3 >( el, al, bl, cl, dl, x[ 13 ] + 0x8f1bbcdc, 9 );
+        step< 1 >( er, ar, br, cr, dr, x[ 5 ] + 0x7a6d76e9, 6 );
+        step< 3 >( dl, el, al, bl, cl, x[ 3 ] + 0x8f1bbcdc, 14 );
+        step< 1 >( dr, er, ar, br, cr, x[ 12 ] + 0x7a6d76e9, 9 );
+        step< 3 >( cl, dl, el, al, bl, x[ 7 ] + 0x8f1bbcdc, 5 );
+        step< 1 >( cr, dr, er, ar, br, x[ 2 ] + 0x7a6d76e9, 12 );
+        step< 3 >( bl, cl, dl, el, al, x[ 15 ] + 0x8f1bbcdc, 6 );
+        step< 1 >( br, cr, dr, er, ar, x[ 13 ] + 0x7a6d76e9, 9 );
+        step< 3 >( al, bl, cl, dl, el, x[ 14 ] + 0x8f1bbcdc, 8 );
+        step< 1 >( ar, br, cr, dr, er, x[ 9 ] + 0x7a6d76e9, 12 );
+        step< 3 >( el, al, bl, cl, dl, x[ 5 ] + 0x8f1bbcdc, 6 );
+        step< 1 >( er, ar, br, cr, dr, x[ 7 ] + 0x7a6d76e9, 5 );
+        step< 3 >( dl, el, al, bl, cl, x[ 6 ] + 0x8f1bbcdc, 5 );
+        step< 1 >( dr, er, ar, br, cr, x[ 10 ] + 0x7a6d76e9, 15 );
+        step< 3 >( cl, dl, el, al, bl, x[ 2 ] + 0x8f1bbcdc, 12 );
+        step< 1 >( cr, dr, er, ar, br, x[ 14 ] + 0x7a6d76e9, 8 );
+
+        step< 4 >( bl, cl, dl, el, al, x[ 4 ] + 0xa953fd4e, 9 );
+        step< 0 >( br, cr, dr, er, ar, x[ 12 ], 8 );
+        step< 4 >( al, bl, cl, dl, el, x[ 0 ] + 0xa953fd4e, 15 );
+        step< 0 >( ar, br, cr, dr, er, x[ 15 ], 5 );
+        step< 4 >( el, al, bl, cl, dl, x[ 5 ] + 0xa953fd4e, 5 );
+        step< 0 >( er, ar, br, cr, dr, x[ 10 ], 12 );
+        step< 4 >( dl, el, al, bl, cl, x[ 9 ] + 0xa953fd4e, 11 );
+        step< 0 >( dr, er, ar, br, cr, x[ 4 ], 9 );
+        step< 4 >( cl, dl, el, al, bl, x[ 7 ] + 0xa953fd4e, 6 );
+        step< 0 >( cr, dr, er, ar, br, x[ 1 ], 12 );
+        step< 4 >( bl, cl, dl, el, al, x[ 12 ] + 0xa953fd4e, 8 );
+        step< 0 >( br, cr, dr, er, ar, x[ 5 ], 5 );
+        step< 4 >( al, bl, cl, dl, el, x[ 2 ] + 0xa953fd4e, 13 );
+        step< 0 >( ar, br, cr, dr, er, x[ 8 ], 14 );
+        step< 4 >( el, al, bl, cl, dl, x[ 10 ] + 0xa953fd4e, 12 );
+        step< 0 >( er, ar, br, cr, dr, x[ 7 ], 6 );
+        step< 4 >( dl, el, al, bl, cl, x[ 14 ] + 0xa953fd4e, 5 );
+        step< 0 >( dr, er, ar, br, cr, x[ 6 ], 8 );
+        step< 4 >( cl, dl, el, al, bl, x[ 1 ] + 0xa953fd4e, 12 );
+        step< 0 >( cr, dr, er, ar, br, x[ 2 ], 13 );
+        step< 4 >( bl, cl, dl, el, al, x[ 3 ] + 0xa953fd4e, 13 );
+        step< 0 >( br, cr, dr, er, ar, x[ 13 ], 6 );
+        step< 4 >( al, bl, cl, dl, el, x[ 8 ] + 0xa953fd4e, 14 );
+        step< 0 >( ar, br, cr, dr, er, x[ 14 ], 5 );
+        step< 4 >( el, al, bl, cl, dl, x[ 11 ] + 0xa953fd4e, 11 );
+        step< 0 >( er, ar, br, cr, dr, x[ 0 ], 15 );
+        step< 4 >( dl, el, al, bl, cl, x[ 6 ] + 0xa953fd4e, 8 );
+        step< 0 >( dr, er, ar, br, cr, x[ 3 ], 13 );
+        step< 4 >( cl, dl, el, al, bl, x[ 15 ] + 0xa953fd4e, 5 );
+        step< 0 >( cr, dr, er, ar, br, x[ 9 ], 11 );
+        step< 4 >( bl, cl, dl, el, al, x[ 13 ] + 0xa953fd4e, 6 );
+        step< 0 >( br, cr, dr, er, ar, x[ 11 ], 11 );
+        uint32_t t = state[ 1 ] + cl + dr;
+        state[ 1 ] = state[ 2 ] + dl + er;
+        state[ 2 ] = state[ 3 ] + el + ar;
+        state[ 3 ] = state[ 4 ] + al + br;
+        state[ 4 ] = state[ 0 ] + bl + cr;
+        state[ 0 ] = t;
+    }
+}
+
+void Ripemd160::init() {
+    mState[ 0 ] = 0x67452301;
+    mState[ 1 ] = 0xefcdab89;
+    mState[ 2 ] = 0x98badcfe;
+    mState[ 3 ] = 0x10325476;
+    mState[ 4 ] = 0xc3d2e1f0;
+    mOccupied = 0;
+    mLength = 0;
+}
+
+void Ripemd160::write( const byte* inbuf, int inlen ) {
+    std::size_t length = static_cast< std::size_t >( inlen );
+    mLength += length;
+    if ( mOccupied > 0 ) {
+        std::size_t copied = qMin( length, sizeof( mBlock ) - mOccupied );
+        std::memcpy( mBlock + mOccupied, inbuf, copied );
+        mOccupied += copied;
+        inbuf += copied;
+        length -= copied;
+        if ( mOccupied < sizeof( mBlock ) ) {
+            return;
+        }
+        ripemd160::compress( mState, mBlock, 1 );
+        mOccupied = 0;
+    }
+    std::size_t count = length / sizeof( mBlock );
+    if ( count > 0 ) {
+        ripemd160::compress( mState, inbuf, count );
+        inbuf += count * sizeof( mBlock );
+        length -= count * sizeof( mBlock );
+    }
+    std::memcpy( mBlock, inbuf, length );
+    mOccupied = length;
+}
+
+byte* Ripemd160::final() {
+    quint64 bitCount = mLength * 8;
+    mBlock[ mOccupied++ ] = 0x80;
+    if ( mOccupied > sizeof( mBlock ) - 8 ) {
+        std::memset( mBlock + mOccupied, 0, sizeof( mBlock ) - mOccupied );
+        ripemd160::compress( mState, mBlock, 1 );
+        mOccupied = 0;
+    }
+    std::memset( mBlock + mOccupied, 0, sizeof( mBlock ) - 8 - mOccupied );
+    qToLittleEndian( bitCount, mBlock + sizeof( mBlock ) - 8 );
+    ripemd160::compress( mState, mBlock, 1 );
+    for ( int i = 0; i < 5; ++i ) {
+        qToLittleEndian( static_cast< quint32 >( mState[ i ] ), mDigest + 4 * i );
+    }
+    init();
+    return mDigest;
+}
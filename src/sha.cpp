@@ -0,0 +1,800 @@
+#include "sha.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cpufeatures.hpp"
+
+#ifdef MRHASH_X86_64
+#include <immintrin.h>
+#endif
+
+namespace {
+    const uint32_t SHA1_IV[ 5 ] = { 0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0 };
+
+    const uint32_t SHA224_IV[ 8 ] = {
+        0xc1059ed8, 0x367cd507, 0x3070dd17, 0xf70e5939, 0xffc00b31, 0x68581511, 0x64f98fa7, 0xbefa4fa4
+    };
+
+    const uint32_t SHA256_IV[ 8 ] = {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    };
+
+    const uint32_t SHA1_K[ 4 ] = { 0x5a827999, 0x6ed9eba1, 0x8f1bbcdc, 0xca62c1d6 };
+
+    const uint32_t SHA256_K[ 64 ] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+
+    const uint64_t SHA384_IV[ 8 ] = {
+        0xcbbb9d5dc1059ed8ULL, 0x629a292a367cd507ULL, 0x9159015a3070dd17ULL, 0x152fecd8f70e5939ULL,
+        0x67332667ffc00b31ULL, 0x8eb44a8768581511ULL, 0xdb0c2e0d64f98fa7ULL, 0x47b5481dbefa4fa4ULL
+    };
+
+    const uint64_t SHA512_IV[ 8 ] = {
+        0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+        0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+    };
+
+    const uint64_t SHA512_K[ 80 ] = {
+        0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+        0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+        0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+        0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+        0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+        0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+        0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+        0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+        0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+        0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+        0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+        0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+        0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+        0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+        0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+        0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+        0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+        0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+        0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+        0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+    };
+
+    inline uint32_t rotl( uint32_t x, int n ) { return ( x << n ) | ( x >> ( 32 - n ) ); }
+    inline uint32_t rotr( uint32_t x, int n ) { return ( x >> n ) | ( x << ( 32 - n ) ); }
+    inline uint64_t rotr( uint64_t x, int n ) { return ( x >> n ) | ( x << ( 64 - n ) ); }
+
+    inline uint32_t load32( const byte* data ) {
+        quint32 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromBigEndian( value );
+    }
+
+    inline uint64_t load64( const byte* data ) {
+        quint64 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromBigEndian( value );
+    }
+
+    inline void store( uint32_t value, byte* data ) { qToBigEndian( static_cast< quint32 >( value ), data ); }
+    inline void store( uint64_t value, byte* data ) { qToBigEndian( static_cast< quint64 >( value ), data ); }
+
+    /* Rounds on a message schedule already added to the round constants; they are shared by the
+     * portable and the AVX2 kernels, where the compiler can use the BMI2 rotations.
+     * The rounds are unrolled rotating the roles of the variables instead of moving their values. */
+    inline uint32_t choose( uint32_t x, uint32_t y, uint32_t z ) { return z ^ ( x & ( y ^ z ) ); }
+    inline uint32_t parity( uint32_t x, uint32_t y, uint32_t z ) { return x ^ y ^ z; }
+    inline uint32_t majority( uint32_t x, uint32_t y, uint32_t z ) { return ( x & y ) | ( z & ( x | y ) ); }
+
+    template< uint32_t ( *F )( uint32_t, uint32_t, uint32_t ) >
+    inline void rounds1Of20( uint32_t& a, uint32_t& b, uint32_t& c, uint32_t& d, uint32_t& e, const uint32_t* wk ) {
+        for ( int t = 0; t < 20; t += 5 ) {
+            e += rotl( a, 5 ) + F( b, c, d ) + wk[ t ];
+            b = rotl( b, 30 );
+            d += rotl( e, 5 ) + F( a, b, c ) + wk[ t + 1 ];
+            a = rotl( a, 30 );
+            c += rotl( d, 5 ) + F( e, a, b ) + wk[ t + 2 ];
+            e = rotl( e, 30 );
+            b += rotl( c, 5 ) + F( d, e, a ) + wk[ t + 3 ];
+            d = rotl( d, 30 );
+            a += rotl( b, 5 ) + F( c, d, e ) + wk[ t + 4 ];
+            c = rotl( c, 30 );
+        }
+    }
+
+    inline void rounds1( uint32_t state[ 5 ], const uint32_t wk[ 80 ] ) {
+        uint32_t a = state[ 0 ], b = state[ 1 ], c = state[ 2 ], d = state[ 3 ], e = state[ 4 ];
+        rounds1Of20< choose >( a, b, c, d, e, wk );
+        rounds1Of20< parity >( a, b, c, d, e, wk + 20 );
+        rounds1Of20< majority >( a, b, c, d, e, wk + 40 );
+        rounds1Of20< parity >( a, b, c, d, e, wk + 60 );
+        state[ 0 ] += a;
+        state[ 1 ] += b;
+        state[ 2 ] += c;
+        state[ 3 ] += d;
+        state[ 4 ] += e;
+    }
+
+    // The SHA-2 functions differ only in the word size, the number of rounds and the rotation counts
+    template< typename Word >
+    struct Sha2;
+
+    template<>
+    struct Sha2< uint32_t > {
+        enum { ROUNDS = 64, S0A = 2, S0B = 13, S0C = 22, S1A = 6, S1B = 11, S1C = 25 };
+        static const uint32_t* k() { return SHA256_K; }
+        static uint32_t load( const byte* data ) { return load32( data ); }
+        static uint32_t bigSigma0( uint32_t x ) { return rotr( x, S0A ) ^ rotr( x, S0B ) ^ rotr( x, S0C ); }
+        static uint32_t bigSigma1( uint32_t x ) { return rotr( x, S1A ) ^ rotr( x, S1B ) ^ rotr( x, S1C ); }
+        static uint32_t sigma0( uint32_t x ) { return rotr( x, 7 ) ^ rotr( x, 18 ) ^ ( x >> 3 ); }
+        static uint32_t sigma1( uint32_t x ) { return rotr( x, 17 ) ^ rotr( x, 19 ) ^ ( x >> 10 ); }
+    };
+
+    template<>
+    struct Sha2< uint64_t > {
+        enum { ROUNDS = 80, S0A = 28, S0B = 34, S0C = 39, S1A = 14, S1B = 18, S1C = 41 };
+        static const uint64_t* k() { return SHA512_K; }
+        static uint64_t load( const byte* data ) { return load64( data ); }
+        static uint64_t bigSigma0( uint64_t x ) { return rotr( x, S0A ) ^ rotr( x, S0B ) ^ rotr( x, S0C ); }
+        static uint64_t bigSigma1( uint64_t x ) { return rotr( x, S1A ) ^ rotr( x, S1B ) ^ rotr( x, S1C ); }
+        static uint64_t sigma0( uint64_t x ) { return rotr( x, 1 ) ^ rotr( x, 8 ) ^ ( x >> 7 ); }
+        static uint64_t sigma1( uint64_t x ) { return rotr( x, 19 ) ^ rotr( x, 61 ) ^ ( x >> 6 ); }
+    };
+
+    template< typename Word >
+    inline void round2( Word a, Word b, Word c, Word& d, Word e, Word f, Word g, Word& h, Word wk ) {
+        Word t1 = h + Sha2< Word >::bigSigma1( e ) + ( g ^ ( e & ( f ^ g ) ) ) + wk;
+        Word t2 = Sha2< Word >::bigSigma0( a ) + ( ( a & b ) | ( c & ( a | b ) ) );
+        d += t1;
+        h = t1 + t2;
+    }
+
+    template< typename Word >
+    inline void rounds2( Word state[ 8 ], const Word* wk ) {
+        Word a = state[ 0 ], b = state[ 1 ], c = state[ 2 ], d = state[ 3 ];
+        Word e = state[ 4 ], f = state[ 5 ], g = state[ 6 ], h = state[ 7 ];
+        for ( int t = 0; t < Sha2< Word >::ROUNDS; t += 8 ) {
+            round2( a, b, c, d, e, f, g, h, wk[ t ] );
+            round2( h, a, b, c, d, e, f, g, wk[ t + 1 ] );
+            round2( g, h, a, b, c, d, e, f, wk[ t + 2 ] );
+            round2( f, g, h, a, b, c, d, e, wk[ t + 3 ] );
+            round2( e, f, g, h, a, b, c, d, wk[ t + 4 ] );
+            round2( d, e, f, g, h, a, b, c, wk[ t + 5 ] );
+            round2( c, d, e, f, g, h, a, b, wk[ t + 6 ] );
+            round2( b, c, d, e, f, g, h, a, wk[ t + 7 ] );
+        }
+        state[ 0 ] += a;
+        state[ 1 ] += b;
+        state[ 2 ] += c;
+        state[ 3 ] += d;
+        state[ 4 ] += e;
+        state[ 5 ] += f;
+        state[ 6 ] += g;
+        state[ 7 ] += h;
+    }
+
+    // The rounds of Lanes states over the same schedule: two independent dependency chains fill the pipeline better
+    template< typename Word, std::size_t Lanes >
+    inline void roundsLanes( Word* states, const Word* wk ) {
+        if ( Lanes == 1 ) {
+            return rounds2( states, wk );
+        }
+        Word a0 = states[ 0 ], b0 = states[ 1 ], c0 = states[ 2 ], d0 = states[ 3 ];
+        Word e0 = states[ 4 ], f0 = states[ 5 ], g0 = states[ 6 ], h0 = states[ 7 ];
+        Word a1 = states[ 8 ], b1 = states[ 9 ], c1 = states[ 10 ], d1 = states[ 11 ];
+        Word e1 = states[ 12 ], f1 = states[ 13 ], g1 = states[ 14 ], h1 = states[ 15 ];
+        for ( int t = 0; t < Sha2< Word >::ROUNDS; t += 8 ) {
+            round2( a0, b0, c0, d0, e0, f0, g0, h0, wk[ t ] );
+            round2( a1, b1, c1, d1, e1, f1, g1, h1, wk[ t ] );
+            round2( h0, a0, b0, c0, d0, e0, f0, g0, wk[ t + 1 ] );
+            round2( h1, a1, b1, c1, d1, e1, f1, g1, wk[ t + 1 ] );
+            round2( g0, h0, a0, b0, c0, d0, e0, f0, wk[ t + 2 ] );
+            round2( g1, h1, a1, b1, c1, d1, e1, f1, wk[ t + 2 ] );
+            round2( f0, g0, h0, a0, b0, c0, d0, e0, wk[ t + 3 ] );
+            round2( f1, g1, h1, a1, b1, c1, d1, e1, wk[ t + 3 ] );
+            round2( e0, f0, g0, h0, a0, b0, c0, d0, wk[ t + 4 ] );
+            round2( e1, f1, g1, h1, a1, b1, c1, d1, wk[ t + 4 ] );
+            round2( d0, e0, f0, g0, h0, a0, b0, c0, wk[ t + 5 ] );
+            round2( d1, e1, f1, g1, h1, a1, b1, c1, wk[ t + 5 ] );
+            round2( c0, d0, e0, f0, g0, h0, a0, b0, wk[ t + 6 ] );
+            round2( c1, d1, e1, f1, g1, h1, a1, b1, wk[ t + 6 ] );
+            round2( b0, c0, d0, e0, f0, g0, h0, a0, wk[ t + 7 ] );
+            round2( b1, c1, d1, e1, f1, g1, h1, a1, wk[ t + 7 ] );
+        }
+        states[ 0 ] += a0;
+        states[ 1 ] += b0;
+        states[ 2 ] += c0;
+        states[ 3 ] += d0;
+        states[ 4 ] += e0;
+        states[ 5 ] += f0;
+        states[ 6 ] += g0;
+        states[ 7 ] += h0;
+        states[ 8 ] += a1;
+        states[ 9 ] += b1;
+        states[ 10 ] += c1;
+        states[ 11 ] += d1;
+        states[ 12 ] += e1;
+        states[ 13 ] += f1;
+        states[ 14 ] += g1;
+        states[ 15 ] += h1;
+    }
+
+    void compress1Portable( uint32_t state[ 5 ], const byte* blocks, std::size_t count ) {
+        uint32_t wk[ 80 ];
+        for ( ; count > 0; --count, blocks += 64 ) {
+            uint32_t w[ 16 ]; // sliding window over the message schedule
+            for ( int t = 0; t < 16; ++t ) {
+                w[ t ] = load32( blocks + 4 * t );
+                wk[ t ] = w[ t ] + SHA1_K[ 0 ];
+            }
+            for ( int t = 16; t < 80; ++t ) {
+                w[ t & 15 ] = rotl( w[ ( t - 3 ) & 15 ] ^ w[ ( t - 8 ) & 15 ] ^ w[ ( t - 14 ) & 15 ] ^ w[ t & 15 ], 1 );
+                wk[ t ] = w[ t & 15 ] + SHA1_K[ t / 20 ];
+            }
+            rounds1( state, wk );
+        }
+    }
+
+    template< typename Word >
+    inline void schedule2( const byte* block, Word* wk ) {
+        typedef Sha2< Word > Sha;
+        const Word* k = Sha::k();
+        Word w[ 16 ]; // sliding window over the message schedule
+        for ( int t = 0; t < 16; ++t ) {
+            w[ t ] = Sha::load( block + sizeof( Word ) * t );
+            wk[ t ] = w[ t ] + k[ t ];
+        }
+        for ( int t = 16; t < Sha::ROUNDS; ++t ) {
+            w[ t & 15 ] += Sha::sigma0( w[ ( t - 15 ) & 15 ] ) + w[ ( t - 7 ) & 15 ] + Sha::sigma1( w[ ( t - 2 ) & 15 ] );
+            wk[ t ] = w[ t & 15 ] + k[ t ];
+        }
+    }
+
+    template< typename Word, std::size_t Lanes >
+    void compress2Portable( Word* states, const byte* blocks, std::size_t count ) {
+        Word wk[ Sha2< Word >::ROUNDS ];
+        for ( ; count > 0; --count, blocks += 16 * sizeof( Word ) ) {
+            schedule2( blocks, wk );
+            roundsLanes< Word, Lanes >( states, wk );
+        }
+    }
+
+#ifdef MRHASH_X86_64
+    /* AVX2 kernels: each 128 bit lane holds four schedule words of one of two consecutive blocks,
+     * so the per-lane alignr/shuffle/shift instructions work on both blocks at once. */
+    MRHASH_TARGET( "avx2,bmi2" )
+    inline __m256i loadBlocks( const byte* first, const byte* second, int offset ) {
+        const __m256i bswap = _mm256_setr_epi8( 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                                3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12 );
+        __m128i low = _mm_loadu_si128( reinterpret_cast< const __m128i* >( first + offset ) );
+        __m128i high = _mm_loadu_si128( reinterpret_cast< const __m128i* >( second + offset ) );
+        return _mm256_shuffle_epi8( _mm256_inserti128_si256( _mm256_castsi128_si256( low ), high, 1 ), bswap );
+    }
+
+    MRHASH_TARGET( "avx2,bmi2" )
+    inline void storeLanes( uint32_t* first, uint32_t* second, __m256i value ) {
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( first ), _mm256_castsi256_si128( value ) );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( second ), _mm256_extracti128_si256( value, 1 ) );
+    }
+
+    MRHASH_TARGET( "avx2,bmi2" )
+    inline __m256i rotl256( __m256i x, int n ) {
+        return _mm256_or_si256( _mm256_slli_epi32( x, n ), _mm256_srli_epi32( x, 32 - n ) );
+    }
+
+    MRHASH_TARGET( "avx2,bmi2" )
+    inline __m256i rotr256( __m256i x, int n ) {
+        return _mm256_or_si256( _mm256_srli_epi32( x, n ), _mm256_slli_epi32( x, 32 - n ) );
+    }
+
+    MRHASH_TARGET( "avx2,bmi2" )
+    void compress1Avx2( uint32_t state[ 5 ], const byte* blocks, std::size_t count ) {
+        uint32_t wk[ 2 ][ 80 ];
+        while ( count > 0 ) {
+            // an odd last block is scheduled twice, the second copy is ignored
+            const byte* second = count > 1 ? blocks + 64 : blocks;
+            __m256i w[ 20 ];
+            for ( int i = 0; i < 4; ++i ) {
+                w[ i ] = loadBlocks( blocks, second, 16 * i );
+            }
+            for ( int i = 4; i < 20; ++i ) {
+                // w[t + 3] needs w[t] of the same group: it is computed as 0 and then fixed
+                __m256i x = _mm256_xor_si256( _mm256_srli_si256( w[ i - 1 ], 4 ), w[ i - 2 ] );
+                x = _mm256_xor_si256( x, _mm256_alignr_epi8( w[ i - 3 ], w[ i - 4 ], 8 ) );
+                x = _mm256_xor_si256( x, w[ i - 4 ] );
+                __m256i fix = _mm256_slli_si256( x, 12 );
+                w[ i ] = _mm256_xor_si256( rotl256( x, 1 ), rotl256( fix, 2 ) );
+            }
+            for ( int i = 0; i < 20; ++i ) {
+                __m256i k = _mm256_set1_epi32( static_cast< int >( SHA1_K[ i / 5 ] ) );
+                storeLanes( wk[ 0 ] + 4 * i, wk[ 1 ] + 4 * i, _mm256_add_epi32( w[ i ], k ) );
+            }
+            rounds1( state, wk[ 0 ] );
+            if ( count > 1 ) {
+                rounds1( state, wk[ 1 ] );
+                blocks += 128;
+                count -= 2;
+            } else {
+                blocks += 64;
+                count -= 1;
+            }
+        }
+    }
+
+    MRHASH_TARGET( "avx2,bmi2" )
+    inline __m256i sigma0( __m256i x ) {
+        return _mm256_xor_si256( _mm256_xor_si256( rotr256( x, 7 ), rotr256( x, 18 ) ), _mm256_srli_epi32( x, 3 ) );
+    }
+
+    MRHASH_TARGET( "avx2,bmi2" )
+    inline __m256i sigma1( __m256i x ) {
+        return _mm256_xor_si256( _mm256_xor_si256( rotr256( x, 17 ), rotr256( x, 19 ) ), _mm256_srli_epi32( x, 10 ) );
+    }
+
+    template< std::size_t Lanes >
+    MRHASH_TARGET( "avx2,bmi2" )
+    void compress256Avx2( uint32_t* states, const byte* blocks, std::size_t count ) {
+        uint32_t wk[ 2 ][ 64 ];
+        const __m256i zero = _mm256_setzero_si256();
+        while ( count > 0 ) {
+            const byte* second = count > 1 ? blocks + 64 : blocks;
+            __m256i w[ 16 ];
+            for ( int i = 0; i < 4; ++i ) {
+                w[ i ] = loadBlocks( blocks, second, 16 * i );
+            }
+            for ( int i = 4; i < 16; ++i ) {
+                __m256i x = _mm256_add_epi32( w[ i - 4 ], sigma0( _mm256_alignr_epi8( w[ i - 3 ], w[ i - 4 ], 4 ) ) );
+                x = _mm256_add_epi32( x, _mm256_alignr_epi8( w[ i - 1 ], w[ i - 2 ], 4 ) );
+                // the first two words depend on the previous group, the last two on the first two
+                __m256i s1 = sigma1( _mm256_shuffle_epi32( w[ i - 1 ], 0xfe ) );
+                x = _mm256_add_epi32( x, _mm256_blend_epi32( s1, zero, 0xcc ) );
+                s1 = sigma1( _mm256_shuffle_epi32( x, 0x40 ) );
+                w[ i ] = _mm256_add_epi32( x, _mm256_blend_epi32( s1, zero, 0x33 ) );
+            }
+            for ( int i = 0; i < 16; ++i ) {
+                __m256i k = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast< const __m128i* >( SHA256_K + 4 * i ) ) );
+                storeLanes( wk[ 0 ] + 4 * i, wk[ 1 ] + 4 * i, _mm256_add_epi32( w[ i ], k ) );
+            }
+            roundsLanes< uint32_t, Lanes >( states, wk[ 0 ] );
+            if ( count > 1 ) {
+                roundsLanes< uint32_t, Lanes >( states, wk[ 1 ] );
+                blocks += 128;
+                count -= 2;
+            } else {
+                blocks += 64;
+                count -= 1;
+            }
+        }
+    }
+
+    /* SHA extensions kernels, following the structure of Intel's reference code: the 4-round groups
+     * are templates so that the instruction immediates are constants and the loops can be unrolled. */
+    MRHASH_TARGET( "sse4.1,sha" )
+    inline __m128i loadSwapped( const byte* data, __m128i mask ) {
+        return _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i* >( data ) ), mask );
+    }
+
+    template< int G >
+    MRHASH_TARGET( "sse4.1,sha" )
+    inline void sha1Group( __m128i& abcd, __m128i& e0, __m128i& e1, __m128i msg[ 4 ] ) {
+        __m128i& e = ( G % 2 == 0 ) ? e0 : e1;
+        __m128i& next = ( G % 2 == 0 ) ? e1 : e0;
+        if ( G == 0 ) {
+            e = _mm_add_epi32( e, msg[ 0 ] );
+        } else {
+            e = _mm_sha1nexte_epu32( e, msg[ G % 4 ] );
+        }
+        next = abcd;
+        if ( G >= 3 && G <= 18 ) {
+            msg[ ( G + 1 ) % 4 ] = _mm_sha1msg2_epu32( msg[ ( G + 1 ) % 4 ], msg[ G % 4 ] );
+        }
+        abcd = _mm_sha1rnds4_epu32( abcd, e, G / 5 );
+        if ( G >= 1 && G <= 16 ) {
+            msg[ ( G + 3 ) % 4 ] = _mm_sha1msg1_epu32( msg[ ( G + 3 ) % 4 ], msg[ G % 4 ] );
+        }
+        if ( G >= 2 && G <= 17 ) {
+            msg[ ( G + 2 ) % 4 ] = _mm_xor_si128( msg[ ( G + 2 ) % 4 ], msg[ G % 4 ] );
+        }
+    }
+
+    MRHASH_TARGET( "sse4.1,sha" )
+    void compress1Extensions( uint32_t state[ 5 ], const byte* blocks, std::size_t count ) {
+        const __m128i mask = _mm_set_epi64x( 0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL );
+        __m128i abcd = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast< const __m128i* >( state ) ), 0x1b );
+        __m128i e0 = _mm_set_epi32( static_cast< int >( state[ 4 ] ), 0, 0, 0 );
+        for ( ; count > 0; --count, blocks += 64 ) {
+            const __m128i abcdSave = abcd;
+            const __m128i eSave = e0;
+            __m128i e1;
+            __m128i msg[ 4 ];
+            for ( int i = 0; i < 4; ++i ) {
+                msg[ i ] = loadSwapped( blocks + 16 * i, mask );
+            }
+            sha1Group< 0 >( abcd, e0, e1, msg );
+            sha1Group< 1 >( abcd, e0, e1, msg );
+            sha1Group< 2 >( abcd, e0, e1, msg );
+            sha1Group< 3 >( abcd, e0, e1, msg );
+            sha1Group< 4 >( abcd, e0, e1, msg );
+            sha1Group< 5 >( abcd, e0, e1, msg );
+            sha1Group< 6 >( abcd, e0, e1, msg );
+            sha1Group< 7 >( abcd, e0, e1, msg );
+            sha1Group< 8 >( abcd, e0, e1, msg );
+            sha1Group< 9 >( abcd, e0, e1, msg );
+            sha1Group< 10 >( abcd, e0, e1, msg );
+            sha1Group< 11 >( abcd, e0, e1, msg );
+            sha1Group< 12 >( abcd, e0, e1, msg );
+            sha1Group< 13 >( abcd, e0, e1, msg );
+            sha1Group< 14 >( abcd, e0, e1, msg );
+            sha1Group< 15 >( abcd, e0, e1, msg );
+            sha1Group< 16 >( abcd, e0, e1, msg );
+            sha1Group< 17 >( abcd, e0, e1, msg );
+            sha1Group< 18 >( abcd, e0, e1, msg );
+            sha1Group< 19 >( abcd, e0, e1, msg );
+            e0 = _mm_sha1nexte_epu32( e0, eSave ); // after group 19 the E of the next block is in e0
+            abcd = _mm_add_epi32( abcd, abcdSave );
+        }
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( state ), _mm_shuffle_epi32( abcd, 0x1b ) );
+        state[ 4 ] = static_cast< uint32_t >( _mm_extract_epi32( e0, 3 ) );
+    }
+
+    template< int G >
+    MRHASH_TARGET( "sse4.1,sha" )
+    inline void sha256Group( __m128i& state0, __m128i& state1, __m128i msg[ 4 ] ) {
+        __m128i k = _mm_loadu_si128( reinterpret_cast< const __m128i* >( SHA256_K + 4 * G ) );
+        __m128i wk = _mm_add_epi32( msg[ G % 4 ], k );
+        state1 = _mm_sha256rnds2_epu32( state1, state0, wk );
+        if ( G >= 3 && G <= 14 ) {
+            __m128i next = _mm_add_epi32( msg[ ( G + 1 ) % 4 ], _mm_alignr_epi8( msg[ G % 4 ], msg[ ( G + 3 ) % 4 ], 4 ) );
+            msg[ ( G + 1 ) % 4 ] = _mm_sha256msg2_epu32( next, msg[ G % 4 ] );
+        }
+        state0 = _mm_sha256rnds2_epu32( state0, state1, _mm_shuffle_epi32( wk, 0x0e ) );
+        if ( G >= 1 && G <= 12 ) {
+            msg[ ( G + 3 ) % 4 ] = _mm_sha256msg1_epu32( msg[ ( G + 3 ) % 4 ], msg[ G % 4 ] );
+        }
+    }
+
+    MRHASH_TARGET( "sse4.1,sha" )
+    void compress256Extensions( uint32_t state[ 8 ], const byte* blocks, std::size_t count ) {
+        const __m128i mask = _mm_set_epi64x( 0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL );
+        __m128i cdab = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast< const __m128i* >( state ) ), 0xb1 );
+        __m128i efgh = _mm_shuffle_epi32( _mm_loadu_si128( reinterpret_cast< const __m128i* >( state + 4 ) ), 0x1b );
+        __m128i state0 = _mm_alignr_epi8( cdab, efgh, 8 ); // ABEF
+        __m128i state1 = _mm_blend_epi16( efgh, cdab, 0xf0 ); // CDGH
+        for ( ; count > 0; --count, blocks += 64 ) {
+            const __m128i save0 = state0;
+            const __m128i save1 = state1;
+            __m128i msg[ 4 ];
+            for ( int i = 0; i < 4; ++i ) {
+                msg[ i ] = loadSwapped( blocks + 16 * i, mask );
+            }
+            sha256Group< 0 >( state0, state1, msg );
+            sha256Group< 1 >( state0, state1, msg );
+            sha256Group< 2 >( state0, state1, msg );
+            sha256Group< 3 >( state0, state1, msg );
+            sha256Group< 4 >( state0, state1, msg );
+            sha256Group< 5 >( state0, state1, msg );
+            sha256Group< 6 >( state0, state1, msg );
+            sha256Group< 7 >( state0, state1, msg );
+            sha256Group< 8 >( state0, state1, msg );
+            sha256Group< 9 >( state0, state1, msg );
+            sha256Group< 10 >( state0, state1, msg );
+            sha256Group< 11 >( state0, state1, msg );
+            sha256Group< 12 >( state0, state1, msg );
+            sha256Group< 13 >( state0, state1, msg );
+            sha256Group< 14 >( state0, state1, msg );
+            sha256Group< 15 >( state0, state1, msg );
+            state0 = _mm_add_epi32( state0, save0 );
+            state1 = _mm_add_epi32( state1, save1 );
+        }
+        __m128i feba = _mm_shuffle_epi32( state0, 0x1b );
+        __m128i dchg = _mm_shuffle_epi32( state1, 0xb1 );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( state ), _mm_blend_epi16( feba, dchg, 0xf0 ) ); // DCBA
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( state + 4 ), _mm_alignr_epi8( dchg, feba, 8 ) ); // HGFE
+    }
+
+#ifdef MRHASH_AVX512
+    /* Two-lane SHA-2 kernels: each vector element holds a variable of one of the two states, so both lanes run
+     * on the same instructions; the message schedule, shared by the lanes, is computed in scalar code.
+     * They pay off only with the AVX-512 rotations and ternary logic: with shifts the scalar rounds are as fast. */
+    struct Avx512Lanes32 {
+        typedef uint32_t Word;
+        template< int N >
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i rotr( __m128i x ) { return _mm_ror_epi32( x, N ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i add( __m128i x, __m128i y ) { return _mm_add_epi32( x, y ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i broadcast( Word x ) { return _mm_set1_epi32( static_cast< int >( x ) ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i load( const Word* states ) {
+            return _mm_set_epi32( 0, 0, static_cast< int >( states[ 8 ] ), static_cast< int >( states[ 0 ] ) );
+        }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static void store( __m128i x, Word* states ) {
+            states[ 0 ] = static_cast< Word >( _mm_cvtsi128_si32( x ) );
+            states[ 8 ] = static_cast< Word >( _mm_extract_epi32( x, 1 ) );
+        }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i xor3( __m128i x, __m128i y, __m128i z ) { return _mm_ternarylogic_epi32( x, y, z, 0x96 ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i choose( __m128i x, __m128i y, __m128i z ) { return _mm_ternarylogic_epi32( x, y, z, 0xca ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i majority( __m128i x, __m128i y, __m128i z ) { return _mm_ternarylogic_epi32( x, y, z, 0xe8 ); }
+    };
+
+    struct Avx512Lanes64 {
+        typedef uint64_t Word;
+        template< int N >
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i rotr( __m128i x ) { return _mm_ror_epi64( x, N ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i add( __m128i x, __m128i y ) { return _mm_add_epi64( x, y ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i broadcast( Word x ) { return _mm_set1_epi64x( static_cast< long long >( x ) ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i load( const Word* states ) {
+            return _mm_set_epi64x( static_cast< long long >( states[ 8 ] ), static_cast< long long >( states[ 0 ] ) );
+        }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static void store( __m128i x, Word* states ) {
+            states[ 0 ] = static_cast< Word >( _mm_cvtsi128_si64( x ) );
+            states[ 8 ] = static_cast< Word >( _mm_extract_epi64( x, 1 ) );
+        }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i xor3( __m128i x, __m128i y, __m128i z ) { return _mm_ternarylogic_epi64( x, y, z, 0x96 ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i choose( __m128i x, __m128i y, __m128i z ) { return _mm_ternarylogic_epi64( x, y, z, 0xca ); }
+        MRHASH_TARGET( "avx512f,avx512vl" ) static __m128i majority( __m128i x, __m128i y, __m128i z ) { return _mm_ternarylogic_epi64( x, y, z, 0xe8 ); }
+    };
+
+    template< typename Lanes >
+    MRHASH_TARGET( "avx512f,avx512vl" )
+    inline void roundAvx512( __m128i a, __m128i b, __m128i c, __m128i& d, __m128i e, __m128i f, __m128i g, __m128i& h, typename Lanes::Word wk ) {
+        typedef Sha2< typename Lanes::Word > Sha;
+        __m128i s1 = Lanes::xor3( Lanes::template rotr< Sha::S1A >( e ), Lanes::template rotr< Sha::S1B >( e ), Lanes::template rotr< Sha::S1C >( e ) );
+        __m128i t1 = Lanes::add( Lanes::add( h, Lanes::broadcast( wk ) ), Lanes::add( s1, Lanes::choose( e, f, g ) ) );
+        __m128i s0 = Lanes::xor3( Lanes::template rotr< Sha::S0A >( a ), Lanes::template rotr< Sha::S0B >( a ), Lanes::template rotr< Sha::S0C >( a ) );
+        d = Lanes::add( d, t1 );
+        h = Lanes::add( t1, Lanes::add( s0, Lanes::majority( a, b, c ) ) );
+    }
+
+    template< typename Lanes >
+    MRHASH_TARGET( "avx512f,avx512vl" )
+    void compress2Avx512( typename Lanes::Word* states, const byte* blocks, std::size_t count ) {
+        typedef typename Lanes::Word Word;
+        Word wk[ Sha2< Word >::ROUNDS ];
+        __m128i v[ 8 ];
+        for ( int i = 0; i < 8; ++i ) {
+            v[ i ] = Lanes::load( states + i );
+        }
+        for ( ; count > 0; --count, blocks += 16 * sizeof( Word ) ) {
+            schedule2( blocks, wk );
+            __m128i a = v[ 0 ], b = v[ 1 ], c = v[ 2 ], d = v[ 3 ], e = v[ 4 ], f = v[ 5 ], g = v[ 6 ], h = v[ 7 ];
+            for ( int t = 0; t < Sha2< Word >::ROUNDS; t += 8 ) {
+                roundAvx512< Lanes >( a, b, c, d, e, f, g, h, wk[ t ] );
+                roundAvx512< Lanes >( h, a, b, c, d, e, f, g, wk[ t + 1 ] );
+                roundAvx512< Lanes >( g, h, a, b, c, d, e, f, wk[ t + 2 ] );
+                roundAvx512< Lanes >( f, g, h, a, b, c, d, e, wk[ t + 3 ] );
+                roundAvx512< Lanes >( e, f, g, h, a, b, c, d, wk[ t + 4 ] );
+                roundAvx512< Lanes >( d, e, f, g, h, a, b, c, wk[ t + 5 ] );
+                roundAvx512< Lanes >( c, d, e, f, g, h, a, b, wk[ t + 6 ] );
+                roundAvx512< Lanes >( b, c, d, e, f, g, h, a, wk[ t + 7 ] );
+            }
+            v[ 0 ] = Lanes::add( v[ 0 ], a );
+            v[ 1 ] = Lanes::add( v[ 1 ], b );
+            v[ 2 ] = Lanes::add( v[ 2 ], c );
+            v[ 3 ] = Lanes::add( v[ 3 ], d );
+            v[ 4 ] = Lanes::add( v[ 4 ], e );
+            v[ 5 ] = Lanes::add( v[ 5 ], f );
+            v[ 6 ] = Lanes::add( v[ 6 ], g );
+            v[ 7 ] = Lanes::add( v[ 7 ], h );
+        }
+        for ( int i = 0; i < 8; ++i ) {
+            Lanes::store( v[ i ], states + i );
+        }
+    }
+#endif
+
+    /* With the SHA extensions the rounds cost less than loading and scheduling the message again,
+     * so the lanes are compressed one after the other over slices small enough to stay in L1 */
+    void compress256x2Extensions( uint32_t* states, const byte* blocks, std::size_t count ) {
+        const std::size_t SLICE_BLOCKS = 64;
+        while ( count > 0 ) {
+            std::size_t slice = qMin( count, SLICE_BLOCKS );
+            compress256Extensions( states, blocks, slice );
+            compress256Extensions( states + 8, blocks, slice );
+            blocks += 64 * slice;
+            count -= slice;
+        }
+    }
+#endif
+
+    sha::Kernel selectKernel() {
+        sha::Kernel kernel = sha::Portable;
+#ifdef MRHASH_X86_64
+        const cpu::Features& features = cpu::features();
+        if ( features.sha && features.sse41 ) {
+            kernel = sha::Extensions;
+        } else if ( features.avx2 && features.bmi2 ) {
+            kernel = sha::Avx2;
+        }
+#endif
+        qCInfo( cpu::kernels ) << "SHA-1/SHA-256 kernel:" << sha::kernelName( kernel );
+        return kernel;
+    }
+
+    sha::Kernel selectLanesKernel() {
+        sha::Kernel kernel = sha::Portable;
+#ifdef MRHASH_AVX512
+        if ( cpu::features().avx512 ) {
+            kernel = sha::Avx512;
+        }
+#endif
+        qCInfo( cpu::kernels ) << "Two-lane SHA-2 kernel:" << sha::kernelName( kernel );
+        return kernel;
+    }
+}
+
+sha::Kernel sha::kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+sha::Kernel sha::lanesKernel() {
+    static const Kernel selected = selectLanesKernel();
+    return selected;
+}
+
+sha::Kernel sha::kernel256x2() {
+    if ( kernel() == Avx2 && lanesKernel() == Avx512 ) {
+        return Avx512;
+    }
+    return kernel();
+}
+
+const char* sha::kernelName( Kernel kernel ) {
+    switch ( kernel ) {
+        case Extensions:
+            return "SHA-NI";
+        case Avx512:
+            return "AVX-512";
+        case Avx2:
+            return "AVX2";
+        default:
+            return "portable";
+    }
+}
+
+void sha::compress1( uint32_t* state, const byte* blocks, std::size_t count ) {
+    switch ( kernel() ) {
+#ifdef MRHASH_X86_64
+        case Extensions:
+            return compress1Extensions( state, blocks, count );
+        case Avx2:
+            return compress1Avx2( state, blocks, count );
+#endif
+        default:
+            return compress1Portable( state, blocks, count );
+    }
+}
+
+void sha::compress256( uint32_t* state, const byte* blocks, std::size_t count ) {
+    switch ( kernel() ) {
+#ifdef MRHASH_X86_64
+        case Extensions:
+            return compress256Extensions( state, blocks, count );
+        case Avx2:
+            return compress256Avx2< 1 >( state, blocks, count );
+#endif
+        default:
+            return compress2Portable< uint32_t, 1 >( state, blocks, count );
+    }
+}
+
+void sha::compress512( uint64_t* state, const byte* blocks, std::size_t count ) {
+    compress2Portable< uint64_t, 1 >( state, blocks, count );
+}
+
+void sha::compress256x2( uint32_t* states, const byte* blocks, std::size_t count ) {
+    switch ( kernel256x2() ) {
+#ifdef MRHASH_X86_64
+        case Extensions:
+            return compress256x2Extensions( states, blocks, count );
+#ifdef MRHASH_AVX512
+        case Avx512:
+            return compress2Avx512< Avx512Lanes32 >( states, blocks, count );
+#endif
+        case Avx2:
+            return compress256Avx2< 2 >( states, blocks, count );
+#endif
+        default:
+            return compress2Portable< uint32_t, 2 >( states, blocks, count );
+    }
+}
+
+void sha::compress512x2( uint64_t* states, const byte* blocks, std::size_t count ) {
+#ifdef MRHASH_AVX512
+    if ( lanesKernel() == Avx512 ) {
+        return compress2Avx512< Avx512Lanes64 >( states, blocks, count );
+    }
+#endif
+    compress2Portable< uint64_t, 2 >( states, blocks, count );
+}
+
+template< typename Word, std::size_t StateWords, std::size_t Lanes >
+sha::Engine< Word, StateWords, Lanes >::Engine( Compress compress, const Word* firstIv, const Word* secondIv ) : mCompress( compress ) {
+    for ( std::size_t lane = 0; lane < Lanes; ++lane ) {
+        mIvs[ lane ] = lane == 0 ? firstIv : secondIv;
+    }
+    reset();
+}
+
+template< typename Word, std::size_t StateWords, std::size_t Lanes >
+void sha::Engine< Word, StateWords, Lanes >::reset() {
+    for ( std::size_t lane = 0; lane < Lanes; ++lane ) {
+        std::memcpy( mStates + lane * StateWords, mIvs[ lane ], StateWords * sizeof( Word ) );
+    }
+    mOccupied = 0;
+    mLength = 0;
+}
+
+template< typename Word, std::size_t StateWords, std::size_t Lanes >
+void sha::Engine< Word, StateWords, Lanes >::write( const byte* data, std::size_t length ) {
+    mLength += length;
+    if ( mOccupied > 0 ) {
+        std::size_t copied = qMin( length, BLOCK_SIZE - mOccupied );
+        std::memcpy( mBlock + mOccupied, data, copied );
+        mOccupied += copied;
+        data += copied;
+        length -= copied;
+        if ( mOccupied < BLOCK_SIZE ) {
+            return;
+        }
+        mCompress( mStates, mBlock, 1 );
+        mOccupied = 0;
+    }
+    std::size_t count = length / BLOCK_SIZE;
+    if ( count > 0 ) {
+        mCompress( mStates, data, count );
+        data += count * BLOCK_SIZE;
+        length -= count * BLOCK_SIZE;
+    }
+    std::memcpy( mBlock, data, length );
+    mOccupied = length;
+}
+
+template< typename Word, std::size_t StateWords, std::size_t Lanes >
+void sha::Engine< Word, StateWords, Lanes >::final( byte* digest, std::size_t digestWords, byte* secondDigest, std::size_t secondWords ) {
+    // the length field takes two words, but messages of 2^64 bits and more are not supported
+    const std::size_t lengthOffset = BLOCK_SIZE - 2 * sizeof( Word );
+    quint64 bitCount = mLength * 8;
+    mBlock[ mOccupied++ ] = 0x80;
+    if ( mOccupied > lengthOffset ) {
+        std::memset( mBlock + mOccupied, 0, BLOCK_SIZE - mOccupied );
+        mCompress( mStates, mBlock, 1 );
+        mOccupied = 0;
+    }
+    std::memset( mBlock + mOccupied, 0, BLOCK_SIZE - 8 - mOccupied );
+    qToBigEndian( bitCount, mBlock + BLOCK_SIZE - 8 );
+    mCompress( mStates, mBlock, 1 );
+    const Word* secondState = mStates + ( Lanes - 1 ) * StateWords;
+    for ( std::size_t i = 0; i < digestWords; ++i ) {
+        store( mStates[ i ], digest + sizeof( Word ) * i );
+    }
+    for ( std::size_t i = 0; i < secondWords; ++i ) {
+        store( secondState[ i ], secondDigest + sizeof( Word ) * i );
+    }
+    reset();
+}
+
+template class sha::Engine< uint32_t, 5 >;
+template class sha::Engine< uint32_t, 8 >;
+template class sha::Engine< uint64_t, 8 >;
+template class sha::Engine< uint32_t, 8, 2 >;
+template class sha::Engine< uint64_t, 8, 2 >;
+
+Sha1::Sha1() : BlockHash( sha::compress1, SHA1_IV ) {}
+
+Sha224::Sha224() : BlockHash( sha::compress256, SHA224_IV ) {}
+
+Sha256::Sha256() : BlockHash( sha::compress256, SHA256_IV ) {}
+
+Sha384::Sha384() : BlockHash( sha::compress512, SHA384_IV ) {}
+
+Sha512::Sha512() : BlockHash( sha::compress512, SHA512_IV ) {}
+
+Sha224And256::Sha224And256() : mEngine( sha::compress256x2, SHA224_IV, SHA256_IV ) {}
+
+Sha384And512::Sha384And512() : mEngine( sha::compress512x2, SHA384_IV, SHA512_IV ) {}
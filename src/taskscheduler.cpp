@@ -0,0 +1,191 @@
+#include "taskscheduler.hpp"
+
+#include <QElapsedTimer>
+#include <QThread>
+
+#include <climits>
+
+namespace {
+    // the scheduler of the worker running on this thread, if any, and its index
+    thread_local TaskScheduler* tScheduler = nullptr;
+    thread_local int tWorker = -1;
+}
+
+class TaskScheduler::Worker : public QThread {
+    public:
+        Worker( TaskScheduler& scheduler, int index ) : mScheduler( scheduler ), mIndex( index ) {}
+
+        void push( Task task ) {
+            QMutexLocker locker( &mMutex );
+            mTasks.push_back( std::move( task ) );
+        }
+
+        bool popNewest( Task& task ) { //by the worker itself
+            QMutexLocker locker( &mMutex );
+            if ( mTasks.empty() ) {
+                return false;
+            }
+            task = std::move( mTasks.back() );
+            mTasks.pop_back();
+            return true;
+        }
+
+        bool popOldest( Task& task ) { //by the other threads
+            QMutexLocker locker( &mMutex );
+            if ( mTasks.empty() ) {
+                return false;
+            }
+            task = std::move( mTasks.front() );
+            mTasks.pop_front();
+            return true;
+        }
+
+    protected:
+        void run() override { mScheduler.work( mIndex ); }
+
+    private:
+        TaskScheduler& mScheduler;
+        const int mIndex;
+        std::deque< Task > mTasks;
+        QMutex mMutex;
+};
+
+TaskScheduler::Group::Group( TaskScheduler& scheduler ) : mScheduler( scheduler ), mPending( 0 ) {}
+
+TaskScheduler::Group::~Group() {
+    wait();
+}
+
+void TaskScheduler::Group::run( Task task ) {
+    ++mPending;
+    mScheduler.submit( [this, task]() {
+        task();
+        QMutexLocker locker( &mMutex );
+        --mPending;
+        mTaskDone.wakeAll();
+    } );
+}
+
+void TaskScheduler::Group::wait() {
+    wait( 0, ULONG_MAX );
+}
+
+bool TaskScheduler::Group::wait( int pending, unsigned long time ) {
+    QElapsedTimer timer;
+    timer.start();
+    /* mPending is only tested under the lock: the task that decremented it has then released the lock, and
+     * the group can be destroyed as soon as this returns */
+    QMutexLocker locker( &mMutex );
+    while ( mPending > pending ) {
+        unsigned long elapsed = static_cast< unsigned long >( timer.elapsed() );
+        if ( time != ULONG_MAX && elapsed >= time ) {
+            return false;
+        }
+        locker.unlock();
+        bool ran = mScheduler.runOne(); //maybe one of this group, maybe not: either way, a core is not left idle
+        locker.relock();
+        if ( !ran && mPending > pending ) {
+            mTaskDone.wait( &mMutex, time == ULONG_MAX ? ULONG_MAX : time - elapsed );
+        }
+    }
+    return true;
+}
+
+int TaskScheduler::Group::pending() const {
+    return mPending;
+}
+
+TaskScheduler::TaskScheduler( int workerCount ) : mQueued( 0 ), mQuit( false ) {
+    for ( int i = 0; i < workerCount; ++i ) {
+        mWorkers.emplace_back( new Worker( *this, i ) );
+    }
+    for ( const std::unique_ptr< Worker >& worker : mWorkers ) {
+        worker->start();
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    mMutex.lock();
+    mQuit = true;
+    mTaskQueued.wakeAll();
+    mMutex.unlock();
+    for ( const std::unique_ptr< Worker >& worker : mWorkers ) {
+        worker->wait();
+    }
+}
+
+TaskScheduler& TaskScheduler::instance() {
+    // never destroyed: its workers sleep until the process exits
+    static TaskScheduler* scheduler = new TaskScheduler( qMax( QThread::idealThreadCount(), 1 ) );
+    return *scheduler;
+}
+
+int TaskScheduler::workerCount() const {
+    return static_cast< int >( mWorkers.size() );
+}
+
+void TaskScheduler::submit( Task task ) {
+    if ( tScheduler == this ) {
+        mWorkers[ tWorker ]->push( std::move( task ) ); //the newest of its worker, run (or stolen) first
+    }
+    QMutexLocker locker( &mMutex );
+    if ( tScheduler != this ) {
+        mInjected.push_back( std::move( task ) );
+    }
+    ++mQueued;
+    mTaskQueued.wakeOne();
+}
+
+bool TaskScheduler::runOne() {
+    Task task;
+    if ( !take( tScheduler == this ? tWorker : -1, task ) ) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+bool TaskScheduler::take( int worker, Task& task ) {
+    if ( mQueued == 0 ) {
+        return false;
+    }
+    if ( worker >= 0 && mWorkers[ worker ]->popNewest( task ) ) {
+        --mQueued;
+        return true;
+    }
+    mMutex.lock();
+    if ( !mInjected.empty() ) {
+        task = std::move( mInjected.front() );
+        mInjected.pop_front();
+        --mQueued;
+        mMutex.unlock();
+        return true;
+    }
+    mMutex.unlock();
+    const int count = workerCount();
+    for ( int i = 1; i <= count; ++i ) {
+        int victim = ( worker + i + count ) % count;
+        if ( victim != worker && mWorkers[ victim ]->popOldest( task ) ) {
+            --mQueued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::work( int worker ) {
+    tScheduler = this;
+    tWorker = worker;
+    Task task;
+    while ( !mQuit ) {
+        if ( take( worker, task ) ) {
+            task();
+            task = nullptr; //releases what it captured
+            continue;
+        }
+        QMutexLocker locker( &mMutex );
+        while ( mQueued == 0 && !mQuit ) {
+            mTaskQueued.wait( &mMutex );
+        }
+    }
+}
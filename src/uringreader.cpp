@@ -0,0 +1,193 @@
+#include "uringreader.hpp"
+
+#include <memory>
+
+#ifdef Q_OS_LINUX
+#include <sys/syscall.h>
+#endif
+
+#if defined( Q_OS_LINUX ) && defined( __NR_io_uring_setup )
+#define MRHASH_IO_URING
+
+#include <cerrno>
+#include <cstring>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+// The submission and completion queues shared with the kernel
+struct UringReader::Ring {
+#ifdef MRHASH_IO_URING
+    Ring() : fd( -1 ), sq( MAP_FAILED ), cq( MAP_FAILED ), sqes( MAP_FAILED ), sqSize( 0 ), cqSize( 0 ), sqesSize( 0 ) {}
+
+    ~Ring() {
+        if ( sqes != MAP_FAILED ) {
+            munmap( sqes, sqesSize );
+        }
+        if ( cq != MAP_FAILED ) {
+            munmap( cq, cqSize );
+        }
+        if ( sq != MAP_FAILED ) {
+            munmap( sq, sqSize );
+        }
+        if ( fd >= 0 ) {
+            close( fd ); //also unregisters the buffers
+        }
+    }
+
+    template< typename T >
+    static T* at( void* ring, unsigned offset ) { return reinterpret_cast< T* >( static_cast< char* >( ring ) + offset ); }
+
+    int fd;
+    void* sq;
+    void* cq;
+    void* sqes;
+    size_t sqSize;
+    size_t cqSize;
+    size_t sqesSize;
+    io_uring_params params;
+    std::vector< iovec > iovecs; //of the reads in buffers not registered
+#endif
+};
+
+UringReader::UringReader( int fd, int depth ) : mFd( fd ), mRegistered( false ), mInFlight( 0 ) {
+#ifdef MRHASH_IO_URING
+    if ( depth <= 0 ) {
+        return;
+    }
+    std::unique_ptr< Ring > ring( new Ring() );
+    std::memset( &ring->params, 0, sizeof( ring->params ) );
+    ring->fd = static_cast< int >( syscall( __NR_io_uring_setup, static_cast< unsigned >( depth ), &ring->params ) );
+    if ( ring->fd < 0 ) {
+        return;
+    }
+    const io_uring_params& params = ring->params;
+    ring->sqSize = params.sq_off.array + params.sq_entries * sizeof( unsigned );
+    ring->cqSize = params.cq_off.cqes + params.cq_entries * sizeof( io_uring_cqe );
+    ring->sqesSize = params.sq_entries * sizeof( io_uring_sqe );
+    ring->sq = mmap( nullptr, ring->sqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING );
+    ring->cq = mmap( nullptr, ring->cqSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING );
+    ring->sqes = mmap( nullptr, ring->sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQES );
+    if ( ring->sq != MAP_FAILED && ring->cq != MAP_FAILED && ring->sqes != MAP_FAILED ) {
+        mRing = std::move( ring );
+    }
+#else
+    Q_UNUSED( depth )
+#endif
+}
+
+UringReader::~UringReader() {
+    //the kernel may still write in the buffers until their reads complete
+    int buffer;
+    int result;
+    while ( mInFlight > 0 && wait( buffer, result ) ) {}
+}
+
+bool UringReader::isValid() const {
+    return mRing != nullptr;
+}
+
+void UringReader::registerBuffers( const std::vector< char* >& buffers, int length ) {
+    mBuffers = buffers;
+#ifdef MRHASH_IO_URING
+    if ( !isValid() ) {
+        return;
+    }
+    mRing->iovecs.resize( buffers.size() );
+    for ( size_t i = 0; i < buffers.size(); ++i ) {
+        mRing->iovecs[ i ].iov_base = buffers[ i ];
+        mRing->iovecs[ i ].iov_len = static_cast< size_t >( length );
+    }
+    //it fails where the locked memory is limited (before Linux 5.12): the reads then use the buffers as they are
+    mRegistered = syscall( __NR_io_uring_register, mRing->fd, IORING_REGISTER_BUFFERS, mRing->iovecs.data(),
+                           static_cast< unsigned >( buffers.size() ) ) == 0;
+#else
+    Q_UNUSED( length )
+#endif
+}
+
+bool UringReader::submit( int buffer, qint64 offset, int length ) {
+#ifdef MRHASH_IO_URING
+    if ( !isValid() ) {
+        return false;
+    }
+    const io_uring_params& params = mRing->params;
+    unsigned* head = Ring::at< unsigned >( mRing->sq, params.sq_off.head );
+    unsigned* tail = Ring::at< unsigned >( mRing->sq, params.sq_off.tail );
+    unsigned mask = *Ring::at< unsigned >( mRing->sq, params.sq_off.ring_mask );
+    unsigned index = *tail & mask;
+
+    io_uring_sqe* sqe = static_cast< io_uring_sqe* >( mRing->sqes ) + index;
+    std::memset( sqe, 0, sizeof( io_uring_sqe ) );
+    sqe->fd = mFd;
+    sqe->off = static_cast< __u64 >( offset );
+    sqe->user_data = static_cast< __u64 >( buffer );
+    if ( mRegistered ) {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->addr = reinterpret_cast< __u64 >( mBuffers[ buffer ] );
+        sqe->len = static_cast< __u32 >( length );
+        sqe->buf_index = static_cast< __u16 >( buffer );
+    } else {
+        mRing->iovecs[ buffer ].iov_len = static_cast< size_t >( length );
+        sqe->opcode = IORING_OP_READV;
+        sqe->addr = reinterpret_cast< __u64 >( &mRing->iovecs[ buffer ] );
+        sqe->len = 1;
+    }
+    Ring::at< unsigned >( mRing->sq, params.sq_off.array )[ index ] = index;
+    unsigned submitted = *tail;
+    __atomic_store_n( tail, submitted + 1, __ATOMIC_RELEASE );
+
+    long result;
+    do {
+        result = syscall( __NR_io_uring_enter, mRing->fd, 1, 0, 0, nullptr, 0 );
+    } while ( result < 0 && errno == EINTR );
+    if ( result != 1 ) {
+        if ( __atomic_load_n( head, __ATOMIC_ACQUIRE ) == submitted ) {
+            __atomic_store_n( tail, submitted, __ATOMIC_RELEASE ); //not taken by the kernel
+        }
+        return false;
+    }
+    ++mInFlight;
+    return true;
+#else
+    Q_UNUSED( buffer ) Q_UNUSED( offset ) Q_UNUSED( length )
+    return false;
+#endif
+}
+
+bool UringReader::wait( int& buffer, int& result ) {
+#ifdef MRHASH_IO_URING
+    if ( !isValid() || mInFlight == 0 ) {
+        return false;
+    }
+    const io_uring_params& params = mRing->params;
+    unsigned* head = Ring::at< unsigned >( mRing->cq, params.cq_off.head );
+    unsigned* tail = Ring::at< unsigned >( mRing->cq, params.cq_off.tail );
+    unsigned mask = *Ring::at< unsigned >( mRing->cq, params.cq_off.ring_mask );
+    for ( ;; ) {
+        unsigned completed = *head;
+        if ( completed != __atomic_load_n( tail, __ATOMIC_ACQUIRE ) ) {
+            const io_uring_cqe& cqe = Ring::at< io_uring_cqe >( mRing->cq, params.cq_off.cqes )[ completed & mask ];
+            buffer = static_cast< int >( cqe.user_data );
+            result = cqe.res;
+            __atomic_store_n( head, completed + 1, __ATOMIC_RELEASE );
+            --mInFlight;
+            return true;
+        }
+        if ( syscall( __NR_io_uring_enter, mRing->fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0 ) < 0 && errno != EINTR ) {
+            return false;
+        }
+    }
+#else
+    Q_UNUSED( buffer ) Q_UNUSED( result )
+    return false;
+#endif
+}
+
+bool UringReader::isSupported() {
+    static const bool supported = UringReader( -1, 1 ).isValid();
+    return supported;
+}
@@ -0,0 +1,500 @@
+#include "xxh3.hpp"
+
+#include <QtEndian>
+
+#include <cstring>
+
+#include "cpufeatures.hpp"
+
+#ifdef MRHASH_X86_64
+#include <immintrin.h>
+#endif
+
+#if defined( _MSC_VER ) && defined( MRHASH_X86_64 )
+#include <intrin.h>
+#endif
+
+namespace {
+    const uint64_t PRIME32_1 = 0x9E3779B1U;
+    const uint64_t PRIME32_2 = 0x85EBCA77U;
+    const uint64_t PRIME32_3 = 0xC2B2AE3DU;
+    const uint64_t PRIME64_1 = 0x9E3779B185EBCA87ULL;
+    const uint64_t PRIME64_2 = 0xC2B2AE3D27D4EB4FULL;
+    const uint64_t PRIME64_3 = 0x165667B19E3779F9ULL;
+    const uint64_t PRIME64_4 = 0x85EBCA77C2B2AE63ULL;
+    const uint64_t PRIME64_5 = 0x27D4EB2F165667C5ULL;
+    const uint64_t PRIME_MX1 = 0x165667919E3779F9ULL;
+    const uint64_t PRIME_MX2 = 0x9FB21C651E98DF25ULL;
+
+    // The default secret, from which all the keys are read at different (overlapping) offsets
+    const byte SECRET[ 192 ] = {
+        0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+        0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+        0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+        0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+        0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+        0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+        0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+        0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+        0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+        0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+        0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+        0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e
+    };
+
+    const std::size_t STRIPE_LENGTH = 64;
+    const std::size_t SECRET_CONSUME_RATE = 8; // the key of each stripe starts 8 bytes after the previous one
+    const std::size_t SECRET_LIMIT = sizeof( SECRET ) - STRIPE_LENGTH; // key of the scrambling
+    const std::size_t STRIPES_PER_BLOCK = SECRET_LIMIT / SECRET_CONSUME_RATE;
+    const std::size_t SECRET_SIZE_MIN = 136;
+    const std::size_t MIDSIZE_MAX = 240;
+    const std::size_t MIDSIZE_START_OFFSET = 3;
+    const std::size_t MIDSIZE_LAST_OFFSET = 17;
+    const std::size_t LAST_ACC_START = 7;
+    const std::size_t MERGE_ACCS_START = 11;
+
+    struct Hash128 {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    inline uint32_t read32( const byte* data ) {
+        quint32 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    inline uint64_t read64( const byte* data ) {
+        quint64 value;
+        std::memcpy( &value, data, sizeof( value ) );
+        return qFromLittleEndian( value );
+    }
+
+    inline uint64_t rotl64( uint64_t x, int n ) { return ( x << n ) | ( x >> ( 64 - n ) ); }
+    inline uint32_t rotl32( uint32_t x, int n ) { return ( x << n ) | ( x >> ( 32 - n ) ); }
+    inline uint64_t xorshift64( uint64_t x, int shift ) { return x ^ ( x >> shift ); }
+
+    inline uint32_t swap32( uint32_t x ) {
+        return ( x >> 24 ) | ( ( x >> 8 ) & 0xff00 ) | ( ( x << 8 ) & 0xff0000 ) | ( x << 24 );
+    }
+
+    inline uint64_t swap64( uint64_t x ) {
+        return ( static_cast< uint64_t >( swap32( static_cast< uint32_t >( x ) ) ) << 32 ) | swap32( static_cast< uint32_t >( x >> 32 ) );
+    }
+
+    inline Hash128 multiply64to128( uint64_t lhs, uint64_t rhs ) {
+        Hash128 product;
+#if defined( __SIZEOF_INT128__ )
+        unsigned __int128 full = static_cast< unsigned __int128 >( lhs ) * rhs;
+        product.low = static_cast< uint64_t >( full );
+        product.high = static_cast< uint64_t >( full >> 64 );
+#elif defined( _MSC_VER ) && defined( MRHASH_X86_64 )
+        unsigned long long high;
+        product.low = _umul128( lhs, rhs, &high );
+        product.high = high;
+#else
+        // schoolbook multiplication on the 32 bit halves
+        uint64_t loLo = ( lhs & 0xFFFFFFFF ) * ( rhs & 0xFFFFFFFF );
+        uint64_t hiLo = ( lhs >> 32 ) * ( rhs & 0xFFFFFFFF );
+        uint64_t loHi = ( lhs & 0xFFFFFFFF ) * ( rhs >> 32 );
+        uint64_t hiHi = ( lhs >> 32 ) * ( rhs >> 32 );
+        uint64_t cross = ( loLo >> 32 ) + ( hiLo & 0xFFFFFFFF ) + loHi;
+        product.high = ( hiLo >> 32 ) + ( cross >> 32 ) + hiHi;
+        product.low = ( cross << 32 ) | ( loLo & 0xFFFFFFFF );
+#endif
+        return product;
+    }
+
+    inline uint64_t multiplyFold64( uint64_t lhs, uint64_t rhs ) {
+        Hash128 product = multiply64to128( lhs, rhs );
+        return product.low ^ product.high;
+    }
+
+    inline uint64_t xxh64Avalanche( uint64_t hash ) {
+        hash ^= hash >> 33;
+        hash *= PRIME64_2;
+        hash ^= hash >> 29;
+        hash *= PRIME64_3;
+        hash ^= hash >> 32;
+        return hash;
+    }
+
+    inline uint64_t avalanche( uint64_t hash ) {
+        hash = xorshift64( hash, 37 );
+        hash *= PRIME_MX1;
+        return xorshift64( hash, 32 );
+    }
+
+    inline uint64_t rrmxmx( uint64_t hash, uint64_t length ) {
+        hash ^= rotl64( hash, 49 ) ^ rotl64( hash, 24 );
+        hash *= PRIME_MX2;
+        hash ^= ( hash >> 35 ) + length;
+        hash *= PRIME_MX2;
+        return xorshift64( hash, 28 );
+    }
+
+    inline uint64_t mix16( const byte* input, const byte* secret ) {
+        return multiplyFold64( read64( input ) ^ read64( secret ), read64( input + 8 ) ^ read64( secret + 8 ) );
+    }
+
+    inline Hash128 mix32( Hash128 acc, const byte* first, const byte* second, const byte* secret, uint64_t seed = 0 ) {
+        acc.low += multiplyFold64( read64( first ) ^ ( read64( secret ) + seed ), read64( first + 8 ) ^ ( read64( secret + 8 ) - seed ) );
+        acc.low ^= read64( second ) + read64( second + 8 );
+        acc.high += multiplyFold64( read64( second ) ^ ( read64( secret + 16 ) + seed ), read64( second + 8 ) ^ ( read64( secret + 24 ) - seed ) );
+        acc.high ^= read64( first ) + read64( first + 8 );
+        return acc;
+    }
+
+    /* Inputs of up to 240 bytes (the default seed is zero, so it does not appear in the keys) */
+    uint64_t hashShort64( const byte* input, std::size_t length ) {
+        if ( length > 128 ) {
+            uint64_t acc = length * PRIME64_1;
+            for ( std::size_t i = 0; i < 8; ++i ) {
+                acc += mix16( input + 16 * i, SECRET + 16 * i );
+            }
+            acc = avalanche( acc );
+            uint64_t accEnd = mix16( input + length - 16, SECRET + SECRET_SIZE_MIN - MIDSIZE_LAST_OFFSET );
+            for ( std::size_t i = 8; i < length / 16; ++i ) {
+                accEnd += mix16( input + 16 * i, SECRET + 16 * ( i - 8 ) + MIDSIZE_START_OFFSET );
+            }
+            return avalanche( acc + accEnd );
+        }
+        if ( length > 16 ) {
+            uint64_t acc = length * PRIME64_1;
+            for ( std::size_t i = ( length - 1 ) / 32 + 1; i-- > 0; ) {
+                acc += mix16( input + 16 * i, SECRET + 32 * i );
+                acc += mix16( input + length - 16 * ( i + 1 ), SECRET + 32 * i + 16 );
+            }
+            return avalanche( acc );
+        }
+        if ( length > 8 ) {
+            uint64_t low = read64( input ) ^ ( read64( SECRET + 24 ) ^ read64( SECRET + 32 ) );
+            uint64_t high = read64( input + length - 8 ) ^ ( read64( SECRET + 40 ) ^ read64( SECRET + 48 ) );
+            return avalanche( length + swap64( low ) + high + multiplyFold64( low, high ) );
+        }
+        if ( length >= 4 ) {
+            uint64_t value = read32( input + length - 4 ) + ( static_cast< uint64_t >( read32( input ) ) << 32 );
+            return rrmxmx( value ^ ( read64( SECRET + 8 ) ^ read64( SECRET + 16 ) ), length );
+        }
+        if ( length > 0 ) {
+            uint32_t combined = ( static_cast< uint32_t >( input[ 0 ] ) << 16 ) | ( static_cast< uint32_t >( input[ length >> 1 ] ) << 24 )
+                                | input[ length - 1 ] | ( static_cast< uint32_t >( length ) << 8 );
+            return xxh64Avalanche( combined ^ static_cast< uint64_t >( read32( SECRET ) ^ read32( SECRET + 4 ) ) );
+        }
+        return xxh64Avalanche( read64( SECRET + 56 ) ^ read64( SECRET + 64 ) );
+    }
+
+    inline Hash128 finish128( Hash128 acc, std::size_t length ) {
+        Hash128 hash;
+        hash.low = avalanche( acc.low + acc.high );
+        hash.high = 0 - avalanche( acc.low * PRIME64_1 + acc.high * PRIME64_4 + length * PRIME64_2 );
+        return hash;
+    }
+
+    Hash128 hashShort128( const byte* input, std::size_t length ) {
+        if ( length > 128 ) {
+            Hash128 acc = { length * PRIME64_1, 0 };
+            for ( std::size_t i = 32; i < 160; i += 32 ) {
+                acc = mix32( acc, input + i - 32, input + i - 16, SECRET + i - 32 );
+            }
+            acc.low = avalanche( acc.low );
+            acc.high = avalanche( acc.high );
+            for ( std::size_t i = 160; i <= length; i += 32 ) {
+                acc = mix32( acc, input + i - 32, input + i - 16, SECRET + MIDSIZE_START_OFFSET + i - 160 );
+            }
+            acc = mix32( acc, input + length - 16, input + length - 32, SECRET + SECRET_SIZE_MIN - MIDSIZE_LAST_OFFSET - 16 );
+            return finish128( acc, length );
+        }
+        if ( length > 16 ) {
+            Hash128 acc = { length * PRIME64_1, 0 };
+            for ( std::size_t i = ( length - 1 ) / 32 + 1; i-- > 0; ) {
+                acc = mix32( acc, input + 16 * i, input + length - 16 * ( i + 1 ), SECRET + 32 * i );
+            }
+            return finish128( acc, length );
+        }
+        if ( length > 8 ) {
+            uint64_t low = read64( input );
+            uint64_t high = read64( input + length - 8 );
+            Hash128 m = multiply64to128( low ^ high ^ ( read64( SECRET + 32 ) ^ read64( SECRET + 40 ) ), PRIME64_1 );
+            m.low += static_cast< uint64_t >( length - 1 ) << 54;
+            high ^= read64( SECRET + 48 ) ^ read64( SECRET + 56 );
+            m.high += high + ( high & 0xFFFFFFFF ) * ( PRIME32_2 - 1 );
+            m.low ^= swap64( m.high );
+            Hash128 hash = multiply64to128( m.low, PRIME64_2 );
+            hash.high += m.high * PRIME64_2;
+            hash.low = avalanche( hash.low );
+            hash.high = avalanche( hash.high );
+            return hash;
+        }
+        if ( length >= 4 ) {
+            uint64_t value = read32( input ) + ( static_cast< uint64_t >( read32( input + length - 4 ) ) << 32 );
+            Hash128 m = multiply64to128( value ^ ( read64( SECRET + 16 ) ^ read64( SECRET + 24 ) ), PRIME64_1 + ( length << 2 ) );
+            m.high += m.low << 1;
+            m.low ^= m.high >> 3;
+            m.low = xorshift64( m.low, 35 );
+            m.low *= PRIME_MX2;
+            m.low = xorshift64( m.low, 28 );
+            m.high = avalanche( m.high );
+            return m;
+        }
+        if ( length > 0 ) {
+            uint32_t low = ( static_cast< uint32_t >( input[ 0 ] ) << 16 ) | ( static_cast< uint32_t >( input[ length >> 1 ] ) << 24 )
+                           | input[ length - 1 ] | ( static_cast< uint32_t >( length ) << 8 );
+            uint32_t high = rotl32( swap32( low ), 13 );
+            Hash128 hash;
+            hash.low = xxh64Avalanche( low ^ static_cast< uint64_t >( read32( SECRET ) ^ read32( SECRET + 4 ) ) );
+            hash.high = xxh64Avalanche( high ^ static_cast< uint64_t >( read32( SECRET + 8 ) ^ read32( SECRET + 12 ) ) );
+            return hash;
+        }
+        Hash128 hash;
+        hash.low = xxh64Avalanche( read64( SECRET + 64 ) ^ read64( SECRET + 72 ) );
+        hash.high = xxh64Avalanche( read64( SECRET + 80 ) ^ read64( SECRET + 88 ) );
+        return hash;
+    }
+
+    /* The stripe kernels: count stripes, each with its key starting SECRET_CONSUME_RATE bytes after the previous;
+     * every 64 bit accumulator adds the product of the two halves of its keyed word and the word of its neighbour.
+     * The scrambling, at the end of each block, multiplies the accumulators by a 32 bit prime. */
+    void accumulatePortable( uint64_t acc[ 8 ], const byte* input, const byte* secret, std::size_t count ) {
+        for ( std::size_t stripe = 0; stripe < count; ++stripe ) {
+            const byte* data = input + stripe * STRIPE_LENGTH;
+            const byte* key = secret + stripe * SECRET_CONSUME_RATE;
+            for ( std::size_t lane = 0; lane < 8; ++lane ) {
+                uint64_t value = read64( data + 8 * lane );
+                uint64_t keyed = value ^ read64( key + 8 * lane );
+                acc[ lane ^ 1 ] += value;
+                acc[ lane ] += ( keyed & 0xFFFFFFFF ) * ( keyed >> 32 );
+            }
+        }
+    }
+
+    void scramblePortable( uint64_t acc[ 8 ], const byte* secret ) {
+        for ( std::size_t lane = 0; lane < 8; ++lane ) {
+            acc[ lane ] = ( xorshift64( acc[ lane ], 47 ) ^ read64( secret + 8 * lane ) ) * PRIME32_1;
+        }
+    }
+
+#ifdef MRHASH_X86_64
+    MRHASH_TARGET( "sse2" )
+    void accumulateSse2( uint64_t acc[ 8 ], const byte* input, const byte* secret, std::size_t count ) {
+        __m128i a[ 4 ];
+        for ( int i = 0; i < 4; ++i ) {
+            a[ i ] = _mm_loadu_si128( reinterpret_cast< const __m128i* >( acc ) + i );
+        }
+        for ( std::size_t stripe = 0; stripe < count; ++stripe ) {
+            const __m128i* data = reinterpret_cast< const __m128i* >( input + stripe * STRIPE_LENGTH );
+            const __m128i* key = reinterpret_cast< const __m128i* >( secret + stripe * SECRET_CONSUME_RATE );
+            for ( int i = 0; i < 4; ++i ) {
+                __m128i value = _mm_loadu_si128( data + i );
+                __m128i keyed = _mm_xor_si128( value, _mm_loadu_si128( key + i ) );
+                __m128i product = _mm_mul_epu32( keyed, _mm_shuffle_epi32( keyed, _MM_SHUFFLE( 0, 3, 0, 1 ) ) );
+                __m128i swapped = _mm_shuffle_epi32( value, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+                a[ i ] = _mm_add_epi64( a[ i ], _mm_add_epi64( product, swapped ) );
+            }
+        }
+        for ( int i = 0; i < 4; ++i ) {
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( acc ) + i, a[ i ] );
+        }
+    }
+
+    MRHASH_TARGET( "sse2" )
+    void scrambleSse2( uint64_t acc[ 8 ], const byte* secret ) {
+        const __m128i prime = _mm_set1_epi32( static_cast< int >( PRIME32_1 ) );
+        for ( int i = 0; i < 4; ++i ) {
+            __m128i a = _mm_loadu_si128( reinterpret_cast< const __m128i* >( acc ) + i );
+            a = _mm_xor_si128( a, _mm_srli_epi64( a, 47 ) );
+            a = _mm_xor_si128( a, _mm_loadu_si128( reinterpret_cast< const __m128i* >( secret ) + i ) );
+            __m128i low = _mm_mul_epu32( a, prime );
+            __m128i high = _mm_mul_epu32( _mm_shuffle_epi32( a, _MM_SHUFFLE( 0, 3, 0, 1 ) ), prime );
+            _mm_storeu_si128( reinterpret_cast< __m128i* >( acc ) + i, _mm_add_epi64( low, _mm_slli_epi64( high, 32 ) ) );
+        }
+    }
+
+    MRHASH_TARGET( "avx2" )
+    void accumulateAvx2( uint64_t acc[ 8 ], const byte* input, const byte* secret, std::size_t count ) {
+        __m256i a[ 2 ];
+        for ( int i = 0; i < 2; ++i ) {
+            a[ i ] = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( acc ) + i );
+        }
+        for ( std::size_t stripe = 0; stripe < count; ++stripe ) {
+            const __m256i* data = reinterpret_cast< const __m256i* >( input + stripe * STRIPE_LENGTH );
+            const __m256i* key = reinterpret_cast< const __m256i* >( secret + stripe * SECRET_CONSUME_RATE );
+            for ( int i = 0; i < 2; ++i ) {
+                __m256i value = _mm256_loadu_si256( data + i );
+                __m256i keyed = _mm256_xor_si256( value, _mm256_loadu_si256( key + i ) );
+                __m256i product = _mm256_mul_epu32( keyed, _mm256_srli_epi64( keyed, 32 ) );
+                __m256i swapped = _mm256_shuffle_epi32( value, _MM_SHUFFLE( 1, 0, 3, 2 ) );
+                a[ i ] = _mm256_add_epi64( a[ i ], _mm256_add_epi64( product, swapped ) );
+            }
+        }
+        for ( int i = 0; i < 2; ++i ) {
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( acc ) + i, a[ i ] );
+        }
+    }
+
+    MRHASH_TARGET( "avx2" )
+    void scrambleAvx2( uint64_t acc[ 8 ], const byte* secret ) {
+        const __m256i prime = _mm256_set1_epi32( static_cast< int >( PRIME32_1 ) );
+        for ( int i = 0; i < 2; ++i ) {
+            __m256i a = _mm256_loadu_si256( reinterpret_cast< const __m256i* >( acc ) + i );
+            a = _mm256_xor_si256( a, _mm256_srli_epi64( a, 47 ) );
+            a = _mm256_xor_si256( a, _mm256_loadu_si256( reinterpret_cast< const __m256i* >( secret ) + i ) );
+            __m256i low = _mm256_mul_epu32( a, prime );
+            __m256i high = _mm256_mul_epu32( _mm256_srli_epi64( a, 32 ), prime );
+            _mm256_storeu_si256( reinterpret_cast< __m256i* >( acc ) + i, _mm256_add_epi64( low, _mm256_slli_epi64( high, 32 ) ) );
+        }
+    }
+#endif
+
+    xxh3::Kernel selectKernel() {
+        xxh3::Kernel kernel = xxh3::Portable;
+#ifdef MRHASH_X86_64
+        kernel = cpu::features().avx2 ? xxh3::Avx2 : xxh3::Sse2; // SSE2 is part of x86-64
+#endif
+        qCInfo( cpu::kernels ) << "XXH3 kernel:" << xxh3::kernelName( kernel );
+        return kernel;
+    }
+
+    void accumulate( uint64_t acc[ 8 ], const byte* input, const byte* secret, std::size_t count ) {
+        switch ( xxh3::kernel() ) {
+#ifdef MRHASH_X86_64
+            case xxh3::Avx2:
+                return accumulateAvx2( acc, input, secret, count );
+            case xxh3::Sse2:
+                return accumulateSse2( acc, input, secret, count );
+#endif
+            default:
+                return accumulatePortable( acc, input, secret, count );
+        }
+    }
+
+    void scramble( uint64_t acc[ 8 ], const byte* secret ) {
+        switch ( xxh3::kernel() ) {
+#ifdef MRHASH_X86_64
+            case xxh3::Avx2:
+                return scrambleAvx2( acc, secret );
+            case xxh3::Sse2:
+                return scrambleSse2( acc, secret );
+#endif
+            default:
+                return scramblePortable( acc, secret );
+        }
+    }
+
+    uint64_t mergeAccs( const uint64_t acc[ 8 ], const byte* secret, uint64_t start ) {
+        uint64_t result = start;
+        for ( std::size_t i = 0; i < 4; ++i ) {
+            result += multiplyFold64( acc[ 2 * i ] ^ read64( secret + 16 * i ), acc[ 2 * i + 1 ] ^ read64( secret + 16 * i + 8 ) );
+        }
+        return avalanche( result );
+    }
+}
+
+xxh3::Kernel xxh3::kernel() {
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+const char* xxh3::kernelName( Kernel kernel ) {
+    switch ( kernel ) {
+        case Avx2:
+            return "AVX2";
+        case Sse2:
+            return "SSE2";
+        default:
+            return "portable";
+    }
+}
+
+void xxh3::State::reset() {
+    const uint64_t initialAcc[ 8 ] = { PRIME32_3, PRIME64_1, PRIME64_2, PRIME64_3, PRIME64_4, PRIME32_2, PRIME64_5, PRIME32_1 };
+    std::memcpy( mAcc, initialAcc, sizeof( mAcc ) );
+    mBufferedSize = 0;
+    mStripesSoFar = 0;
+    mTotalLength = 0;
+}
+
+void xxh3::State::consumeStripes( const byte* input, std::size_t count, uint64_t* acc, std::size_t& stripesSoFar ) const {
+    // the keys of the stripes advance through the secret until the end of a block, which scrambles the accumulators
+    while ( count >= STRIPES_PER_BLOCK - stripesSoFar ) {
+        std::size_t stripes = STRIPES_PER_BLOCK - stripesSoFar;
+        accumulate( acc, input, SECRET + stripesSoFar * SECRET_CONSUME_RATE, stripes );
+        scramble( acc, SECRET + SECRET_LIMIT );
+        input += stripes * STRIPE_LENGTH;
+        count -= stripes;
+        stripesSoFar = 0;
+    }
+    if ( count > 0 ) {
+        accumulate( acc, input, SECRET + stripesSoFar * SECRET_CONSUME_RATE, count );
+        stripesSoFar += count;
+    }
+}
+
+void xxh3::State::update( const byte* data, std::size_t length ) {
+    mTotalLength += length;
+    if ( length <= BUFFER_SIZE - mBufferedSize ) {
+        std::memcpy( mBuffer + mBufferedSize, data, length );
+        mBufferedSize += length;
+        return;
+    }
+
+    /* the buffer is consumed only when more input follows, since the last stripe is always accumulated
+     * in the finalization (with its own key), even when the input ends at a stripe boundary */
+    const byte* end = data + length;
+    if ( mBufferedSize > 0 ) {
+        std::size_t loaded = BUFFER_SIZE - mBufferedSize;
+        std::memcpy( mBuffer + mBufferedSize, data, loaded );
+        data += loaded;
+        consumeStripes( mBuffer, BUFFER_SIZE / STRIPE_LENGTH, mAcc, mStripesSoFar );
+        mBufferedSize = 0;
+    }
+    if ( static_cast< std::size_t >( end - data ) > BUFFER_SIZE ) {
+        std::size_t stripes = static_cast< std::size_t >( end - 1 - data ) / STRIPE_LENGTH;
+        consumeStripes( data, stripes, mAcc, mStripesSoFar );
+        data += stripes * STRIPE_LENGTH;
+        // the last stripe consumed is kept at the end of the buffer, where the finalization may need it
+        std::memcpy( mBuffer + BUFFER_SIZE - STRIPE_LENGTH, data - STRIPE_LENGTH, STRIPE_LENGTH );
+    }
+    mBufferedSize = static_cast< std::size_t >( end - data );
+    std::memcpy( mBuffer, data, mBufferedSize );
+}
+
+void xxh3::State::digestLong( uint64_t acc[ 8 ] ) const {
+    std::memcpy( acc, mAcc, sizeof( mAcc ) );
+    byte lastStripe[ STRIPE_LENGTH ];
+    const byte* last;
+    if ( mBufferedSize >= STRIPE_LENGTH ) {
+        std::size_t stripesSoFar = mStripesSoFar;
+        consumeStripes( mBuffer, ( mBufferedSize - 1 ) / STRIPE_LENGTH, acc, stripesSoFar );
+        last = mBuffer + mBufferedSize - STRIPE_LENGTH;
+    } else {
+        // the last stripe overlaps the previous input, saved at the end of the buffer
+        std::size_t catchup = STRIPE_LENGTH - mBufferedSize;
+        std::memcpy( lastStripe, mBuffer + BUFFER_SIZE - catchup, catchup );
+        std::memcpy( lastStripe + catchup, mBuffer, mBufferedSize );
+        last = lastStripe;
+    }
+    accumulate( acc, last, SECRET + SECRET_LIMIT - LAST_ACC_START, 1 );
+}
+
+uint64_t xxh3::State::digest64() const {
+    if ( mTotalLength <= MIDSIZE_MAX ) {
+        return hashShort64( mBuffer, static_cast< std::size_t >( mTotalLength ) );
+    }
+    uint64_t acc[ 8 ];
+    digestLong( acc );
+    return mergeAccs( acc, SECRET + MERGE_ACCS_START, mTotalLength * PRIME64_1 );
+}
+
+void xxh3::State::digest128( uint64_t& low, uint64_t& high ) const {
+    if ( mTotalLength <= MIDSIZE_MAX ) {
+        Hash128 hash = hashShort128( mBuffer, static_cast< std::size_t >( mTotalLength ) );
+        low = hash.low;
+        high = hash.high;
+        return;
+    }
+    uint64_t acc[ 8 ];
+    digestLong( acc );
+    low = mergeAccs( acc, SECRET + MERGE_ACCS_START, mTotalLength * PRIME64_1 );
+    high = mergeAccs( acc, SECRET + sizeof( SECRET ) - sizeof( acc ) - MERGE_ACCS_START, ~( mTotalLength * PRIME64_2 ) );
+}